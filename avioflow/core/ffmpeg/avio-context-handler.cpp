@@ -7,20 +7,57 @@
 namespace avioflow
 {
 
-  AVFormatContext *AvioContextHandler::open_url(const std::string &url)
+  AVFormatContext *AvioContextHandler::open_url(const std::string &url,
+                                                const AudioStreamOptions &options)
   {
     AVFormatContext *fmt_ctx = nullptr;
-    check_av_error(avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr),
-                   "Could not open input " + url);
+    AVDictionary *format_opts = nullptr;
+    set_probe_options(&format_opts, options);
+    int err = avformat_open_input(&fmt_ctx, url.c_str(), find_input_format(options), &format_opts);
+    av_dict_free(&format_opts);
+    check_av_error(err, "Could not open input " + url);
     return fmt_ctx;
   }
 
+  const AVInputFormat *AvioContextHandler::find_input_format(const AudioStreamOptions &options)
+  {
+    if (options.input_format.has_value())
+      return av_find_input_format(options.input_format->c_str());
+
+    if (options.stream_description.has_value())
+    {
+      const std::string &container = options.stream_description->container;
+      const AVInputFormat *iformat = av_find_input_format(container.c_str());
+      if (!iformat)
+        throw std::runtime_error("Unknown container in stream description: " + container);
+      return iformat;
+    }
+    return nullptr;
+  }
+
+  void AvioContextHandler::set_probe_options(AVDictionary **format_opts,
+                                             const AudioStreamOptions &options)
+  {
+    if (options.probe_size.has_value())
+    {
+      // Limits both format detection and stream analysis
+      av_dict_set_int(format_opts, "formatprobesize", options.probe_size.value(), 0);
+      av_dict_set_int(format_opts, "probesize", options.probe_size.value(), 0);
+    }
+    if (options.analyze_duration.has_value())
+    {
+      av_dict_set_int(format_opts, "analyzeduration", options.analyze_duration.value(), 0);
+    }
+  }
+
   AVFormatContext *AvioContextHandler::create_avio_context(
-      void *opaque,
+      AvioOpaque *opaque,
       AVIOReadFunction read_packet,
       AVIOSeekFunction seek,
       const AudioStreamOptions &options)
   {
+    std::unique_ptr<AvioOpaque> opaque_owner(opaque);
+
     AVFormatContext *fmt_ctx = avformat_alloc_context();
     if (!fmt_ctx)
       throw std::runtime_error("Could not allocate AVFormatContext");
@@ -34,7 +71,7 @@ namespace avioflow
     }
 
     AVIOContext *avio_ctx = avio_alloc_context(
-        avio_ctx_buffer, AVIO_BUFFER_SIZE, 0, opaque,
+        avio_ctx_buffer, AVIO_BUFFER_SIZE, 0, static_cast<void *>(opaque),
         read_packet, nullptr, seek);
 
     if (!avio_ctx)
@@ -50,11 +87,7 @@ namespace avioflow
     fmt_ctx->pb = avio_ctx;
     
     // Allow explicitly specifying input format if auto-detection fails
-    const AVInputFormat *iformat = nullptr;
-    if (options.input_format.has_value())
-    {
-      iformat = av_find_input_format(options.input_format->c_str());
-    }
+    const AVInputFormat *iformat = find_input_format(options);
 
     // Set format-specific options if provided (crucial for raw PCM)
     AVDictionary *format_opts = nullptr;
@@ -66,6 +99,7 @@ namespace avioflow
     {
       av_dict_set_int(&format_opts, "channels", options.input_channels.value(), 0);
     }
+    set_probe_options(&format_opts, options);
 
     // Attempt to open input using the custom I/O.
     // Passing format_opts allows FFmpeg to know parameters for raw streams.
@@ -87,26 +121,20 @@ namespace avioflow
       throw std::runtime_error("Could not open custom I/O input: " + std::string(err_buf));
     }
     
+    // Released by AVFormatContextDeleter together with fmt_ctx
+    opaque_owner.release();
     return fmt_ctx;
   }
 
   AVFormatContext *AvioContextHandler::open_memory(const uint8_t *data,
                                                    size_t size,
-                                                   const AudioStreamOptions &options)
+                                                   const AudioStreamOptions &options,
+                                                   std::shared_ptr<const void> owner)
   {
-    MemoryContext *m_ctx = new MemoryContext{data, size, 0};
-    try
-    {
-      return create_avio_context(static_cast<void*>(m_ctx), 
-                            AVIOReadFunction(read_packet_memory),
-                            AVIOSeekFunction(seek_memory), 
-                            options);
-    }
-    catch (...)
-    {
-      delete m_ctx;
-      throw;
-    }
+    return create_avio_context(new MemoryContext(data, size, std::move(owner)),
+                               AVIOReadFunction(read_packet_memory),
+                               AVIOSeekFunction(seek_memory),
+                               options);
   }
 
   int AvioContextHandler::read_packet_memory(void *opaque, uint8_t *buf, int buf_size)
@@ -130,22 +158,30 @@ namespace avioflow
   int64_t AvioContextHandler::seek_memory(void *opaque, int64_t offset, int whence)
   {
     MemoryContext *m_ctx = static_cast<MemoryContext *>(opaque);
-    int64_t ret = -1;
+    int64_t size = static_cast<int64_t>(m_ctx->size);
+    int64_t target = -1;
 
-    switch (whence)
+    switch (whence & ~AVSEEK_FORCE)
     {
     case AVSEEK_SIZE:
-      ret = static_cast<int64_t>(m_ctx->size);
-      break;
+      return size;
     case SEEK_SET:
-      m_ctx->pos = static_cast<size_t>(offset);
-      ret = offset;
+      target = offset;
+      break;
+    case SEEK_CUR:
+      target = static_cast<int64_t>(m_ctx->pos) + offset;
+      break;
+    case SEEK_END:
+      target = size + offset;
       break;
     default:
-      break;  // Return -1 for unsupported operations
+      return -1; // Unsupported operation
     }
 
-    return ret;
+    if (target < 0 || target > size)
+      return -1;
+    m_ctx->pos = static_cast<size_t>(target);
+    return target;
   }
 
   int AvioContextHandler::read_packet_stream(void *opaque, uint8_t *buf, int buf_size)
@@ -167,23 +203,31 @@ namespace avioflow
     return AVERROR_EOF;
   }
 
+  int64_t AvioContextHandler::seek_stream(void *opaque, int64_t offset, int whence)
+  {
+    StreamContext *s_ctx = static_cast<StreamContext *>(opaque);
+    whence &= ~AVSEEK_FORCE;
+    // Size queries are not part of the callback contract; report unknown size
+    if (!s_ctx->avio_seek_callback || whence == AVSEEK_SIZE)
+      return -1;
+    int64_t result = s_ctx->avio_seek_callback(offset, whence);
+    return result < 0 ? -1 : result;
+  }
+
   AVFormatContext *AvioContextHandler::open_stream(AVIOReadCallback avio_read_callback,
-                                                   const AudioStreamOptions &options)
+                                                   const AudioStreamOptions &options,
+                                                   AVIOSeekCallback avio_seek_callback)
   {
-    StreamContext *s_ctx = new StreamContext{std::move(avio_read_callback)};
-    try
-    {
-      // Streaming input typically doesn't support seeking
-      return create_avio_context(static_cast<void*>(s_ctx), 
-                            AVIOReadFunction(read_packet_stream),
-                            nullptr, 
-                            options);
-    }
-    catch (...)
-    {
-      delete s_ctx;
-      throw;
-    }
+    auto *s_ctx = new StreamContext();
+    s_ctx->avio_read_callback = std::move(avio_read_callback);
+    s_ctx->avio_seek_callback = std::move(avio_seek_callback);
+
+    // Streaming input is only seekable when the caller provides a seek callback
+    AVIOSeekFunction seek = s_ctx->avio_seek_callback ? AVIOSeekFunction(seek_stream) : nullptr;
+    return create_avio_context(s_ctx,
+                               AVIOReadFunction(read_packet_stream),
+                               seek,
+                               options);
   }
 
 } // namespace avioflow
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -17,39 +18,56 @@ namespace avioflow
     // Buffer size for AVIO context (64KB for efficient I/O)
     static constexpr int AVIO_BUFFER_SIZE = 64 * 1024;
 
-    static AVFormatContext *open_url(const std::string &url);
+    static AVFormatContext *open_url(const std::string &url,
+                                     const AudioStreamOptions &options = {});
 
     // Open using custom I/O callback and opaque pointer
+    // Takes ownership of `opaque`; it is released together with the returned context
     static AVFormatContext *create_avio_context(
-        void *opaque,
+        AvioOpaque *opaque,
         AVIOReadFunction read_packet,
         AVIOSeekFunction seek,
         const AudioStreamOptions &options);
 
     // Helper for simple memory buffers (wraps create_avio_context)
+    // `owner` (if any) keeps `data` alive; it is released with the context
     static AVFormatContext *open_memory(const uint8_t *data, size_t size,
-                                        const AudioStreamOptions &options = {});
+                                        const AudioStreamOptions &options = {},
+                                        std::shared_ptr<const void> owner = nullptr);
 
     // Helper for callback-based streaming (wraps create_avio_context)
+    // The stream is seekable only if avio_seek_callback is provided
     static AVFormatContext *open_stream(AVIOReadCallback avio_read_callback,
-                                        const AudioStreamOptions &options);
+                                        const AudioStreamOptions &options,
+                                        AVIOSeekCallback avio_seek_callback = nullptr);
 
   private:
-    struct MemoryContext
+    // Demuxer from options.input_format, else from options.stream_description
+    static const AVInputFormat *find_input_format(const AudioStreamOptions &options);
+
+    // Probing limits from options (probe_size, analyze_duration)
+    static void set_probe_options(AVDictionary **format_opts, const AudioStreamOptions &options);
+
+    struct MemoryContext : AvioOpaque
     {
+      MemoryContext(const uint8_t *data, size_t size, std::shared_ptr<const void> owner)
+          : data(data), size(size), owner(std::move(owner)) {}
       const uint8_t *data;
       size_t size;
-      size_t pos;
+      size_t pos = 0;
+      std::shared_ptr<const void> owner;
     };
 
-    struct StreamContext
+    struct StreamContext : AvioOpaque
     {
       AVIOReadCallback avio_read_callback;
+      AVIOSeekCallback avio_seek_callback;
     };
 
     static int read_packet_memory(void *opaque, uint8_t *buf, int buf_size);
     static int64_t seek_memory(void *opaque, int64_t offset, int whence);
     static int read_packet_stream(void *opaque, uint8_t *buf, int buf_size);
+    static int64_t seek_stream(void *opaque, int64_t offset, int whence);
   };
 
 } // namespace avioflow
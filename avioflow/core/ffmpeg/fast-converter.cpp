@@ -0,0 +1,225 @@
+#include "fast-converter.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace avioflow
+{
+
+  namespace
+  {
+
+    // The layout swresample assumes for an input without channel order
+    void effective_layout(const AVChannelLayout &layout, AVChannelLayout *out)
+    {
+      if (layout.order == AV_CHANNEL_ORDER_UNSPEC)
+        av_channel_layout_default(out, layout.nb_channels);
+      else
+        av_channel_layout_copy(out, &layout);
+    }
+
+  } // namespace
+
+  bool FastConverter::init(AVSampleFormat in_format, const AVChannelLayout &in_layout,
+                           AVSampleFormat out_format, int out_channels,
+                           const simd::Kernels &kernels)
+  {
+    kernels_ = &kernels;
+    in_format_ = av_get_packed_sample_fmt(in_format);
+    in_planar_ = av_sample_fmt_is_planar(in_format) != 0;
+    in_channels_ = in_layout.nb_channels;
+    in_bytes_ = av_get_bytes_per_sample(in_format);
+    bool out_planar = out_format == AV_SAMPLE_FMT_FLTP;
+
+    if (out_format != AV_SAMPLE_FMT_FLT && out_format != AV_SAMPLE_FMT_FLTP)
+      return false;
+    if (in_format_ != AV_SAMPLE_FMT_S16 && in_format_ != AV_SAMPLE_FMT_S32 &&
+        in_format_ != AV_SAMPLE_FMT_FLT)
+      return false;
+    if (in_channels_ <= 0 || out_channels <= 0)
+      return false;
+
+    AVChannelLayout in_ch_layout{}, out_ch_layout{};
+    effective_layout(in_layout, &in_ch_layout);
+    av_channel_layout_default(&out_ch_layout, out_channels);
+    bool supported = false;
+
+    if (in_channels_ == out_channels)
+    {
+      // swresample rematrixes between different layouts of the same size
+      supported = av_channel_layout_compare(&in_ch_layout, &out_ch_layout) == 0 &&
+                  in_format != out_format;
+      if (in_planar_ == out_planar || in_channels_ == 1)
+      {
+        kind_ = Kind::Convert;
+        planes_ = in_planar_ ? in_channels_ : 1;
+        plane_elements_ = in_planar_ ? 1 : in_channels_;
+      }
+      else if (!in_planar_)
+      {
+        kind_ = Kind::Deinterleave;
+        dst_planes_.resize(out_channels);
+      }
+      else
+      {
+        supported = false; // Planar to interleaved is left to swresample
+      }
+    }
+    else if (out_channels == 1 && in_channels_ <= 64)
+    {
+      // swresample's defaults for float output (center / surround -3 dB, no
+      // LFE, no clipping limit, unit volume)
+      std::vector<double> matrix(in_channels_, 0.0);
+      supported = swr_build_matrix2(&in_ch_layout, &out_ch_layout, M_SQRT1_2, M_SQRT1_2, 0.0,
+                                    INT_MAX, 1.0, matrix.data(), in_channels_,
+                                    AV_MATRIX_ENCODING_NONE, nullptr) >= 0;
+      set_mix(matrix.data(), 1);
+    }
+
+    av_channel_layout_uninit(&in_ch_layout);
+    av_channel_layout_uninit(&out_ch_layout);
+    return supported;
+  }
+
+  bool FastConverter::init(AVSampleFormat in_format, const AVChannelLayout &in_layout,
+                           AVSampleFormat out_format, const std::vector<double> &matrix, int out_channels,
+                           const simd::Kernels &kernels)
+  {
+    kernels_ = &kernels;
+    in_format_ = av_get_packed_sample_fmt(in_format);
+    in_planar_ = av_sample_fmt_is_planar(in_format) != 0;
+    in_channels_ = in_layout.nb_channels;
+    in_bytes_ = av_get_bytes_per_sample(in_format);
+
+    // The kernels write one contiguous output channel at a time
+    if (out_format != AV_SAMPLE_FMT_FLTP && !(out_format == AV_SAMPLE_FMT_FLT && out_channels == 1))
+      return false;
+    if (in_format_ != AV_SAMPLE_FMT_S16 && in_format_ != AV_SAMPLE_FMT_S32 &&
+        in_format_ != AV_SAMPLE_FMT_FLT)
+      return false;
+    if (in_channels_ <= 0 || out_channels <= 0 ||
+        matrix.size() != static_cast<size_t>(in_channels_) * out_channels)
+      return false;
+
+    set_mix(matrix.data(), out_channels);
+    return true;
+  }
+
+  void FastConverter::set_mix(const double *matrix, int out_channels)
+  {
+    kind_ = Kind::Mix;
+    mix_channels_.clear();
+    mix_coeffs_.clear();
+    mix_rows_.assign(1, 0);
+    size_t max_terms = 0;
+    for (int o = 0; o < out_channels; ++o)
+    {
+      for (int c = 0; c < in_channels_; ++c)
+      {
+        // Mixed in single precision, like swresample does for float output
+        float coeff = static_cast<float>(matrix[static_cast<size_t>(o) * in_channels_ + c]);
+        if (coeff != 0.0f)
+        {
+          mix_channels_.push_back(c);
+          mix_coeffs_.push_back(coeff);
+        }
+      }
+      mix_rows_.push_back(mix_channels_.size());
+      max_terms = std::max(max_terms, mix_rows_[o + 1] - mix_rows_[o]);
+    }
+    src_planes_.resize(max_terms);
+  }
+
+  void FastConverter::convert(const uint8_t *const *src, int64_t src_offset, uint8_t *const *dst,
+                              int64_t dst_offset, int64_t count)
+  {
+    if (count <= 0)
+      return;
+    size_t frames = static_cast<size_t>(count);
+
+    switch (kind_)
+    {
+    case Kind::Convert:
+    {
+      size_t elements = frames * plane_elements_;
+      for (int p = 0; p < planes_; ++p)
+      {
+        const uint8_t *in = src[p] + src_offset * plane_elements_ * in_bytes_;
+        float *out = reinterpret_cast<float *>(dst[p]) + dst_offset * plane_elements_;
+        if (in_format_ == AV_SAMPLE_FMT_S16)
+          kernels_->s16_to_f32(reinterpret_cast<const int16_t *>(in), out, elements);
+        else if (in_format_ == AV_SAMPLE_FMT_S32)
+          kernels_->s32_to_f32(reinterpret_cast<const int32_t *>(in), out, elements);
+        else
+          std::memcpy(out, in, elements * sizeof(float));
+      }
+      break;
+    }
+    case Kind::Deinterleave:
+    {
+      const uint8_t *in = src[0] + src_offset * in_channels_ * in_bytes_;
+      for (size_t c = 0; c < dst_planes_.size(); ++c)
+        dst_planes_[c] = reinterpret_cast<float *>(dst[c]) + dst_offset;
+      if (in_format_ == AV_SAMPLE_FMT_S16)
+        kernels_->deinterleave_s16(reinterpret_cast<const int16_t *>(in), dst_planes_.data(),
+                                   in_channels_, frames);
+      else if (in_format_ == AV_SAMPLE_FMT_S32)
+        kernels_->deinterleave_s32(reinterpret_cast<const int32_t *>(in), dst_planes_.data(),
+                                   in_channels_, frames);
+      else
+        kernels_->deinterleave_f32(reinterpret_cast<const float *>(in), dst_planes_.data(),
+                                   in_channels_, frames);
+      break;
+    }
+    case Kind::Mix:
+    {
+      for (size_t o = 0; o + 1 < mix_rows_.size(); ++o)
+      {
+        float *out = reinterpret_cast<float *>(dst[o]) + dst_offset;
+        const int *channels = mix_channels_.data() + mix_rows_[o];
+        const float *coeffs = mix_coeffs_.data() + mix_rows_[o];
+        int terms = static_cast<int>(mix_rows_[o + 1] - mix_rows_[o]);
+        mix(src, src_offset, channels, coeffs, terms, out, frames);
+      }
+      break;
+    }
+    }
+  }
+
+  void FastConverter::mix(const uint8_t *const *src, int64_t src_offset, const int *channels,
+                          const float *coeffs, int terms, float *out, size_t frames)
+  {
+    if (terms == 0)
+    {
+      std::memset(out, 0, frames * sizeof(float));
+      return;
+    }
+    if (in_planar_)
+    {
+      for (int k = 0; k < terms; ++k)
+        src_planes_[k] = src[channels[k]] + src_offset * in_bytes_;
+      if (in_format_ == AV_SAMPLE_FMT_S16)
+        kernels_->downmix_s16p(reinterpret_cast<const int16_t *const *>(src_planes_.data()), coeffs, terms,
+                               out, frames);
+      else if (in_format_ == AV_SAMPLE_FMT_S32)
+        kernels_->downmix_s32p(reinterpret_cast<const int32_t *const *>(src_planes_.data()), coeffs, terms,
+                               out, frames);
+      else
+        kernels_->downmix_fltp(reinterpret_cast<const float *const *>(src_planes_.data()), coeffs, terms,
+                               out, frames);
+      return;
+    }
+    const uint8_t *in = src[0] + src_offset * in_channels_ * in_bytes_;
+    if (in_format_ == AV_SAMPLE_FMT_S16)
+      kernels_->downmix_s16(reinterpret_cast<const int16_t *>(in), in_channels_, channels, coeffs, terms,
+                            out, frames);
+    else if (in_format_ == AV_SAMPLE_FMT_S32)
+      kernels_->downmix_s32(reinterpret_cast<const int32_t *>(in), in_channels_, channels, coeffs, terms,
+                            out, frames);
+    else
+      kernels_->downmix_flt(reinterpret_cast<const float *>(in), in_channels_, channels, coeffs, terms,
+                            out, frames);
+  }
+
+} // namespace avioflow
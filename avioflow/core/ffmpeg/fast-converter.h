@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ffmpeg-common.h"
+#include "../utils/simd-kernels.h"
+#include <cstdint>
+#include <vector>
+
+namespace avioflow
+{
+
+  // Same-rate conversions to float that bypass the SwrContext:
+  // 16/32-bit integer and float input, planar or interleaved, to planar or
+  // interleaved float with the same channels, down to mono with
+  // swresample's default mixing coefficients, or through a custom channel
+  // matrix. Output equals swr_convert()'s.
+  class FastConverter
+  {
+  public:
+    // Prepare the conversion of `in_format` / `in_layout` to `out_format`
+    // (FLT or FLTP) with `out_channels`. Returns false when it is not covered
+    // and swresample has to do it. `kernels` defaults to the best the CPU runs.
+    bool init(AVSampleFormat in_format, const AVChannelLayout &in_layout,
+              AVSampleFormat out_format, int out_channels,
+              const simd::Kernels &kernels = simd::kernels());
+
+    // Prepare mixing through `matrix` (`out_channels` rows of
+    // in_layout.nb_channels coefficients), like swr_set_matrix(). Output is
+    // planar float, or interleaved float for a single output channel.
+    bool init(AVSampleFormat in_format, const AVChannelLayout &in_layout,
+              AVSampleFormat out_format, const std::vector<double> &matrix, int out_channels,
+              const simd::Kernels &kernels = simd::kernels());
+
+    // Convert `count` samples per channel, starting `src_offset` samples into
+    // the source planes and `dst_offset` samples into the destination planes
+    void convert(const uint8_t *const *src, int64_t src_offset, uint8_t *const *dst,
+                 int64_t dst_offset, int64_t count);
+
+  private:
+    enum class Kind
+    {
+      Convert,      // Element-wise: packed to packed, or plane by plane
+      Deinterleave, // Packed to planar
+      Mix           // Each output channel a weighted sum of input channels
+    };
+
+    void set_mix(const double *matrix, int out_channels);
+    void mix(const uint8_t *const *src, int64_t src_offset, const int *channels, const float *coeffs,
+             int terms, float *out, size_t frames);
+
+    Kind kind_ = Kind::Convert;
+    AVSampleFormat in_format_ = AV_SAMPLE_FMT_NONE; // Packed equivalent of the input format
+    bool in_planar_ = false;
+    int in_channels_ = 0;
+    int in_bytes_ = 0;
+    int planes_ = 0;            // Planes converted element-wise (Convert only)
+    int plane_elements_ = 1;    // Elements per sample and plane (Convert only)
+
+    // Mix terms: input channels with a nonzero coefficient, in order; the
+    // terms of output channel c are [mix_rows_[c], mix_rows_[c + 1])
+    std::vector<int> mix_channels_;
+    std::vector<float> mix_coeffs_;
+    std::vector<size_t> mix_rows_;
+
+    std::vector<const uint8_t *> src_planes_;
+    std::vector<float *> dst_planes_;
+    const simd::Kernels *kernels_ = nullptr;
+  };
+
+} // namespace avioflow
@@ -33,16 +33,31 @@ inline void check_av_error(int err, const std::string& msg) {
     }
 }
 
+// Base for custom AVIO opaque data. A format context opened on custom I/O
+// owns its AVIOContext and opaque, and releases both when it is closed.
+struct AvioOpaque { virtual ~AvioOpaque() = default; };
+
 // RAII Deleters for FFmpeg structures
-struct AVFormatContextDeleter { void operator()(AVFormatContext* p) { avformat_close_input(&p); } };
-struct AVCodecContextDeleter { void operator()(AVCodecContext* p) { avcodec_free_context(&p); } };
 struct AVIOContextDeleter { void operator()(AVIOContext* p) { if (p) { av_freep(&p->buffer); avio_context_free(&p); } } };
+struct AVFormatContextDeleter {
+    void operator()(AVFormatContext* p) {
+        AVIOContext* pb = (p && (p->flags & AVFMT_FLAG_CUSTOM_IO)) ? p->pb : nullptr;
+        avformat_close_input(&p);
+        if (pb) {
+            delete static_cast<AvioOpaque*>(pb->opaque);
+            AVIOContextDeleter{}(pb);
+        }
+    }
+};
+struct AVCodecContextDeleter { void operator()(AVCodecContext* p) { avcodec_free_context(&p); } };
+struct AVCodecParametersDeleter { void operator()(AVCodecParameters* p) { avcodec_parameters_free(&p); } };
 struct AVPacketDeleter { void operator()(AVPacket* p) { av_packet_free(&p); } };
 struct AVFrameDeleter { void operator()(AVFrame* p) { av_frame_free(&p); } };
 struct SwrContextDeleter { void operator()(SwrContext* p) { swr_free(&p); } };
 
 using AVFormatContextPtr = std::unique_ptr<AVFormatContext, AVFormatContextDeleter>;
 using AVCodecContextPtr = std::unique_ptr<AVCodecContext, AVCodecContextDeleter>;
+using AVCodecParametersPtr = std::unique_ptr<AVCodecParameters, AVCodecParametersDeleter>;
 using AVIOContextPtr = std::unique_ptr<AVIOContext, AVIOContextDeleter>;
 using AVPacketPtr = std::unique_ptr<AVPacket, AVPacketDeleter>;
 using AVFramePtr = std::unique_ptr<AVFrame, AVFrameDeleter>;
@@ -57,4 +72,8 @@ using AVIOSeekFunction = int64_t (*)(void*, int64_t, int);
 // Returns: >0 (bytes read), 0 (EOF), <0 (no data available, try again)
 using AVIOReadCallback = std::function<int(uint8_t*, int)>;
 
+// AVIO seek callback for seekable streaming input
+// whence: SEEK_SET, SEEK_CUR or SEEK_END. Returns: new position, or <0 on failure
+using AVIOSeekCallback = std::function<int64_t(int64_t, int)>;
+
 } // namespace avioflow
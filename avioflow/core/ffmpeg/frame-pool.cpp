@@ -0,0 +1,74 @@
+#include "frame-pool.h"
+
+namespace avioflow
+{
+
+  namespace
+  {
+
+    // Plane alignment for the SIMD kernels (AVX-512)
+    constexpr int kAlign = 64;
+
+  } // namespace
+
+  FramePool::~FramePool()
+  {
+    // Buffers still referenced by frames stay valid; the pool is freed
+    // when the last one comes back
+    av_buffer_pool_uninit(&pool_);
+  }
+
+  AVBufferRef *FramePool::allocate(void *opaque, size_t size)
+  {
+    ++static_cast<FramePool *>(opaque)->allocated_;
+    return av_buffer_alloc(size);
+  }
+
+  void FramePool::get_buffer(AVFrame *frame)
+  {
+    auto format = static_cast<AVSampleFormat>(frame->format);
+    int channels = frame->ch_layout.nb_channels;
+    int planes = av_sample_fmt_is_planar(format) ? channels : 1;
+    ++served_;
+
+    // More planes than AVFrame has data pointers: extended_data would be
+    // allocated per frame anyway
+    if (planes > AV_NUM_DATA_POINTERS)
+    {
+      ++allocated_;
+      check_av_error(av_frame_get_buffer(frame, kAlign), "Could not allocate frame buffer");
+      return;
+    }
+
+    int linesize = 0;
+    int size = av_samples_get_buffer_size(&linesize, channels, frame->nb_samples, format, kAlign);
+    check_av_error(size, "Could not compute frame buffer size");
+
+    // Grow to the largest frame seen, with headroom for the few samples
+    // resampled frames vary by; buffers of the old pool are freed as they
+    // are returned
+    if (!pool_ || static_cast<size_t>(size) > buffer_size_)
+    {
+      av_buffer_pool_uninit(&pool_);
+      buffer_size_ = static_cast<size_t>(size) + static_cast<size_t>(size) / 4;
+      pool_ = av_buffer_pool_init2(buffer_size_, this, &FramePool::allocate, nullptr);
+      if (!pool_)
+        throw std::runtime_error("Could not allocate frame buffer pool");
+    }
+
+    frame->buf[0] = av_buffer_pool_get(pool_);
+    if (!frame->buf[0])
+      throw std::runtime_error("Could not allocate frame buffer");
+    check_av_error(av_samples_fill_arrays(frame->data, frame->linesize, frame->buf[0]->data, channels,
+                                          frame->nb_samples, format, kAlign),
+                   "Could not set up frame planes");
+    frame->extended_data = frame->data;
+  }
+
+  void FramePool::add_stats(AllocationStats &stats) const
+  {
+    stats.buffers_allocated += allocated_;
+    stats.buffers_served += served_;
+  }
+
+} // namespace avioflow
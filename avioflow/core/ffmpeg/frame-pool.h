@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ffmpeg-common.h"
+#include "metadata.h"
+#include <cstdint>
+
+namespace avioflow
+{
+
+  // Recycles the sample buffers of frames the decoder fills itself
+  // (converted, F16 and captured frames). All planes of a frame share one
+  // buffer from an AVBufferPool; the pool's buffer size follows the largest
+  // frame requested (plus headroom), so after the first frames every frame
+  // reuses a returned buffer and decoding runs without allocating.
+  class FramePool
+  {
+  public:
+    FramePool() = default;
+    ~FramePool();
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    // Attach a buffer to `frame`, like av_frame_get_buffer(): format,
+    // nb_samples and ch_layout must be set
+    void get_buffer(AVFrame *frame);
+
+    // Adds this pool's counters to `stats`
+    void add_stats(AllocationStats &stats) const;
+
+  private:
+    static AVBufferRef *allocate(void *opaque, size_t size);
+
+    AVBufferPool *pool_ = nullptr;
+    size_t buffer_size_ = 0;
+    uint64_t allocated_ = 0;
+    uint64_t served_ = 0;
+  };
+
+} // namespace avioflow
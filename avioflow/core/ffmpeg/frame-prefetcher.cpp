@@ -0,0 +1,142 @@
+#include "frame-prefetcher.h"
+#include <utility>
+
+namespace avioflow
+{
+
+  namespace
+  {
+
+    // Pause before asking a live source without data again
+    constexpr std::chrono::milliseconds kIdleWait{2};
+
+  } // namespace
+
+  FramePrefetcher::FramePrefetcher(SingleStreamDecoder &decoder, int depth)
+      : decoder_(decoder), current_(av_frame_alloc())
+  {
+    if (depth <= 0)
+      throw std::invalid_argument("Prefetch depth must be positive");
+    for (int i = 0; i < depth; ++i)
+    {
+      slots_.emplace_back(av_frame_alloc());
+      if (!slots_.back())
+        throw std::runtime_error("Could not allocate prefetch frame");
+    }
+    if (!current_)
+      throw std::runtime_error("Could not allocate prefetch frame");
+  }
+
+  FramePrefetcher::~FramePrefetcher() { stop(); }
+
+  void FramePrefetcher::start()
+  {
+    stop();
+    thread_ = std::thread(&FramePrefetcher::run, this);
+  }
+
+  void FramePrefetcher::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    not_full_.notify_one();
+    if (thread_.joinable())
+      thread_.join();
+
+    for (auto &slot : slots_)
+      av_frame_unref(slot.get());
+    av_frame_unref(current_.get());
+    head_ = 0;
+    count_ = 0;
+    stop_ = false;
+    done_ = false;
+    error_ = nullptr;
+  }
+
+  void FramePrefetcher::run()
+  {
+    try
+    {
+      while (true)
+      {
+        AVFrame *frame = decoder_.decode_next();
+        if (!frame)
+        {
+          if (decoder_.is_finished())
+            break;
+          // No data available yet (live stream): look again shortly
+          std::unique_lock<std::mutex> lock(mutex_);
+          if (not_full_.wait_for(lock, kIdleWait, [this] { return stop_; }))
+            return;
+          continue;
+        }
+        if (frame->nb_samples == 0)
+          continue; // Resampler still filling its history
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return stop_ || count_ < slots_.size(); });
+        if (stop_)
+          return;
+        // Queue a reference: the decoder takes a fresh pooled buffer for the
+        // next frame and this one returns to the pool once consumed
+        check_av_error(av_frame_ref(slots_[(head_ + count_) % slots_.size()].get(), frame),
+                       "Could not reference prefetched frame");
+        ++count_;
+        stats_ = decoder_.get_allocation_stats();
+        not_empty_.notify_one();
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = decoder_.get_allocation_stats();
+    done_ = true;
+    not_empty_.notify_one();
+  }
+
+  AVFrame *FramePrefetcher::pop(std::optional<std::chrono::milliseconds> timeout)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    av_frame_unref(current_.get());
+    if (!thread_.joinable())
+      return nullptr; // Not started
+
+    auto ready = [this] { return count_ > 0 || done_; };
+    if (!timeout)
+      not_empty_.wait(lock, ready);
+    else if (!not_empty_.wait_for(lock, *timeout, ready))
+      return nullptr;
+
+    if (count_ == 0)
+    {
+      // Queued frames come first, then the error that ended decoding
+      if (error_)
+        std::rethrow_exception(std::exchange(error_, nullptr));
+      return nullptr;
+    }
+    av_frame_move_ref(current_.get(), slots_[head_].get());
+    head_ = (head_ + 1) % slots_.size();
+    --count_;
+    not_full_.notify_one();
+    return current_.get();
+  }
+
+  bool FramePrefetcher::finished() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_ && count_ == 0 && !error_;
+  }
+
+  AllocationStats FramePrefetcher::stats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+} // namespace avioflow
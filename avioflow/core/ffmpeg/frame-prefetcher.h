@@ -0,0 +1,67 @@
+#pragma once
+
+#include "single-stream-decoder.h"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace avioflow
+{
+
+  // Runs a SingleStreamDecoder on a background thread, decode_next() up to
+  // `depth` frames ahead of the consumer. Decoded frames are queued as
+  // references to their pooled buffers (no copy); the decoder waits while
+  // the queue is full. One producer (the thread), one consumer (pop()).
+  // While running, the decoder must not be used by anyone else, including
+  // its read callback's owner.
+  class FramePrefetcher
+  {
+  public:
+    FramePrefetcher(SingleStreamDecoder &decoder, int depth);
+    ~FramePrefetcher();
+
+    FramePrefetcher(const FramePrefetcher &) = delete;
+    FramePrefetcher &operator=(const FramePrefetcher &) = delete;
+
+    // Start decoding from the decoder's current position
+    void start();
+
+    // Stop the thread and drop queued frames; the decoder is free again
+    void stop();
+
+    // The next frame, waiting up to `timeout` (forever when unset). The frame
+    // stays valid until the next pop() or stop(). Returns nullptr on timeout
+    // or at the end (or before start()); rethrows an error raised by the
+    // decoder.
+    AVFrame *pop(std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    // The decoder reached the end and every frame was popped
+    bool finished() const;
+
+    // Decoder allocation counters as of the last queued frame
+    AllocationStats stats() const;
+
+  private:
+    void run();
+
+    SingleStreamDecoder &decoder_;
+    std::vector<AVFramePtr> slots_; // Ring of frame references
+    AVFramePtr current_;            // Last popped frame
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool stop_ = false;
+    bool done_ = false;
+    std::exception_ptr error_;
+    AllocationStats stats_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::thread thread_;
+  };
+
+} // namespace avioflow
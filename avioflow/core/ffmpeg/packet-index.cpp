@@ -0,0 +1,281 @@
+#include "packet-index.h"
+
+extern "C" {
+#include <libavutil/intreadwrite.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace avioflow
+{
+
+  namespace
+  {
+    // Sidecar layout (native endianness):
+    //   magic[8] | source_size | source_mtime | total_samples | count | entries
+    constexpr char kSidecarMagic[8] = {'A', 'V', 'F', 'I', 'D', 'X', '0', '1'};
+
+    struct SourceStamp
+    {
+      int64_t size = -1;
+      int64_t mtime = -1;
+
+      bool operator==(const SourceStamp &other) const { return size == other.size && mtime == other.mtime; }
+    };
+
+    // In-process index cache, least recently used first out
+    constexpr size_t kCacheCapacity = 256;
+
+    struct CacheEntry
+    {
+      SourceStamp stamp; // Version of the file the index was built for
+      std::shared_ptr<const PacketIndex> index;
+      std::list<std::string>::iterator lru;
+    };
+
+    SourceStamp stat_source(const std::string &path)
+    {
+      SourceStamp stamp;
+      std::error_code ec;
+      auto size = std::filesystem::file_size(path, ec);
+      if (ec)
+        return stamp;
+      auto mtime = std::filesystem::last_write_time(path, ec);
+      if (ec)
+        return stamp;
+      stamp.size = static_cast<int64_t>(size);
+      stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+      return stamp;
+    }
+
+    template <typename T>
+    void write_pod(std::ofstream &out, const T &value)
+    {
+      out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read_pod(std::ifstream &in, T &value)
+    {
+      return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+  } // namespace
+
+  std::shared_ptr<const PacketIndex> PacketIndex::build(AVFormatContext *fmt_ctx, int stream_index)
+  {
+    if (!fmt_ctx->pb || !(fmt_ctx->pb->seekable & AVIO_SEEKABLE_NORMAL))
+      throw std::runtime_error("Packet index requires a seekable source");
+
+    AVStream *stream = fmt_ctx->streams[stream_index];
+    AVRational sample_tb{1, stream->codecpar->sample_rate};
+    int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+    auto index = std::make_shared<PacketIndex>();
+    AVPacketPtr packet(av_packet_alloc());
+    int64_t next_sample = 0;
+    bool ordered = true;
+
+    // Demux only: no codec is involved, packets are dropped right away
+    int ret;
+    while ((ret = av_read_frame(fmt_ctx, packet.get())) >= 0)
+    {
+      if (packet->stream_index == stream_index)
+      {
+        PacketIndexEntry entry;
+        entry.pts = packet->pts;
+        entry.pos = packet->pos;
+        entry.sample = packet->pts != AV_NOPTS_VALUE
+                           ? av_rescale_q(packet->pts - start_time, stream->time_base, sample_tb)
+                           : next_sample;
+        entry.skip_start = entry.skip_end = 0;
+        size_t skip_size = 0;
+        if (const uint8_t *skip = av_packet_get_side_data(packet.get(), AV_PKT_DATA_SKIP_SAMPLES, &skip_size);
+            skip && skip_size >= 8)
+        {
+          entry.skip_start = AV_RL32(skip);
+          entry.skip_end = AV_RL32(skip + 4);
+        }
+
+        if (!index->entries_.empty())
+        {
+          const auto &last = index->entries_.back();
+          ordered = ordered && entry.sample >= last.sample && entry.pos > last.pos;
+        }
+        next_sample = entry.sample + av_rescale_q(packet->duration, stream->time_base, sample_tb);
+        index->entries_.push_back(entry);
+      }
+      av_packet_unref(packet.get());
+    }
+    if (ret != AVERROR_EOF)
+      check_av_error(ret, "Error reading packets for index");
+
+    if (!ordered)
+    {
+      // Keep sample lookup usable; byte offsets cannot be searched any more
+      std::stable_sort(index->entries_.begin(), index->entries_.end(),
+                       [](const auto &a, const auto &b) { return a.sample < b.sample; });
+      for (auto &entry : index->entries_)
+        entry.pos = -1;
+    }
+    index->total_samples_ = next_sample;
+
+    // Rewind to the first packet for regular decoding
+    int64_t first_ts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    check_av_error(avformat_seek_file(fmt_ctx, stream_index, INT64_MIN, first_ts, first_ts, 0),
+                   "Could not rewind after building packet index");
+    return index;
+  }
+
+  std::shared_ptr<const PacketIndex> PacketIndex::get_cached(const std::string &path,
+                                                             AVFormatContext *fmt_ctx,
+                                                             int stream_index)
+  {
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, CacheEntry> cache;
+    static std::list<std::string> lru; // Most recently used first
+
+    SourceStamp stamp = stat_source(path);
+    if (stamp.size < 0)
+      return build(fmt_ctx, stream_index); // Not a local file (URL, device)
+
+    // One entry per file and stream; a rewritten file replaces its entry
+    std::string key = path + "|" + std::to_string(stream_index);
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      auto it = cache.find(key);
+      if (it != cache.end() && it->second.stamp == stamp)
+      {
+        lru.splice(lru.begin(), lru, it->second.lru);
+        return it->second.index;
+      }
+    }
+
+    // Build outside the lock; concurrent misses on the same file just race
+    auto index = build(fmt_ctx, stream_index);
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+      it->second.stamp = stamp;
+      it->second.index = index;
+      lru.splice(lru.begin(), lru, it->second.lru);
+      return index;
+    }
+    lru.push_front(key);
+    cache.emplace(key, CacheEntry{stamp, index, lru.begin()});
+    if (cache.size() > kCacheCapacity)
+    {
+      cache.erase(lru.back());
+      lru.pop_back();
+    }
+    return index;
+  }
+
+  bool PacketIndex::save(const std::string &index_path, const std::string &source_path) const
+  {
+    std::ofstream out(index_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+      return false;
+
+    SourceStamp stamp = source_path.empty() ? SourceStamp{} : stat_source(source_path);
+    out.write(kSidecarMagic, sizeof(kSidecarMagic));
+    write_pod(out, stamp.size);
+    write_pod(out, stamp.mtime);
+    write_pod(out, total_samples_);
+    write_pod(out, static_cast<uint64_t>(entries_.size()));
+    out.write(reinterpret_cast<const char *>(entries_.data()),
+              static_cast<std::streamsize>(entries_.size() * sizeof(PacketIndexEntry)));
+    return static_cast<bool>(out);
+  }
+
+  std::shared_ptr<const PacketIndex> PacketIndex::load(const std::string &index_path,
+                                                       const std::string &source_path)
+  {
+    std::ifstream in(index_path, std::ios::binary);
+    if (!in.is_open())
+      return nullptr;
+
+    char magic[sizeof(kSidecarMagic)];
+    SourceStamp stored;
+    uint64_t count = 0;
+    auto index = std::make_shared<PacketIndex>();
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, kSidecarMagic, sizeof(magic)) != 0 ||
+        !read_pod(in, stored.size) || !read_pod(in, stored.mtime) ||
+        !read_pod(in, index->total_samples_) || !read_pod(in, count))
+      return nullptr;
+
+    // Stale sidecar: the source changed since the index was written
+    if (!source_path.empty())
+    {
+      SourceStamp current = stat_source(source_path);
+      if (current.size != stored.size || current.mtime != stored.mtime)
+        return nullptr;
+    }
+
+    // Truncated file or corrupt count: the entries must be what is left
+    std::streampos header_end = in.tellg();
+    if (!in.seekg(0, std::ios::end))
+      return nullptr;
+    uint64_t remaining = static_cast<uint64_t>(in.tellg() - header_end);
+    if (count > remaining / sizeof(PacketIndexEntry) || count * sizeof(PacketIndexEntry) != remaining)
+      return nullptr;
+    in.seekg(header_end);
+
+    index->entries_.resize(count);
+    if (!in.read(reinterpret_cast<char *>(index->entries_.data()),
+                 static_cast<std::streamsize>(count * sizeof(PacketIndexEntry))))
+      return nullptr;
+    return index;
+  }
+
+  const PacketIndexEntry *PacketIndex::find_by_sample(int64_t sample) const
+  {
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), sample,
+                               [](int64_t s, const auto &entry) { return s < entry.sample; });
+    if (it == entries_.begin())
+      return entries_.empty() ? nullptr : &entries_.front();
+    return &*(it - 1);
+  }
+
+  bool PacketIndex::restore_packet(AVPacket *packet, const AVStream *stream) const
+  {
+    const PacketIndexEntry *entry = find_by_pos(packet->pos);
+    if (!entry)
+      return false;
+
+    int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    packet->pts = packet->dts =
+        start_time + av_rescale_q(entry->sample, AVRational{1, stream->codecpar->sample_rate},
+                                  stream->time_base);
+
+    // Whatever the demuxer attached was derived from its restarted clock
+    av_packet_side_data_remove(packet->side_data, &packet->side_data_elems, AV_PKT_DATA_SKIP_SAMPLES);
+    if (entry->skip_start || entry->skip_end)
+    {
+      uint8_t *skip = av_packet_new_side_data(packet, AV_PKT_DATA_SKIP_SAMPLES, 10);
+      if (!skip)
+        throw std::runtime_error("Could not allocate packet side data");
+      AV_WL32(skip, entry->skip_start);
+      AV_WL32(skip + 4, entry->skip_end);
+      skip[8] = skip[9] = 0;
+    }
+    return true;
+  }
+
+  const PacketIndexEntry *PacketIndex::find_by_pos(int64_t pos) const
+  {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), pos,
+                               [](const auto &entry, int64_t p) { return entry.pos < p; });
+    if (it == entries_.end() || it->pos != pos)
+      return nullptr;
+    return &*it;
+  }
+
+} // namespace avioflow
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ffmpeg-common.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace avioflow
+{
+
+  // One demuxed packet of the indexed audio stream
+  struct PacketIndexEntry
+  {
+    int64_t pts;    // Presentation timestamp (stream time base)
+    int64_t pos;    // Byte offset of the packet in the source
+    int64_t sample; // Source sample of the packet start, relative to stream start_time
+    uint32_t skip_start; // Priming / padding samples the demuxer trims (AV_PKT_DATA_SKIP_SAMPLES)
+    uint32_t skip_end;
+  };
+
+  // Packet index built from one demux-only pass over an audio stream.
+  // Maps sample offsets to packet byte offsets, so seeking does not depend on
+  // the container's seek tables (VBR MP3 without TOC, raw ADTS, ...).
+  class PacketIndex
+  {
+  public:
+    // Demux every packet of `stream_index`, then rewind the format context
+    static std::shared_ptr<const PacketIndex> build(AVFormatContext *fmt_ctx, int stream_index);
+
+    // In-process cache of the indexes of the last 256 files used, one per
+    // path + stream; builds on a miss or when the file's mtime or size changed
+    static std::shared_ptr<const PacketIndex> get_cached(const std::string &path,
+                                                         AVFormatContext *fmt_ctx,
+                                                         int stream_index);
+
+    // Sidecar file I/O. load() returns nullptr if the file is missing, corrupt,
+    // or was built for a different version of `source_path`.
+    bool save(const std::string &index_path, const std::string &source_path = {}) const;
+    static std::shared_ptr<const PacketIndex> load(const std::string &index_path,
+                                                   const std::string &source_path = {});
+
+    // Last packet starting at or before `sample` (nullptr if index is empty)
+    const PacketIndexEntry *find_by_sample(int64_t sample) const;
+
+    // Packet starting at byte offset `pos` (nullptr if not indexed)
+    const PacketIndexEntry *find_by_pos(int64_t pos) const;
+
+    // Restore timestamps and trimming side data of `packet` from its entry.
+    // Needed after a byte seek, where the demuxer's own clock restarts at zero.
+    // Returns false if the packet is not in the index.
+    bool restore_packet(AVPacket *packet, const AVStream *stream) const;
+
+    const std::vector<PacketIndexEntry> &entries() const { return entries_; }
+    int64_t total_samples() const { return total_samples_; }
+    bool empty() const { return entries_.empty(); }
+
+  private:
+    std::vector<PacketIndexEntry> entries_; // Sorted by sample and by pos
+    int64_t total_samples_ = 0;
+  };
+
+} // namespace avioflow
@@ -0,0 +1,127 @@
+#include "parallel-decoder.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace avioflow
+{
+
+  ParallelDecoder::ParallelDecoder(const AudioStreamOptions &options, OpenFn open, int num_threads)
+      : options_(options), open_(std::move(open)), num_threads_(num_threads)
+  {
+    if (num_threads_ <= 0)
+      num_threads_ = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    // Whole-file decoding of the main output: no chunks, no branches
+    options_.chunk_samples.reset();
+    options_.hop_samples.reset();
+    options_.branches.clear();
+  }
+
+  AudioBuffer ParallelDecoder::decode_all()
+  {
+    // The first decoder provides metadata and the shared packet index, then
+    // decodes the first segment
+    auto first = std::make_unique<SingleStreamDecoder>(options_);
+    open_(*first);
+    if (!first->packet_index())
+      first->build_packet_index();
+    std::shared_ptr<const PacketIndex> index = first->packet_index();
+
+    const Metadata &metadata = first->get_metadata();
+    int out_rate = options_.output_sample_rate.value_or(metadata.sample_rate);
+    int channels = first->output_channels();
+    int64_t estimated = av_rescale(index->total_samples(), out_rate, metadata.sample_rate);
+
+    int64_t min_segment = static_cast<int64_t>(kMinSegmentSeconds * out_rate);
+    int num_segments = static_cast<int>(
+        std::clamp<int64_t>(estimated / std::max<int64_t>(min_segment, 1), 1, num_threads_));
+    if (num_segments == 1)
+      return first->decode_all();
+
+    // Segment i covers output samples [bounds[i], bounds[i + 1]); the last
+    // one is open-ended and decodes until EOF
+    std::vector<int64_t> bounds(num_segments + 1);
+    for (int i = 0; i <= num_segments; ++i)
+      bounds[i] = estimated * i / num_segments;
+
+    AudioBuffer result(channels, estimated + out_rate, out_rate, options_.output_sample_format,
+                       options_.output_layout);
+    std::vector<std::unique_ptr<SingleStreamDecoder>> decoders(num_segments);
+    std::vector<int64_t> written(num_segments, 0);
+    std::vector<std::exception_ptr> errors(num_segments);
+    decoders[0] = std::move(first);
+
+    AudioStreamOptions segment_options = options_;
+    segment_options.use_packet_index = false;
+    segment_options.packet_index_path.reset();
+
+    auto decode_segment = [&](int i)
+    {
+      try
+      {
+        if (i > 0)
+        {
+          decoders[i] = std::make_unique<SingleStreamDecoder>(segment_options);
+          open_(*decoders[i]);
+          decoders[i]->set_packet_index(index);
+          decoders[i]->seek_to_sample(bounds[i]);
+        }
+
+        std::vector<uint8_t *> dst(result.num_planes());
+        for (int p = 0; p < result.num_planes(); ++p)
+          dst[p] = result.plane_data(p, bounds[i]);
+
+        bool last = i == num_segments - 1;
+        int64_t capacity = last ? result.capacity() - bounds[i] : bounds[i + 1] - bounds[i];
+        written[i] = decoders[i]->decode_all_into(dst.data(), capacity);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_segments - 1);
+    for (int i = 1; i < num_segments; ++i)
+      workers.emplace_back(decode_segment, i);
+    decode_segment(0);
+    for (auto &worker : workers)
+      worker.join();
+
+    for (auto &error : errors)
+    {
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+    // Stitch: segments are contiguous unless the input ended before a
+    // segment boundary (index longer than the decodable audio)
+    int64_t total = 0;
+    int last = num_segments - 1;
+    for (int i = 0; i < num_segments; ++i)
+    {
+      total = bounds[i] + written[i];
+      if (i < last && written[i] < bounds[i + 1] - bounds[i])
+      {
+        last = i;
+        break;
+      }
+    }
+    result.resize(total);
+
+    // The estimate was too small: finish the last segment serially
+    SingleStreamDecoder &tail = *decoders[last];
+    while (!tail.is_finished())
+    {
+      result.grow(result.capacity() + 1);
+      std::vector<uint8_t *> dst(result.num_planes());
+      for (int p = 0; p < result.num_planes(); ++p)
+        dst[p] = result.plane_data(p, result.num_samples());
+      int64_t count = tail.decode_all_into(dst.data(), result.capacity() - result.num_samples());
+      result.resize(result.num_samples() + count);
+    }
+    return result;
+  }
+
+} // namespace avioflow
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "single-stream-decoder.h"
+#include <functional>
+
+namespace avioflow
+{
+
+  // Offline decoding of one input on several threads.
+  //
+  // The packet stream is split into contiguous segments at packet index
+  // boundaries. Every segment gets its own SingleStreamDecoder, which seeks to
+  // the segment start (decoding the codec pre-roll and restarting the
+  // resampler on the serial sample grid) and writes exactly the segment's
+  // samples into its slice of one shared AudioBuffer. The result is
+  // sample-identical to SingleStreamDecoder::decode_all().
+  class ParallelDecoder
+  {
+  public:
+    // Opens the same (seekable) input on a fresh decoder, once per segment
+    using OpenFn = std::function<void(SingleStreamDecoder &)>;
+
+    // num_threads <= 0 uses std::thread::hardware_concurrency()
+    ParallelDecoder(const AudioStreamOptions &options, OpenFn open, int num_threads = 0);
+
+    AudioBuffer decode_all();
+
+    // Inputs shorter than this per thread are not worth splitting
+    static constexpr double kMinSegmentSeconds = 20.0;
+
+  private:
+    AudioStreamOptions options_;
+    OpenFn open_;
+    int num_threads_;
+  };
+
+} // namespace avioflow
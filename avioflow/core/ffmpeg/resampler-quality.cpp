@@ -0,0 +1,81 @@
+#include "resampler-quality.h"
+#include <cstring>
+
+namespace avioflow
+{
+
+  namespace
+  {
+
+    ResamplerSettings preset_settings(ResamplerPreset preset)
+    {
+      ResamplerSettings settings;
+      switch (preset)
+      {
+      case ResamplerPreset::Fastest:
+        settings.filter_size = 8;
+        settings.phase_shift = 8;
+        settings.cutoff = 0.9;
+        settings.kaiser_beta = 4.0;
+        settings.soxr_precision = 16;
+        break;
+      case ResamplerPreset::Balanced:
+        settings.filter_size = 16;
+        settings.cutoff = 0.9;
+        settings.kaiser_beta = 4.0;
+        break;
+      case ResamplerPreset::High:
+        settings.filter_size = 64;
+        settings.phase_shift = 12;
+        settings.kaiser_beta = 12.0;
+        settings.soxr_precision = 28;
+        break;
+      case ResamplerPreset::Default:
+        break;
+      }
+      return settings;
+    }
+
+  } // namespace
+
+  ResamplerSettings resolve_resampler_quality(const ResamplerQuality &quality)
+  {
+    ResamplerSettings settings = preset_settings(quality.preset);
+    if (quality.filter_size)
+      settings.filter_size = *quality.filter_size;
+    if (quality.phase_shift)
+      settings.phase_shift = *quality.phase_shift;
+    if (quality.linear_interp)
+      settings.linear_interp = *quality.linear_interp;
+    if (quality.cutoff)
+      settings.cutoff = *quality.cutoff;
+
+    if (settings.filter_size < 1 || settings.filter_size > 256)
+      throw std::invalid_argument("Resampler filter_size must be in [1, 256]");
+    if (settings.phase_shift < 0 || settings.phase_shift > 24)
+      throw std::invalid_argument("Resampler phase_shift must be in [0, 24]");
+    if (!(settings.cutoff > 0.0 && settings.cutoff <= 1.0))
+      throw std::invalid_argument("Resampler cutoff must be in (0, 1]");
+    return settings;
+  }
+
+  void apply_resampler_settings(SwrContext *swr, const ResamplerSettings &settings, bool use_soxr)
+  {
+    check_av_error(av_opt_set_int(swr, "filter_size", settings.filter_size, 0), "Could not set filter_size");
+    check_av_error(av_opt_set_int(swr, "phase_shift", settings.phase_shift, 0), "Could not set phase_shift");
+    check_av_error(av_opt_set_int(swr, "linear_interp", settings.linear_interp, 0), "Could not set linear_interp");
+    check_av_error(av_opt_set_double(swr, "cutoff", settings.cutoff, 0), "Could not set cutoff");
+    check_av_error(av_opt_set_double(swr, "kaiser_beta", settings.kaiser_beta, 0), "Could not set kaiser_beta");
+    check_av_error(av_opt_set_int(swr, "resampler", use_soxr ? SWR_ENGINE_SOXR : SWR_ENGINE_SWR, 0),
+                   "Could not select the resampling engine");
+    if (use_soxr)
+      check_av_error(av_opt_set_double(swr, "precision", settings.soxr_precision, 0), "Could not set precision");
+  }
+
+  bool soxr_available()
+  {
+    static const bool available = std::strstr(swresample_configuration(), "--enable-libsoxr") != nullptr;
+    return available;
+  }
+
+} // namespace avioflow
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ffmpeg-common.h"
+#include "metadata.h"
+
+namespace avioflow
+{
+
+  // Filter design a ResamplerQuality resolves to: the preset's values with
+  // the caller's overrides applied. Default equals swresample's defaults.
+  struct ResamplerSettings
+  {
+    int filter_size = 32;
+    int phase_shift = 10;
+    bool linear_interp = true;
+    double cutoff = 0.97;
+    double kaiser_beta = 9.0;
+    int soxr_precision = 20; // Bits; only with the SoX engine
+  };
+
+  ResamplerSettings resolve_resampler_quality(const ResamplerQuality &quality);
+
+  // Set the filter options on an allocated SwrContext before swr_init().
+  // The SoX engine is only selected when `use_soxr` is set.
+  void apply_resampler_settings(SwrContext *swr, const ResamplerSettings &settings, bool use_soxr);
+
+  // Whether this FFmpeg build can run the SoX engine
+  bool soxr_available();
+
+} // namespace avioflow
@@ -1,7 +1,13 @@
 #include "single-stream-decoder.h"
 #include "avio-context-handler.h"
 #include "device-handler.h"
+#include "../utils/sample-convert.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
 #include <mutex>
+#include <numeric>
 #include <functional>
 
 namespace avioflow
@@ -9,7 +15,56 @@ namespace avioflow
 
   SingleStreamDecoder::SingleStreamDecoder(const AudioStreamOptions &options)
       : packet_(av_packet_alloc()), frame_(av_frame_alloc()),
-        converted_frame_(av_frame_alloc()), options_(options) {}
+        converted_frame_(av_frame_alloc()), half_frame_(av_frame_alloc()), options_(options)
+  {
+    // F16 has no FFmpeg sample format: resample to float, convert afterwards
+    bool planar = options_.output_layout == SampleLayout::Planar;
+    half_output_ = options_.output_sample_format == SampleFormat::F16;
+    if (options_.output_sample_format == SampleFormat::S16)
+      output_sample_format_ = planar ? AV_SAMPLE_FMT_S16P : AV_SAMPLE_FMT_S16;
+    else
+      output_sample_format_ = planar ? AV_SAMPLE_FMT_FLTP : AV_SAMPLE_FMT_FLT;
+    resampler_settings_ = resolve_resampler_quality(options_.resampler_quality);
+
+    // Channel selection fixes the output channel count
+    if (!options_.channel_indices.empty() || !options_.mix_matrix.empty())
+    {
+      if (!options_.channel_indices.empty() && !options_.mix_matrix.empty())
+        throw std::invalid_argument("Set either channel_indices or mix_matrix, not both");
+      int selected = static_cast<int>(options_.channel_indices.empty() ? options_.mix_matrix.size()
+                                                                      : options_.channel_indices.size());
+      if (options_.output_num_channels && *options_.output_num_channels != selected)
+        throw std::invalid_argument("output_num_channels does not match the channel selection");
+      for (int index : options_.channel_indices)
+      {
+        if (index < 0)
+          throw std::invalid_argument("channel_indices must not be negative");
+      }
+      options_.output_num_channels = selected;
+    }
+
+    if (options_.chunk_samples.has_value())
+    {
+      chunk_samples_ = *options_.chunk_samples;
+      hop_samples_ = options_.hop_samples.value_or(chunk_samples_);
+      if (chunk_samples_ <= 0 || hop_samples_ <= 0)
+        throw std::invalid_argument("chunk_samples and hop_samples must be positive");
+      chunk_frame_.reset(av_frame_alloc());
+      chunk_spare_.reset(av_frame_alloc());
+    }
+
+    for (const OutputBranch &branch : options_.branches)
+    {
+      AudioStreamOptions branch_options;
+      branch_options.output_sample_rate = branch.output_sample_rate;
+      branch_options.output_num_channels = branch.output_num_channels;
+      branch_options.output_sample_format = branch.output_sample_format;
+      branch_options.output_layout = branch.output_layout;
+      branch_options.resampler = branch.resampler;
+      branch_options.resampler_quality = branch.resampler_quality;
+      branches_.push_back(std::make_unique<SingleStreamDecoder>(branch_options));
+    }
+  }
 
   void SingleStreamDecoder::open(const std::string &source)
   {
@@ -33,34 +88,230 @@ namespace avioflow
     }
 #endif
 
+    open_input(source);
+    setup_decoder();
+    source_path_ = source;
+    if (!options_.probe_only)
+      setup_packet_index(source);
+  }
+
+  void SingleStreamDecoder::reopen(const std::string &source)
+  {
+#ifdef AVIOFLOW_HAS_WASAPI
+    if (source == "wasapi_loopback")
+    {
+      open(source);
+      return;
+    }
+#endif
+
+    open_input(source);
+    setup_decoder(true);
+    source_path_ = source;
+    if (!options_.probe_only)
+      setup_packet_index(source);
+  }
+
+  void SingleStreamDecoder::open_input(const std::string &source)
+  {
     if (source.find("audio=") == 0 || source.find("video=") == 0)
     {
       fmt_ctx_.reset(DeviceHandler::open_device(source));
     }
     else
     {
-      fmt_ctx_.reset(AvioContextHandler::open_url(source));
+      fmt_ctx_.reset(AvioContextHandler::open_url(source, options_));
     }
-    setup_decoder();
   }
 
-  void SingleStreamDecoder::open_memory(const uint8_t *data, size_t size)
+  void SingleStreamDecoder::setup_packet_index(const std::string &source)
   {
-    fmt_ctx_.reset(AvioContextHandler::open_memory(data, size, options_));
+    if (options_.packet_index_path.has_value())
+    {
+      const std::string &index_path = options_.packet_index_path.value();
+      packet_index_ = PacketIndex::load(index_path, source);
+      if (!packet_index_)
+      {
+        packet_index_ = PacketIndex::build(fmt_ctx_.get(), audio_stream_index_);
+        if (!packet_index_->save(index_path, source))
+          throw std::runtime_error("Could not write packet index: " + index_path);
+      }
+    }
+    else if (options_.use_packet_index)
+    {
+      packet_index_ = PacketIndex::get_cached(source, fmt_ctx_.get(), audio_stream_index_);
+    }
+  }
+
+  void SingleStreamDecoder::build_packet_index()
+  {
+    if (!fmt_ctx_ || !codec_ctx_ || options_.probe_only)
+      throw std::runtime_error("Building a packet index requires an opened source");
+    packet_index_ = PacketIndex::build(fmt_ctx_.get(), audio_stream_index_);
+    seek_to_sample(0);
+  }
+
+  void SingleStreamDecoder::save_packet_index(const std::string &index_path) const
+  {
+    if (!packet_index_)
+      throw std::runtime_error("No packet index to save");
+    // Stamped with the source, so that a later load() accepts it
+    if (!packet_index_->save(index_path, source_path_))
+      throw std::runtime_error("Could not write packet index: " + index_path);
+  }
+
+  void SingleStreamDecoder::open_memory(const uint8_t *data, size_t size,
+                                        std::shared_ptr<const void> owner)
+  {
+    fmt_ctx_.reset(AvioContextHandler::open_memory(data, size, options_, std::move(owner)));
     setup_decoder();
   }
 
-  void SingleStreamDecoder::open_stream(AVIOReadCallback avio_read_callback)
+  void SingleStreamDecoder::reopen_memory(const uint8_t *data, size_t size,
+                                          std::shared_ptr<const void> owner)
+  {
+    fmt_ctx_.reset(AvioContextHandler::open_memory(data, size, options_, std::move(owner)));
+    setup_decoder(true);
+  }
+
+  void SingleStreamDecoder::open_stream(AVIOReadCallback avio_read_callback,
+                                        AVIOSeekCallback avio_seek_callback)
   {
     avio_read_callback_ = std::move(avio_read_callback);
-    fmt_ctx_.reset(AvioContextHandler::open_stream(avio_read_callback_, options_));
+    fmt_ctx_.reset(AvioContextHandler::open_stream(avio_read_callback_, options_,
+                                                   std::move(avio_seek_callback)));
     setup_decoder();
   }
 
-  void SingleStreamDecoder::setup_decoder()
+  bool SingleStreamDecoder::codec_params_match(const AVCodecParameters *params) const
+  {
+    const AVCodecParameters *current = codec_params_.get();
+    return current && current->codec_id == params->codec_id &&
+           current->format == params->format &&
+           current->sample_rate == params->sample_rate &&
+           av_channel_layout_compare(&current->ch_layout, &params->ch_layout) == 0 &&
+           current->block_align == params->block_align &&
+           current->bits_per_coded_sample == params->bits_per_coded_sample &&
+           current->extradata_size == params->extradata_size &&
+           (current->extradata_size == 0 ||
+            std::memcmp(current->extradata, params->extradata, current->extradata_size) == 0);
+  }
+
+  bool SingleStreamDecoder::header_is_complete(bool need_duration) const
+  {
+    // Streams only known after reading packets (e.g. MPEG-TS) need analysis
+    if (fmt_ctx_->nb_streams == 0 || (fmt_ctx_->ctx_flags & AVFMTCTX_NOHEADER))
+      return false;
+
+    int index = av_find_best_stream(fmt_ctx_.get(), AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (index < 0)
+      return false;
+    const AVStream *stream = fmt_ctx_->streams[index];
+    const AVCodecParameters *par = stream->codecpar;
+    return par->codec_id != AV_CODEC_ID_NONE && par->sample_rate > 0 &&
+           par->ch_layout.nb_channels > 0 && (!need_duration || stream->duration > 0);
+  }
+
+  void SingleStreamDecoder::apply_stream_description(const StreamDescription &description)
+  {
+    // av_find_best_stream() ignores audio streams whose rate and channels
+    // are still unknown, which is exactly what the description fills in
+    int index = -1;
+    for (unsigned i = 0; i < fmt_ctx_->nb_streams && index < 0; ++i)
+    {
+      if (fmt_ctx_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO)
+        index = static_cast<int>(i);
+    }
+    if (index < 0)
+      throw std::runtime_error("Stream description needs a container that declares its audio "
+                               "stream in the header (container: " + description.container + ")");
+
+    const AVCodecDescriptor *codec_desc = avcodec_descriptor_get_by_name(description.codec.c_str());
+    if (!codec_desc || codec_desc->type != AVMEDIA_TYPE_AUDIO)
+      throw std::runtime_error("Unknown audio codec in stream description: " + description.codec);
+    if (description.sample_rate <= 0 || description.num_channels <= 0)
+      throw std::runtime_error("Stream description needs a sample rate and channel count");
+
+    AVCodecParameters *par = fmt_ctx_->streams[index]->codecpar;
+    par->codec_type = AVMEDIA_TYPE_AUDIO;
+    par->codec_id = codec_desc->id;
+    par->sample_rate = description.sample_rate;
+    par->block_align = description.block_align;
+    par->bits_per_coded_sample = description.bits_per_coded_sample;
+
+    av_channel_layout_uninit(&par->ch_layout);
+    if (description.channel_mask != 0)
+      check_av_error(av_channel_layout_from_mask(&par->ch_layout, description.channel_mask),
+                     "Invalid channel mask in stream description");
+    else
+      av_channel_layout_default(&par->ch_layout, description.num_channels);
+
+    av_freep(&par->extradata);
+    par->extradata_size = 0;
+    if (!description.extradata.empty())
+    {
+      par->extradata = static_cast<uint8_t *>(
+          av_mallocz(description.extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (!par->extradata)
+        throw std::runtime_error("Could not allocate extradata");
+      std::memcpy(par->extradata, description.extradata.data(), description.extradata.size());
+      par->extradata_size = static_cast<int>(description.extradata.size());
+    }
+  }
+
+  AllocationStats SingleStreamDecoder::get_allocation_stats() const
   {
-    check_av_error(avformat_find_stream_info(fmt_ctx_.get(), nullptr),
-                   "Could not find stream info");
+    AllocationStats stats;
+    converted_pool_.add_stats(stats);
+    half_pool_.add_stats(stats);
+    capture_pool_.add_stats(stats);
+    chunk_pool_.add_stats(stats);
+    for (const auto &branch : branches_)
+    {
+      AllocationStats branch_stats = branch->get_allocation_stats();
+      stats.buffers_allocated += branch_stats.buffers_allocated;
+      stats.buffers_served += branch_stats.buffers_served;
+    }
+    return stats;
+  }
+
+  StreamDescription SingleStreamDecoder::get_stream_description() const
+  {
+    if (!fmt_ctx_ || audio_stream_index_ < 0)
+      throw std::runtime_error("No stream opened");
+
+    const AVCodecParameters *par = fmt_ctx_->streams[audio_stream_index_]->codecpar;
+    StreamDescription description;
+    // Demuxer names can be lists ("mov,mp4,m4a,..."); any entry finds it again
+    std::string names = fmt_ctx_->iformat->name;
+    description.container = names.substr(0, names.find(','));
+    description.codec = avcodec_get_name(par->codec_id);
+    description.sample_rate = par->sample_rate;
+    description.num_channels = par->ch_layout.nb_channels;
+    if (par->ch_layout.order == AV_CHANNEL_ORDER_NATIVE)
+      description.channel_mask = par->ch_layout.u.mask;
+    description.extradata.assign(par->extradata, par->extradata + par->extradata_size);
+    description.block_align = par->block_align;
+    description.bits_per_coded_sample = par->bits_per_coded_sample;
+    return description;
+  }
+
+  void SingleStreamDecoder::setup_decoder(bool reuse_contexts)
+  {
+    if (options_.stream_description.has_value())
+    {
+      // Known stream: no analysis, the codec parameters come from the caller
+      apply_stream_description(options_.stream_description.value());
+    }
+    else if (!(options_.probe_only && header_is_complete()) &&
+             !(input_gate_ && header_is_complete(false)))
+    {
+      // In probe-only mode, a complete header is enough: skip reading and
+      // decoding packets to analyze the streams. Push-mode input does not
+      // need the duration either.
+      check_av_error(avformat_find_stream_info(fmt_ctx_.get(), nullptr),
+                     "Could not find stream info");
+    }
 
     audio_stream_index_ = av_find_best_stream(fmt_ctx_.get(), AVMEDIA_TYPE_AUDIO,
                                               -1, -1, nullptr, 0);
@@ -72,22 +323,51 @@ namespace avioflow
     if (!codec)
       throw std::runtime_error("Could not find decoder");
 
-    codec_ctx_.reset(avcodec_alloc_context3(codec));
-    check_av_error(
-        avcodec_parameters_to_context(codec_ctx_.get(), stream->codecpar),
-        "Could not copy codec params");
-    check_av_error(avcodec_open2(codec_ctx_.get(), codec, nullptr),
-                   "Could not open codec");
+    if (options_.probe_only)
+    {
+      // Metadata straight from the stream parameters, no codec context
+      metadata_.sample_rate = stream->codecpar->sample_rate;
+      metadata_.num_channels = stream->codecpar->ch_layout.nb_channels;
+      metadata_.sample_format = probe_sample_format(stream->codecpar, codec);
+    }
+    else if (reuse_contexts && codec_ctx_ && codec_params_match(stream->codecpar))
+    {
+      // Same stream parameters: a flush returns the decoder to its initial state
+      avcodec_flush_buffers(codec_ctx_.get());
+      codec_ctx_->pkt_timebase = stream->time_base;
+    }
+    else
+    {
+      codec_ctx_.reset(avcodec_alloc_context3(codec));
+      check_av_error(
+          avcodec_parameters_to_context(codec_ctx_.get(), stream->codecpar),
+          "Could not copy codec params");
+      // Lets the decoder keep frame timestamps exact when it trims priming samples
+      codec_ctx_->pkt_timebase = stream->time_base;
+      check_av_error(avcodec_open2(codec_ctx_.get(), codec, nullptr),
+                     "Could not open codec");
+
+      if (!codec_params_)
+        codec_params_.reset(avcodec_parameters_alloc());
+      check_av_error(avcodec_parameters_copy(codec_params_.get(), stream->codecpar),
+                     "Could not copy codec params");
+    }
 
     // Populate metadata (following torchcodec's approach)
-    metadata_.sample_rate = codec_ctx_->sample_rate;
-    metadata_.num_channels = codec_ctx_->ch_layout.nb_channels;
+    if (!options_.probe_only)
+    {
+      metadata_.sample_rate = codec_ctx_->sample_rate;
+      metadata_.num_channels = codec_ctx_->ch_layout.nb_channels;
+      // Get sample format from codec context
+      metadata_.sample_format = av_get_sample_fmt_name(codec_ctx_->sample_fmt);
+    }
     metadata_.codec = codec->name;
     metadata_.bit_rate = fmt_ctx_->bit_rate > 0 ? fmt_ctx_->bit_rate : stream->codecpar->bit_rate;
     metadata_.container = fmt_ctx_->iformat->name;
-    
-    // Get sample format from codec context
-    metadata_.sample_format = av_get_sample_fmt_name(codec_ctx_->sample_fmt);
+    // WAV holding PCM reads 64 KiB ahead with its first packet (S/PDIF detection)
+    gate_lookahead_ = std::strcmp(fmt_ctx_->iformat->name, "wav") == 0 && stream->codecpar->codec_tag == 1
+                          ? 1 << 16
+                          : 0;
 
     // Duration extraction (following torchcodec's approach):
     // 1. Prefer stream->duration (populated by Xing/VBRI parsing in avformat_find_stream_info)
@@ -105,11 +385,68 @@ namespace avioflow
     // Estimate num_samples from duration (will be updated with exact count at EOF)
     if (metadata_.duration > 0 && metadata_.sample_rate > 0) {
         metadata_.num_samples = static_cast<int64_t>(metadata_.duration * metadata_.sample_rate);
+    } else {
+        metadata_.num_samples = 0;
+    }
+
+    // Without stream analysis the container bit rate is not computed yet
+    if (metadata_.bit_rate <= 0 && metadata_.duration > 0 && fmt_ctx_->pb) {
+        int64_t size = avio_size(fmt_ctx_->pb);
+        if (size > 0)
+            metadata_.bit_rate = static_cast<int64_t>(size * 8 / metadata_.duration);
     }
 
     total_samples_decoded_ = 0;
+    ++frame_generation_;
+    pending_offset_ = 0;
+    reset_chunks();
+    if (chunk_frame_)
+      av_frame_unref(chunk_frame_.get()); // Sized for the previous stream
+    seek_restart_sample_ = -1;
+    next_frame_sample_ = -1;
+    seek_drop_output_ = 0;
+    packet_index_.reset();
+    source_path_.clear();
+    index_timestamps_ = false;
+    input_eof_ = false;
     eof_reached_ = false;
     resampler_initialized_ = false;
+    reset_branches();
+  }
+
+  void SingleStreamDecoder::reset_branches()
+  {
+    for (auto &branch : branches_)
+    {
+      // Resamplers are set up again from the first frame (and reused when
+      // the format matches, as on reopen)
+      branch->metadata_ = metadata_;
+      branch->resampler_initialized_ = false;
+      av_frame_unref(branch->frame_.get());
+    }
+    branch_frames_.clear();
+  }
+
+  std::string SingleStreamDecoder::probe_sample_format(const AVCodecParameters *params,
+                                                      const AVCodec *codec)
+  {
+    if (params->format >= 0)
+      return av_get_sample_fmt_name(static_cast<AVSampleFormat>(params->format));
+
+    // The decoder's first supported format wide enough for the coded
+    // samples is what it would output by default
+    const void *configs = nullptr;
+    int count = 0;
+    if (avcodec_get_supported_config(nullptr, codec, AV_CODEC_CONFIG_SAMPLE_FORMAT, 0,
+                                     &configs, &count) < 0 || !configs)
+      return {};
+    const auto *formats = static_cast<const AVSampleFormat *>(configs);
+    for (int i = 0; i < count; ++i)
+    {
+      if (av_get_bytes_per_sample(formats[i]) * 8 >= params->bits_per_raw_sample)
+        return av_get_sample_fmt_name(formats[i]);
+    }
+    return av_get_sample_fmt_name(formats[0]);
   }
 
   void SingleStreamDecoder::setup_resampler(AVFrame *frame)
@@ -121,39 +458,212 @@ namespace avioflow
     int out_rate = options_.output_sample_rate.value_or(src_sample_rate);
     int out_channels = options_.output_num_channels.value_or(src_num_channels);
 
+    build_channel_matrix(src_num_channels);
     needs_resample_ = (src_sample_format != output_sample_format_) ||
                       (src_sample_rate != out_rate) ||
-                      (src_num_channels != out_channels);
+                      (src_num_channels != out_channels) || !channel_matrix_.empty();
 
-    if (needs_resample_)
+    // Format conversion and downmix without a rate change skip swresample
+    fast_convert_ = needs_resample_ && src_sample_rate == out_rate && !half_output_ &&
+                    init_fast_converter(frame, output_sample_format_, out_channels);
+    if (fast_convert_)
+      needs_resample_ = false;
+
+    premix_ = false;
+    use_polyphase_ = needs_resample_ && src_sample_rate != out_rate &&
+                     options_.resampler == Resampler::Polyphase &&
+                     setup_polyphase(frame, out_rate, out_channels);
+
+    if (needs_resample_ && !use_polyphase_)
     {
+      // With a channel selection, remix before resampling so that dropped
+      // channels are never filtered (swresample resamples every input
+      // channel first when the rate goes down)
+      premix_ = !channel_matrix_.empty() && src_sample_rate != out_rate &&
+                init_fast_converter(frame, AV_SAMPLE_FMT_FLTP, out_channels);
       AVChannelLayout out_ch_layout;
       av_channel_layout_default(&out_ch_layout, out_channels);
+      const AVChannelLayout &in_ch_layout = premix_ ? out_ch_layout : frame->ch_layout;
+      AVSampleFormat in_format = premix_ ? AV_SAMPLE_FMT_FLTP : src_sample_format;
+      if (premix_)
+        premix_planes_.resize(out_channels);
 
-      SwrContext *swr = nullptr;
-      check_av_error(
-          swr_alloc_set_opts2(&swr, &out_ch_layout, output_sample_format_,
-                              out_rate, &frame->ch_layout,
-                              src_sample_format, src_sample_rate, 0, nullptr),
-          "Could not initialize resampler");
+      if (!resampler_matches(in_ch_layout, in_format, src_sample_rate, out_rate, out_channels))
+      {
+        SwrContext *swr = nullptr;
+        check_av_error(
+            swr_alloc_set_opts2(&swr, &out_ch_layout, output_sample_format_,
+                                out_rate, &in_ch_layout,
+                                in_format, src_sample_rate, 0, nullptr),
+            "Could not initialize resampler");
+        swr_ctx_.reset(swr);
+
+        bool use_soxr = options_.resampler_quality.soxr && soxr_available();
+        if (options_.resampler_quality.soxr && !use_soxr)
+          av_log(nullptr, AV_LOG_WARNING, "FFmpeg is built without libsoxr, using swresample's engine\n");
+        apply_resampler_settings(swr, resampler_settings_, use_soxr);
+        if (!channel_matrix_.empty() && !premix_)
+          check_av_error(swr_set_matrix(swr, channel_matrix_.data(), src_num_channels),
+                         "Could not set channel matrix");
+      }
+      av_channel_layout_uninit(&out_ch_layout);
 
-      swr_ctx_.reset(swr);
+      // (Re-)initializing an existing context only resets its state and
+      // keeps the filter bank
       check_av_error(swr_init(swr_ctx_.get()),
                      "Could not initialize resampler context");
 
-      av_channel_layout_uninit(&out_ch_layout);
+      // A seek issued before the first frame still has output to discard
+      if (seek_drop_output_ > 0)
+        swr_drop_output(swr_ctx_.get(), static_cast<int>(seek_drop_output_));
     }
+    seek_drop_output_ = 0;
 
+    bool planar = options_.output_layout == SampleLayout::Planar;
+    output_planes_ = planar ? out_channels : 1;
+    plane_elements_ = planar ? 1 : out_channels;
+    dst_planes_.assign(output_planes_, nullptr);
+    if (half_output_)
+    {
+      half_staging_.resize(static_cast<size_t>(kHalfStagingSamples) * out_channels);
+      staging_planes_.resize(output_planes_);
+      for (int p = 0; p < output_planes_; ++p)
+        staging_planes_[p] = reinterpret_cast<uint8_t *>(half_staging_.data() + p * kHalfStagingSamples);
+    }
     resampler_initialized_ = true;
   }
 
+  void SingleStreamDecoder::build_channel_matrix(int in_channels)
+  {
+    // Row-major, one row of in_channels coefficients per output channel
+    channel_matrix_.clear();
+    if (!options_.channel_indices.empty())
+    {
+      channel_matrix_.assign(options_.channel_indices.size() * in_channels, 0.0);
+      for (size_t c = 0; c < options_.channel_indices.size(); ++c)
+      {
+        int index = options_.channel_indices[c];
+        if (index >= in_channels)
+          throw std::invalid_argument("channel_indices: input has only " + std::to_string(in_channels) +
+                                      " channels");
+        channel_matrix_[c * in_channels + index] = 1.0;
+      }
+    }
+    for (const auto &row : options_.mix_matrix)
+    {
+      if (row.size() != static_cast<size_t>(in_channels))
+        throw std::invalid_argument("mix_matrix: rows need one coefficient per input channel (" +
+                                    std::to_string(in_channels) + ")");
+      channel_matrix_.insert(channel_matrix_.end(), row.begin(), row.end());
+    }
+  }
+
+  bool SingleStreamDecoder::init_fast_converter(const AVFrame *frame, AVSampleFormat out_format, int out_channels)
+  {
+    auto in_format = static_cast<AVSampleFormat>(frame->format);
+    if (channel_matrix_.empty())
+      return fast_converter_.init(in_format, frame->ch_layout, out_format, out_channels);
+    return fast_converter_.init(in_format, frame->ch_layout, out_format, channel_matrix_, out_channels);
+  }
+
+  bool SingleStreamDecoder::setup_polyphase(AVFrame *frame, int out_rate, int out_channels)
+  {
+    // Float output only; S16 keeps swresample's conversion and dithering
+    if (output_sample_format_ != AV_SAMPLE_FMT_FLT && output_sample_format_ != AV_SAMPLE_FMT_FLTP)
+      return false;
+    if (!PolyphaseResampler::supports(frame->sample_rate, out_rate))
+      return false;
+
+    // Planar float input with the output channels is filtered in place;
+    // anything else goes through the fast converter first
+    AVChannelLayout out_layout;
+    av_channel_layout_default(&out_layout, out_channels);
+    bool direct = frame->format == AV_SAMPLE_FMT_FLTP && channel_matrix_.empty() &&
+                  (frame->ch_layout.order == AV_CHANNEL_ORDER_UNSPEC
+                       ? frame->ch_layout.nb_channels == out_channels
+                       : av_channel_layout_compare(&frame->ch_layout, &out_layout) == 0);
+    av_channel_layout_uninit(&out_layout);
+    if (!direct && !init_fast_converter(frame, AV_SAMPLE_FMT_FLTP, out_channels))
+      return false;
+    premix_ = !direct;
+
+    PolyphaseDesign design;
+    design.filter_size = resampler_settings_.filter_size;
+    design.cutoff = resampler_settings_.cutoff;
+    design.kaiser_beta = resampler_settings_.kaiser_beta;
+    if (polyphase_.matches(frame->sample_rate, out_rate, out_channels, design))
+      polyphase_.reset();
+    else
+      polyphase_.init(frame->sample_rate, out_rate, out_channels, design);
+    if (seek_drop_output_ > 0)
+      polyphase_.drop_output(seek_drop_output_);
+    premix_planes_.resize(out_channels);
+    polyphase_dst_.resize(out_channels);
+    return true;
+  }
+
+  int64_t SingleStreamDecoder::resample(uint8_t *const *dst, int64_t capacity,
+                                        const uint8_t **src, int src_samples)
+  {
+    const uint8_t **input = src;
+    if (src_samples > 0 && premix_)
+    {
+      size_t channels = premix_planes_.size();
+      if (premix_input_.size() < channels * src_samples)
+        premix_input_.resize(channels * src_samples);
+      for (size_t c = 0; c < channels; ++c)
+        premix_planes_[c] = reinterpret_cast<const uint8_t *>(premix_input_.data() + c * src_samples);
+      fast_converter_.convert(src, 0, const_cast<uint8_t *const *>(premix_planes_.data()), 0, src_samples);
+      input = premix_planes_.data();
+    }
+
+    if (!use_polyphase_)
+      return swr_convert(swr_ctx_.get(), dst, static_cast<int>(std::min<int64_t>(capacity, INT_MAX)),
+                         input, src_samples);
+
+    // Interleaved output: channel c starts at element c, one frame apart
+    bool planar = output_sample_format_ == AV_SAMPLE_FMT_FLTP;
+    ptrdiff_t stride = planar ? 1 : static_cast<ptrdiff_t>(polyphase_dst_.size());
+    for (size_t c = 0; c < polyphase_dst_.size(); ++c)
+      polyphase_dst_[c] = planar ? reinterpret_cast<float *>(dst[c]) : reinterpret_cast<float *>(dst[0]) + c;
+    return polyphase_.convert(polyphase_dst_.data(), stride, capacity,
+                              src_samples > 0 ? reinterpret_cast<const float *const *>(input) : nullptr,
+                              src_samples);
+  }
+
+  bool SingleStreamDecoder::resampler_matches(const AVChannelLayout &in_ch_layout, AVSampleFormat in_format,
+                                              int in_sample_rate, int out_rate, int out_channels) const
+  {
+    if (!swr_ctx_)
+      return false;
+
+    int64_t in_rate = 0, swr_out_rate = 0;
+    AVSampleFormat in_fmt = AV_SAMPLE_FMT_NONE, out_fmt = AV_SAMPLE_FMT_NONE;
+    AVChannelLayout in_layout{}, out_layout{};
+    bool match = av_opt_get_int(swr_ctx_.get(), "in_sample_rate", 0, &in_rate) >= 0 &&
+                 av_opt_get_int(swr_ctx_.get(), "out_sample_rate", 0, &swr_out_rate) >= 0 &&
+                 av_opt_get_sample_fmt(swr_ctx_.get(), "in_sample_fmt", 0, &in_fmt) >= 0 &&
+                 av_opt_get_sample_fmt(swr_ctx_.get(), "out_sample_fmt", 0, &out_fmt) >= 0 &&
+                 av_opt_get_chlayout(swr_ctx_.get(), "in_chlayout", 0, &in_layout) >= 0 &&
+                 av_opt_get_chlayout(swr_ctx_.get(), "out_chlayout", 0, &out_layout) >= 0;
+    match = match && in_rate == in_sample_rate && swr_out_rate == out_rate &&
+            in_fmt == in_format && out_fmt == output_sample_format_ &&
+            av_channel_layout_compare(&in_layout, &in_ch_layout) == 0 &&
+            out_layout.nb_channels == out_channels;
+    av_channel_layout_uninit(&in_layout);
+    av_channel_layout_uninit(&out_layout);
+    return match;
+  }
+
   int SingleStreamDecoder::calculate_output_samples(int src_samples,
                                                     int src_rate,
                                                     int dst_rate) const
   {
     if (src_rate == dst_rate)
       return src_samples;
-    int64_t delay = swr_ctx_ ? swr_get_delay(swr_ctx_.get(), src_rate) : 0;
+    int64_t delay = use_polyphase_ ? polyphase_.delay()
+                    : swr_ctx_     ? swr_get_delay(swr_ctx_.get(), src_rate)
+                                   : 0;
     return static_cast<int>(av_rescale_rnd(
         delay + src_samples, dst_rate, src_rate, AV_ROUND_UP));
   }
@@ -163,6 +673,7 @@ namespace avioflow
     if (!resampler_initialized_)
       setup_resampler(frame_.get());
 
+    AVFrame *output = frame_.get();
     if (needs_resample_)
     {
       int out_rate = options_.output_sample_rate.value_or(frame_->sample_rate);
@@ -175,11 +686,10 @@ namespace avioflow
       av_channel_layout_default(&converted_frame_->ch_layout, out_channels);
       converted_frame_->nb_samples = out_samples;
 
-      check_av_error(av_frame_get_buffer(converted_frame_.get(), 0),
-                     "Could not allocate converted frame buffer");
+      converted_pool_.get_buffer(converted_frame_.get());
 
-      int converted = swr_convert(
-          swr_ctx_.get(), converted_frame_->data, out_samples,
+      int64_t converted = resample(
+          converted_frame_->extended_data, out_samples,
           const_cast<const uint8_t **>(frame_->extended_data),
           frame_->nb_samples);
 
@@ -189,64 +699,91 @@ namespace avioflow
         throw std::runtime_error("Error during resampling");
       }
 
-      converted_frame_->nb_samples = converted;
-      return converted_frame_.get();
+      converted_frame_->nb_samples = static_cast<int>(converted);
+      output = converted_frame_.get();
     }
-    else
+    else if (fast_convert_)
+    {
+      av_frame_unref(converted_frame_.get());
+      converted_frame_->format = output_sample_format_;
+      converted_frame_->sample_rate = frame_->sample_rate;
+      av_channel_layout_default(&converted_frame_->ch_layout,
+                                options_.output_num_channels.value_or(frame_->ch_layout.nb_channels));
+      converted_frame_->nb_samples = frame_->nb_samples;
+      converted_pool_.get_buffer(converted_frame_.get());
+      fast_converter_.convert(frame_->extended_data, 0, converted_frame_->extended_data, 0,
+                              frame_->nb_samples);
+      output = converted_frame_.get();
+    }
+    if (!half_output_)
+      return output;
+
+    // F16: the 16-bit integer format of the same layout serves as container
+    av_frame_unref(half_frame_.get());
+    half_frame_->format = av_sample_fmt_is_planar(output_sample_format_) ? AV_SAMPLE_FMT_S16P
+                                                                         : AV_SAMPLE_FMT_S16;
+    half_frame_->sample_rate = output->sample_rate;
+    check_av_error(av_channel_layout_copy(&half_frame_->ch_layout, &output->ch_layout),
+                   "Could not copy channel layout");
+    half_frame_->nb_samples = output->nb_samples;
+    if (output->nb_samples > 0)
     {
-      return frame_.get();
+      half_pool_.get_buffer(half_frame_.get());
+      copy_output(output->extended_data, 0, half_frame_->extended_data, 0, output->nb_samples);
     }
+    return half_frame_.get();
   }
 
-  AVFrame *SingleStreamDecoder::decode_next()
+  bool SingleStreamDecoder::read_raw_frame()
   {
 #ifdef AVIOFLOW_HAS_WASAPI
     if (is_wasapi_mode_)
     {
-      // Prepare a buffer for capture (e.g., 512 frames)
+      // Capture up to 512 frames straight into a pooled frame buffer
       const int target_frames = 512;
       int bytes_per_sample = 4; // f32
       int channels = wasapi_handler_->get_num_channels();
-      int buf_size = target_frames * channels * bytes_per_sample;
-      
-      std::vector<uint8_t> tmp_buf(buf_size);
-      int read_bytes = wasapi_handler_->read(tmp_buf.data(), buf_size);
-      
-      if (read_bytes <= 0) return nullptr; // No data yet
 
-      int read_frames = read_bytes / (channels * bytes_per_sample);
-      
-      // Wrap into frame_
       av_frame_unref(frame_.get());
       frame_->format = AV_SAMPLE_FMT_FLT; // miniaudio f32 is interleaved
       frame_->sample_rate = wasapi_handler_->get_sample_rate();
       av_channel_layout_default(&frame_->ch_layout, channels);
-      frame_->nb_samples = read_frames;
-      
-      check_av_error(av_frame_get_buffer(frame_.get(), 0), "Could not allocate frame buffer");
-      std::memcpy(frame_->data[0], tmp_buf.data(), read_bytes);
-      
-      AVFrame* decoded = process_decoded_frame();
-      if (decoded) {
-          total_samples_decoded_ += decoded->nb_samples;
-          metadata_.num_samples = total_samples_decoded_;
+      frame_->nb_samples = target_frames;
+      capture_pool_.get_buffer(frame_.get());
+
+      int read_bytes = wasapi_handler_->read(frame_->data[0], target_frames * channels * bytes_per_sample);
+      if (read_bytes <= 0)
+      {
+        av_frame_unref(frame_.get());
+        return false; // No data yet
       }
-      return decoded;
+      frame_->nb_samples = read_bytes / (channels * bytes_per_sample);
+
+      total_samples_decoded_ += frame_->nb_samples;
+      metadata_.num_samples = total_samples_decoded_;
+      return true;
     }
 #endif
 
+    if (options_.probe_only)
+      throw std::runtime_error("Cannot decode: decoder was opened with probe_only");
+
+    if (eof_reached_)
+      return false;
+
     while (true)
     {
       // 1. Try to receive frame from decoder first (drain output)
       int ret = avcodec_receive_frame(codec_ctx_.get(), frame_.get());
       if (ret >= 0)
       {
-        // Got a frame, process and update total samples
-        AVFrame* decoded = process_decoded_frame();
-        if (decoded) {
-            total_samples_decoded_ += decoded->nb_samples;
+        if (seek_restart_sample_ >= 0 && !trim_after_seek())
+        {
+          av_frame_unref(frame_.get());
+          continue; // Pre-roll frame entirely before the seek target
         }
-        return decoded;
+        total_samples_decoded_ += frame_->nb_samples;
+        return true;
       }
       
       // If fully drained (no more frames from codec)
@@ -258,7 +795,7 @@ namespace avioflow
             metadata_.duration = static_cast<double>(total_samples_decoded_) / codec_ctx_->sample_rate;
         }
         eof_reached_ = true;  // Mark as truly finished
-        return nullptr;
+        return false;
       }
       else if (ret < 0 && ret != AVERROR(EAGAIN))
       {
@@ -267,7 +804,7 @@ namespace avioflow
 
       // 2. Need more input: Read packet from source
       // If input has ended, send NULL packet to drain codec
-      if (eof_reached_)
+      if (input_eof_)
       {
         ret = avcodec_send_packet(codec_ctx_.get(), nullptr);
         if (ret < 0 && ret != AVERROR_EOF)
@@ -275,14 +812,31 @@ namespace avioflow
         continue;
       }
 
+      if (input_gate_)
+      {
+        if (!input_gate_(fmt_ctx_->pb->buf_end - fmt_ctx_->pb->buf_ptr, gate_lookahead_))
+          return false; // Not enough input buffered for a whole packet
+        gate_lookahead_ = 0;
+        // A packet larger than the gate allowed for ran the input dry and
+        // left AVIO at EOF; it may read again now
+        fmt_ctx_->pb->eof_reached = 0;
+        fmt_ctx_->pb->error = 0;
+      }
+
       ret = av_read_frame(fmt_ctx_.get(), packet_.get());
       if (ret < 0)
       {
         if (ret == AVERROR(EAGAIN))
-          return nullptr; // No data currently available
-        
+        {
+          // No data currently available. AVIO keeps the error (and EOF
+          // flag) set; clear them so the next call asks the callback again
+          fmt_ctx_->pb->eof_reached = 0;
+          fmt_ctx_->pb->error = 0;
+          return false;
+        }
+
         if (ret == AVERROR_EOF) {
-          eof_reached_ = true;
+          input_eof_ = true;
           continue;
         }
         
@@ -295,6 +849,10 @@ namespace avioflow
         continue;
       }
 
+      // After an index byte seek the demuxer's timestamps restart at zero
+      if (index_timestamps_)
+        packet_index_->restore_packet(packet_.get(), fmt_ctx_->streams[audio_stream_index_]);
+
       ret = avcodec_send_packet(codec_ctx_.get(), packet_.get());
       av_packet_unref(packet_.get());
       if (ret < 0 && ret != AVERROR(EAGAIN))
@@ -304,12 +862,475 @@ namespace avioflow
     }
   }
 
+  void SingleStreamDecoder::seek(double seconds)
+  {
+    int out_rate = options_.output_sample_rate.value_or(metadata_.sample_rate);
+    seek_to_sample(std::llround(std::max(0.0, seconds) * out_rate));
+  }
+
+  void SingleStreamDecoder::seek_to_sample(int64_t sample)
+  {
+    if (options_.probe_only)
+      throw std::runtime_error("Cannot seek: decoder was opened with probe_only");
+    if (!fmt_ctx_ || !codec_ctx_)
+      throw std::runtime_error("Seeking requires an opened file, memory or stream source");
+    if (!fmt_ctx_->pb || !(fmt_ctx_->pb->seekable & AVIO_SEEKABLE_NORMAL))
+      throw std::runtime_error("Source is not seekable");
+    if (!branches_.empty())
+      throw std::runtime_error("Seeking is not supported with output branches");
+
+    AVStream *stream = fmt_ctx_->streams[audio_stream_index_];
+    int in_rate = codec_ctx_->sample_rate;
+    int out_rate = options_.output_sample_rate.value_or(in_rate);
+    sample = std::max<int64_t>(sample, 0);
+
+    // Restart the resampler on a source sample that maps to an integer output
+    // sample, so output indices stay on the same grid as a decode from the
+    // start. Starting a little early lets the filter history settle.
+    int64_t restart_sample = sample;
+    int64_t drop_output = 0;
+    if (in_rate != out_rate)
+    {
+      int64_t gcd = std::gcd(in_rate, out_rate);
+      int64_t in_step = in_rate / gcd;
+      int64_t out_step = out_rate / gcd;
+      int64_t warmup = av_rescale(kResamplerWarmupSamples, out_rate, in_rate);
+      int64_t k = std::max<int64_t>(sample - warmup, 0) / out_step;
+      restart_sample = k * in_step;
+      drop_output = sample - k * out_step;
+    }
+
+    // Land before the restart point so the codec can rebuild its state
+    // (MDCT overlap, bit reservoir, Opus pre-roll) before samples are kept
+    int64_t preroll = std::max<int64_t>(
+        stream->codecpar->seek_preroll,
+        static_cast<int64_t>(kPrerollFrames) * std::max(stream->codecpar->frame_size, 0));
+    seek_demuxer(std::max<int64_t>(restart_sample - preroll, 0));
+
+    avcodec_flush_buffers(codec_ctx_.get());
+    if (resampler_initialized_ && use_polyphase_)
+    {
+      polyphase_.reset();
+      polyphase_.drop_output(drop_output);
+      seek_drop_output_ = 0;
+    }
+    else if (resampler_initialized_ && swr_ctx_)
+    {
+      // Re-initializing resets the filter state (the filter bank is reused)
+      check_av_error(swr_init(swr_ctx_.get()), "Could not reset resampler");
+      if (drop_output > 0)
+        swr_drop_output(swr_ctx_.get(), static_cast<int>(drop_output));
+      seek_drop_output_ = 0;
+    }
+    else
+    {
+      seek_drop_output_ = drop_output;
+    }
+
+    ++frame_generation_;
+    pending_offset_ = 0;
+    reset_chunks();
+    input_eof_ = false;
+    eof_reached_ = false;
+    seek_restart_sample_ = restart_sample;
+    next_frame_sample_ = -1;
+    total_samples_decoded_ = restart_sample;
+  }
+
+  void SingleStreamDecoder::seek_demuxer(int64_t sample)
+  {
+    AVStream *stream = fmt_ctx_->streams[audio_stream_index_];
+    int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    AVRational sample_tb{1, codec_ctx_->sample_rate};
+
+    // With a packet index, jump straight to the packet holding `sample`
+    const PacketIndexEntry *entry = packet_index_ ? packet_index_->find_by_sample(sample) : nullptr;
+    if (entry && entry->pos >= 0 && !(fmt_ctx_->iformat->flags & AVFMT_NO_BYTE_SEEK))
+    {
+      check_av_error(av_seek_frame(fmt_ctx_.get(), audio_stream_index_, entry->pos, AVSEEK_FLAG_BYTE),
+                     "Could not seek to indexed packet");
+      index_timestamps_ = true;
+      return;
+    }
+
+    index_timestamps_ = false;
+    int64_t ts = start_time + av_rescale_q(entry ? entry->sample : sample, sample_tb, stream->time_base);
+    check_av_error(avformat_seek_file(fmt_ctx_.get(), audio_stream_index_,
+                                      INT64_MIN, ts, ts, 0),
+                   "Could not seek");
+  }
+
+  bool SingleStreamDecoder::trim_after_seek()
+  {
+    // Source position of this frame: prefer timestamps, otherwise continue
+    // from the previous frame after the seek
+    int64_t position = next_frame_sample_ >= 0 ? next_frame_sample_ : seek_restart_sample_;
+    int64_t pts = frame_->best_effort_timestamp;
+    if (pts != AV_NOPTS_VALUE)
+    {
+      AVStream *stream = fmt_ctx_->streams[audio_stream_index_];
+      int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+      position = av_rescale_q(pts - start_time, stream->time_base,
+                              AVRational{1, frame_->sample_rate});
+    }
+
+    next_frame_sample_ = position + frame_->nb_samples;
+    if (next_frame_sample_ <= seek_restart_sample_)
+      return false;
+
+    int64_t skip = seek_restart_sample_ - position;
+    if (skip > 0)
+    {
+      // Drop the leading samples by advancing the data pointers in place
+      int bytes_per_sample = av_get_bytes_per_sample(static_cast<AVSampleFormat>(frame_->format));
+      int channels = frame_->ch_layout.nb_channels;
+      if (av_sample_fmt_is_planar(static_cast<AVSampleFormat>(frame_->format)))
+      {
+        for (int c = 0; c < channels; ++c)
+          frame_->extended_data[c] += skip * bytes_per_sample;
+      }
+      else
+      {
+        frame_->extended_data[0] += skip * bytes_per_sample * channels;
+      }
+      frame_->nb_samples -= static_cast<int>(skip);
+    }
+
+    seek_restart_sample_ = -1;
+    return true;
+  }
+
+  AVFrame *SingleStreamDecoder::decode_next()
+  {
+    return chunk_samples_ > 0 ? decode_chunk() : decode_frame();
+  }
+
+  AVFrame *SingleStreamDecoder::decode_frame()
+  {
+    ++frame_generation_;
+    pending_offset_ = 0;
+
+    if (!read_raw_frame())
+      return nullptr;
+    return process_decoded_frame();
+  }
+
+  const std::vector<AVFrame *> &SingleStreamDecoder::decode_next_branches()
+  {
+    if (branches_.empty())
+      throw std::runtime_error("No output branches configured");
+
+    ++frame_generation_;
+    pending_offset_ = 0;
+    branch_frames_.clear();
+    if (!read_raw_frame())
+      return branch_frames_;
+
+    // Each branch converts its own reference to the decoded frame
+    for (auto &branch : branches_)
+    {
+      av_frame_unref(branch->frame_.get());
+      check_av_error(av_frame_ref(branch->frame_.get(), frame_.get()), "Could not reference decoded frame");
+      branch_frames_.push_back(branch->process_decoded_frame());
+    }
+    return branch_frames_;
+  }
+
+  std::vector<AudioBuffer> SingleStreamDecoder::decode_all_branches()
+  {
+    std::vector<AudioBuffer> results(branches_.size());
+    while (!eof_reached_)
+    {
+      const auto &frames = decode_next_branches();
+      if (frames.empty())
+        break;
+
+      for (size_t i = 0; i < frames.size(); ++i)
+      {
+        const AVFrame *f = frames[i];
+        const SingleStreamDecoder &branch = *branches_[i];
+        if (results[i].num_channels() == 0)
+        {
+          results[i] = AudioBuffer(f->ch_layout.nb_channels,
+                                   std::max<int64_t>(branch.estimate_total_output_samples(), f->nb_samples),
+                                   f->sample_rate, branch.output_format(), branch.output_layout());
+        }
+        results[i].append(f->extended_data, f->nb_samples);
+      }
+    }
+    return results;
+  }
+
+  void SingleStreamDecoder::reset_chunks()
+  {
+    chunk_filled_ = 0;
+    chunk_fresh_ = 0;
+    chunk_skip_ = 0;
+    chunk_returned_ = false;
+    chunk_finished_ = false;
+  }
+
+  AVFrame *SingleStreamDecoder::decode_chunk()
+  {
+    ++frame_generation_;
+    if (chunk_finished_)
+      return nullptr;
+
+    AVFrame *chunk = chunk_frame_.get();
+    int64_t sample_bytes = static_cast<int64_t>(bytes_per_sample(options_.output_sample_format));
+    bool planar = options_.output_layout == SampleLayout::Planar;
+    if (!chunk->buf[0])
+    {
+      // Sized once from the stream; F16 uses the 16-bit integer format as
+      // container, like half_frame_
+      int channels = output_channels();
+      if (half_output_)
+        chunk->format = planar ? AV_SAMPLE_FMT_S16P : AV_SAMPLE_FMT_S16;
+      else
+        chunk->format = output_sample_format_;
+      chunk->sample_rate = options_.output_sample_rate.value_or(metadata_.sample_rate);
+      av_channel_layout_default(&chunk->ch_layout, channels);
+      chunk->nb_samples = chunk_samples_;
+      chunk_pool_.get_buffer(chunk);
+    }
+    int channels = chunk->ch_layout.nb_channels;
+    int planes = planar ? channels : 1;
+    int64_t frame_bytes = sample_bytes * (planar ? 1 : channels);
+
+    // Advance by the hop past the chunk returned last time
+    if (chunk_returned_)
+    {
+      int64_t keep = std::max<int64_t>(chunk_filled_ - hop_samples_, 0);
+      AVFrame *next = chunk;
+      if (!av_frame_is_writable(chunk))
+      {
+        // The returned chunk is still referenced (e.g. queued by a
+        // prefetcher): continue in a fresh pooled buffer
+        next = chunk_spare_.get();
+        av_frame_unref(next);
+        next->format = chunk->format;
+        next->sample_rate = chunk->sample_rate;
+        check_av_error(av_channel_layout_copy(&next->ch_layout, &chunk->ch_layout),
+                       "Could not copy channel layout");
+        next->nb_samples = chunk_samples_;
+        chunk_pool_.get_buffer(next);
+      }
+      for (int p = 0; p < planes; ++p)
+        std::memmove(next->extended_data[p], chunk->extended_data[p] + (chunk_filled_ - keep) * frame_bytes,
+                     keep * frame_bytes);
+      if (next != chunk)
+      {
+        av_frame_unref(chunk);
+        av_frame_move_ref(chunk, next);
+      }
+      chunk_skip_ += std::max<int64_t>(hop_samples_ - chunk_filled_, 0);
+      chunk_filled_ = keep;
+      chunk_fresh_ = 0;
+      chunk_returned_ = false;
+    }
+    while (chunk_skip_ > 0)
+    {
+      int64_t skipped = decode_into_at(chunk->extended_data, 0, std::min<int64_t>(chunk_skip_, chunk_samples_));
+      if (skipped == 0)
+        break;
+      chunk_skip_ -= skipped;
+    }
+
+    if (chunk_skip_ == 0)
+    {
+      int64_t decoded = decode_into_at(chunk->extended_data, chunk_filled_, chunk_samples_ - chunk_filled_);
+      chunk_filled_ += decoded;
+      chunk_fresh_ += decoded;
+    }
+    if (resampler_initialized_ && output_planes_ != planes)
+      throw std::runtime_error("Chunked output: channel count changed within the stream");
+
+    if (chunk_filled_ < chunk_samples_)
+    {
+      if (!eof_reached_)
+        return nullptr; // No data currently available
+      chunk_finished_ = true;
+      if (chunk_fresh_ == 0)
+        return nullptr;
+      if (options_.chunk_tail == ChunkTail::Pad)
+      {
+        for (int p = 0; p < planes; ++p)
+          std::memset(chunk->extended_data[p] + chunk_filled_ * frame_bytes, 0,
+                      (chunk_samples_ - chunk_filled_) * frame_bytes);
+      }
+    }
+
+    chunk->nb_samples = static_cast<int>(
+        options_.chunk_tail == ChunkTail::Pad ? chunk_samples_ : chunk_filled_);
+    chunk_returned_ = true;
+    return chunk;
+  }
+
+  uint8_t **SingleStreamDecoder::offset_planes(uint8_t *const *dst, int64_t offset)
+  {
+    int64_t sample_bytes = static_cast<int64_t>(plane_elements_) *
+                           bytes_per_sample(options_.output_sample_format);
+    for (size_t p = 0; p < dst_planes_.size(); ++p)
+      dst_planes_[p] = dst[p] + offset * sample_bytes;
+    return dst_planes_.data();
+  }
+
+  void SingleStreamDecoder::copy_output(const uint8_t *const *src, int64_t src_offset,
+                                        uint8_t *const *dst, int64_t dst_offset, int64_t count)
+  {
+    // src is in the resampler's output format, dst in the requested one;
+    // they only differ for F16 output. With the fast converter, src is the
+    // decoded frame.
+    if (fast_convert_)
+    {
+      fast_converter_.convert(src, src_offset, dst, dst_offset, count);
+      return;
+    }
+    size_t elements = static_cast<size_t>(count * plane_elements_);
+    int64_t src_bytes = av_get_bytes_per_sample(output_sample_format_);
+    int64_t dst_bytes = bytes_per_sample(options_.output_sample_format);
+    for (int p = 0; p < output_planes_; ++p)
+    {
+      const uint8_t *in = src[p] + src_offset * plane_elements_ * src_bytes;
+      uint8_t *out = dst[p] + dst_offset * plane_elements_ * dst_bytes;
+      if (half_output_)
+        convert_float_to_half(reinterpret_cast<const float *>(in),
+                              reinterpret_cast<uint16_t *>(out), elements);
+      else
+        std::memcpy(out, in, elements * src_bytes);
+    }
+  }
+
+  int64_t SingleStreamDecoder::convert_into(uint8_t *const *dst, int64_t capacity,
+                                            const uint8_t **src, int src_samples)
+  {
+    if (!half_output_)
+    {
+      int64_t converted = resample(dst, capacity, src, src_samples);
+      if (converted < 0)
+        throw std::runtime_error("Error during resampling");
+      return converted;
+    }
+
+    // F16: resample into the float staging buffer, convert chunk by chunk
+    const uint8_t *no_input[AV_NUM_DATA_POINTERS] = {};
+    int64_t written = 0;
+    while (written < capacity)
+    {
+      int chunk = static_cast<int>(std::min<int64_t>(capacity - written, kHalfStagingSamples));
+      int64_t converted = resample(staging_planes_.data(), chunk, src, src_samples);
+      if (converted < 0)
+        throw std::runtime_error("Error during resampling");
+      copy_output(staging_planes_.data(), 0, dst, written, converted);
+      written += converted;
+      if (converted < chunk)
+        break;
+      // The input went in with the first call; later calls drain buffered output
+      src = no_input;
+      src_samples = 0;
+    }
+    return written;
+  }
+
+  int64_t SingleStreamDecoder::drain_pending(uint8_t *const *dst, int64_t offset, int64_t capacity)
+  {
+    if (capacity <= 0 || !resampler_initialized_)
+      return 0;
+
+    if (needs_resample_)
+    {
+      // Pull output the resampler buffered when a previous call ran out of space.
+      // A non-null input with zero samples drains without flushing the filter.
+      const uint8_t *no_input[AV_NUM_DATA_POINTERS] = {};
+      return convert_into(offset_planes(dst, offset), capacity, no_input, 0);
+    }
+
+    // Copy what is left of frame_ (already in the output format)
+    if (pending_offset_ == 0)
+      return 0;
+    int64_t count = std::min<int64_t>(frame_->nb_samples - pending_offset_, capacity);
+    copy_output(frame_->extended_data, pending_offset_, dst, offset, count);
+    pending_offset_ += count;
+    if (pending_offset_ >= frame_->nb_samples)
+      pending_offset_ = 0;
+    return count;
+  }
+
+  int64_t SingleStreamDecoder::decode_into_at(uint8_t *const *dst, int64_t offset, int64_t capacity)
+  {
+    ++frame_generation_; // frame_ is overwritten below
+
+    int64_t written = drain_pending(dst, offset, capacity);
+    while (written < capacity)
+    {
+      if (!read_raw_frame())
+        break;
+      if (!resampler_initialized_)
+        setup_resampler(frame_.get());
+
+      int64_t remaining = capacity - written;
+      uint8_t **planes = offset_planes(dst, offset + written);
+      if (needs_resample_)
+      {
+        // Resample straight into the caller's memory; input that does not
+        // fit stays buffered inside the SwrContext for the next call
+        written += convert_into(planes, remaining,
+                                const_cast<const uint8_t **>(frame_->extended_data),
+                                frame_->nb_samples);
+      }
+      else
+      {
+        int64_t count = std::min<int64_t>(frame_->nb_samples, remaining);
+        copy_output(frame_->extended_data, 0, planes, 0, count);
+        written += count;
+        pending_offset_ = count < frame_->nb_samples ? count : 0;
+      }
+    }
+    return written;
+  }
+
+  int64_t SingleStreamDecoder::decode_into(uint8_t *const *dst, int64_t capacity)
+  {
+    return decode_into_at(dst, 0, capacity);
+  }
+
+  int64_t SingleStreamDecoder::decode_all_into(uint8_t *const *dst, int64_t capacity)
+  {
+    int64_t written = 0;
+    while (written < capacity && !eof_reached_)
+    {
+      int64_t count = decode_into_at(dst, written, capacity - written);
+      if (count == 0)
+        break; // EOF, or no data currently available
+      written += count;
+    }
+    return written;
+  }
+
+  int64_t SingleStreamDecoder::estimate_total_output_samples() const
+  {
+    if (metadata_.num_samples <= 0 || metadata_.sample_rate <= 0)
+      return 0;
+
+    // Duration-derived counts are estimates (e.g. Xing headers, bitrate),
+    // so leave some headroom to avoid the growth fallback in the common case
+    int out_rate = options_.output_sample_rate.value_or(metadata_.sample_rate);
+    return av_rescale_rnd(metadata_.num_samples, out_rate, metadata_.sample_rate,
+                          AV_ROUND_UP) + AudioBuffer::kHeadroomSamples;
+  }
+
   AudioSamples SingleStreamDecoder::get_all_samples()
   {
+    if (options_.output_sample_format != SampleFormat::F32 ||
+        options_.output_layout != SampleLayout::Planar)
+      throw std::runtime_error("AudioSamples holds planar float32; use decode_all() for other "
+                               "output formats or layouts");
+
     AudioSamples result;
-    while (!is_finished())
+    int64_t estimated_samples = estimate_total_output_samples();
+    while (!eof_reached_)
     {
-      auto *f = decode_next();
+      auto *f = decode_frame();
       if (!f)
         break;
 
@@ -317,11 +1338,13 @@ namespace avioflow
       {
         result.sample_rate = f->sample_rate;
         result.data.resize(f->ch_layout.nb_channels);
+        for (auto &channel : result.data)
+          channel.reserve(static_cast<size_t>(estimated_samples));
       }
 
       for (int c = 0; c < f->ch_layout.nb_channels; ++c)
       {
-        const float *channel_data = reinterpret_cast<const float *>(f->data[c]);
+        const float *channel_data = reinterpret_cast<const float *>(f->extended_data[c]);
         result.data[c].insert(result.data[c].end(), channel_data,
                               channel_data + f->nb_samples);
       }
@@ -329,4 +1352,25 @@ namespace avioflow
     return result;
   }
 
+  AudioBuffer SingleStreamDecoder::decode_all()
+  {
+    AudioBuffer result;
+    while (!eof_reached_)
+    {
+      auto *f = decode_frame();
+      if (!f)
+        break;
+
+      if (result.num_channels() == 0)
+      {
+        result = AudioBuffer(f->ch_layout.nb_channels,
+                             std::max<int64_t>(estimate_total_output_samples(), f->nb_samples),
+                             f->sample_rate, options_.output_sample_format, options_.output_layout);
+      }
+
+      result.append(f->extended_data, f->nb_samples);
+    }
+    return result;
+  }
+
 } // namespace avioflow
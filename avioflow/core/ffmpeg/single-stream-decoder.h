@@ -3,12 +3,20 @@
 
 #include "ffmpeg-common.h"
 #include "metadata.h"
+#include "packet-index.h"
+#include "audio-buffer.h"
+#include "fast-converter.h"
+#include "frame-pool.h"
+#include "resampler-quality.h"
+#include "../utils/polyphase-resampler.h"
 #ifdef AVIOFLOW_HAS_WASAPI
 #include "wasapi-handler.h"
 #endif
 #include <optional>
 #include <string>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace avioflow
 {
@@ -23,50 +31,237 @@ namespace avioflow
     void open(const std::string &source);
 
     // Open from memory buffer (e.g., raw encoded audio data with header)
-    void open_memory(const uint8_t *data, size_t size);
+    // The data is not copied; `owner` (if any) keeps it alive while open
+    void open_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner = nullptr);
+
+    // Like open() / open_memory(), for decoding many sources in a row.
+    // Keeps the codec context (flushed instead of freed) when the new stream
+    // has the same codec parameters, and the resampler when the input and
+    // output formats match, instead of setting both up from scratch.
+    void reopen(const std::string &source);
+    void reopen_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner = nullptr);
  
     // Initialize for incremental byte streams with a read callback
     // The callback should return: >0 (bytes read), 0 (EOF), <0 (no data available)
-    void open_stream(AVIOReadCallback avio_read_callback);
+    // An optional seek callback makes the stream seekable
+    void open_stream(AVIOReadCallback avio_read_callback,
+                     AVIOSeekCallback avio_seek_callback = nullptr);
+
+    // Push-mode streams: asked before every packet read with the bytes the
+    // demuxer already holds and the bytes it may read ahead beyond the packet
+    // (nonzero only for the first packet of some containers); returning
+    // false ends the decode call as if no data were available, so a packet
+    // is never read from a short buffer. Set before opening, a header naming
+    // codec, rate and channels (WAV, raw PCM) is trusted without stream
+    // analysis, which would wait for seconds of input.
+    using InputGate = std::function<bool(int64_t buffered, int64_t lookahead)>;
+    void set_input_gate(InputGate gate) { input_gate_ = std::move(gate); }
+
+    // Seek so that the next decoded sample is the one at `seconds`
+    void seek(double seconds);
+
+    // Seek so that the next decoded sample is `sample` (output sample rate).
+    // The demuxer seeks to a point before the target (covering codec pre-roll),
+    // restarts the resampler on the same sample grid as a decode from the
+    // start, and discards everything before the target.
+    void seek_to_sample(int64_t sample);
+
+    // Build a packet index over the current source (one demux-only pass) and
+    // use it for subsequent seeks. Rewinds decoding to the start.
+    void build_packet_index();
+
+    // Write the current packet index to a sidecar file
+    void save_packet_index(const std::string &index_path) const;
+
+    // Share an index built by another decoder over the same source
+    void set_packet_index(std::shared_ptr<const PacketIndex> index) { packet_index_ = std::move(index); }
+    const std::shared_ptr<const PacketIndex> &packet_index() const { return packet_index_; }
 
-    // Decode next frame - returns pointer to internal AVFrame
+    // Decode next frame - returns pointer to internal AVFrame in the output
+    // sample format and layout. For F16 output the frame is declared as
+    // 16-bit integer (S16/S16P) and holds IEEE half bit patterns.
+    // With chunk_samples set, every frame holds exactly that many samples
+    // (except a short tail with ChunkTail::Short).
     // WARNING: Data is only valid until the next decode call
     AVFrame *decode_next();
 
+    // Decode into caller-owned buffers in the output sample format and layout
+    // (one pointer per output channel when planar, a single pointer when
+    // interleaved, each with room for `capacity` samples per channel).
+    // Converts straight into `dst` without an intermediate frame; output that
+    // does not fit is kept and returned by the next call.
+    // Returns samples written per channel: less than `capacity` only at EOF
+    // or when no data is currently available.
+    int64_t decode_into(uint8_t *const *dst, int64_t capacity);
+
+    // Decode until EOF (or until `capacity` samples are written) into `dst`
+    int64_t decode_all_into(uint8_t *const *dst, int64_t capacity);
+
     // Decode entire audio file at once (offline decoding)
-    // Returns all samples in planar float format
+    // Returns all samples in planar float format (F32 / Planar output only)
     AudioSamples get_all_samples();
 
+    // Decode entire audio into one contiguous, presized AudioBuffer
+    AudioBuffer decode_all();
+
+    // Output branches (AudioStreamOptions::branches): decode one frame and
+    // convert it for every branch. Returns one frame per branch (possibly
+    // empty while a resampler fills its filter), or no frames at EOF or
+    // when no data is currently available.
+    // WARNING: Frames are only valid until the next decode call
+    const std::vector<AVFrame *> &decode_next_branches();
+
+    // Decode the entire stream into one AudioBuffer per branch
+    std::vector<AudioBuffer> decode_all_branches();
+
+    size_t num_branches() const { return branches_.size(); }
+    const SingleStreamDecoder &branch(size_t index) const { return *branches_.at(index); }
+
     // Check if there are more frames to decode
-    bool is_finished() const { return eof_reached_; }
+    bool is_finished() const
+    {
+      // Chunked: also the buffered samples must have been returned
+      return eof_reached_ && (chunk_finished_ || chunk_samples_ == 0 || (chunk_fresh_ == 0 && !chunk_returned_));
+    }
+
+    // Incremented whenever the frame returned by decode_next() is invalidated
+    uint64_t frame_generation() const { return frame_generation_; }
 
     const Metadata &get_metadata() const { return metadata_; }
 
+    SampleFormat output_format() const { return options_.output_sample_format; }
+    SampleLayout output_layout() const { return options_.output_layout; }
+    int output_channels() const { return options_.output_num_channels.value_or(metadata_.num_channels); }
+
+    // Output frame buffers allocated vs handed out since construction
+    AllocationStats get_allocation_stats() const;
+
+    // Description of the opened stream, reusable as
+    // AudioStreamOptions::stream_description to open similar inputs without probing
+    StreamDescription get_stream_description() const;
+
   private:
-    void setup_decoder();
+    void open_input(const std::string &source);
+    void setup_decoder(bool reuse_contexts = false);
     void setup_resampler(AVFrame *frame);
+    bool codec_params_match(const AVCodecParameters *params) const;
+    bool header_is_complete(bool need_duration = true) const;
+    void apply_stream_description(const StreamDescription &description);
+    static std::string probe_sample_format(const AVCodecParameters *params, const AVCodec *codec);
+    bool resampler_matches(const AVChannelLayout &in_ch_layout, AVSampleFormat in_format, int in_sample_rate,
+                           int out_rate, int out_channels) const;
     int calculate_output_samples(int src_samples, int src_rate, int dst_rate) const;
+    int64_t estimate_total_output_samples() const;
+    bool trim_after_seek();
+    void setup_packet_index(const std::string &source);
+    void seek_demuxer(int64_t sample);
+    AVFrame *decode_frame();
+    AVFrame *decode_chunk();
+    void reset_chunks();
     AVFrame *process_decoded_frame();
+    void reset_branches();
+    bool read_raw_frame();
+    uint8_t **offset_planes(uint8_t *const *dst, int64_t offset);
+    void copy_output(const uint8_t *const *src, int64_t src_offset, uint8_t *const *dst,
+                     int64_t dst_offset, int64_t count);
+    int64_t convert_into(uint8_t *const *dst, int64_t capacity, const uint8_t **src, int src_samples);
+    void build_channel_matrix(int in_channels);
+    bool init_fast_converter(const AVFrame *frame, AVSampleFormat out_format, int out_channels);
+    bool setup_polyphase(AVFrame *frame, int out_rate, int out_channels);
+    int64_t resample(uint8_t *const *dst, int64_t capacity, const uint8_t **src, int src_samples);
+    int64_t drain_pending(uint8_t *const *dst, int64_t offset, int64_t capacity);
+    int64_t decode_into_at(uint8_t *const *dst, int64_t offset, int64_t capacity);
 
     // Core FFmpeg contexts
     AVFormatContextPtr fmt_ctx_;
     AVCodecContextPtr codec_ctx_;
+    AVCodecParametersPtr codec_params_; // Parameters codec_ctx_ was opened with
     SwrContextPtr swr_ctx_;
+    FastConverter fast_converter_; // Replaces swr_ctx_ for same-rate float output
+    PolyphaseResampler polyphase_; // Replaces swr_ctx_ with Resampler::Polyphase
+    ResamplerSettings resampler_settings_; // options_.resampler_quality, resolved
+    std::vector<double> channel_matrix_;   // channel_indices / mix_matrix for the current input
 
     AVPacketPtr packet_;
     AVFramePtr frame_;
     AVFramePtr converted_frame_;
+    AVFramePtr half_frame_; // F16 output of decode_next()
+    FramePool converted_pool_; // Buffers of converted_frame_
+    FramePool half_pool_;      // Buffers of half_frame_
+    FramePool capture_pool_;   // Buffers of captured (WASAPI) frame_
+    FramePool chunk_pool_;     // Buffers of chunk_frame_
+
+    // Chunked decode_next(): chunk_frame_ holds chunk_filled_ samples, of
+    // which chunk_fresh_ were not part of a returned chunk yet. After a
+    // chunk is returned the next call moves the overlap to the front, or
+    // skips chunk_skip_ samples when the hop is longer than a chunk. While
+    // a returned chunk is still referenced, the next one is built in
+    // chunk_spare_ and swapped in.
+    AVFramePtr chunk_frame_;
+    AVFramePtr chunk_spare_;
+    int chunk_samples_ = 0;
+    int hop_samples_ = 0;
+    int64_t chunk_filled_ = 0;
+    int64_t chunk_fresh_ = 0;
+    int64_t chunk_skip_ = 0;
+    bool chunk_returned_ = false;
+    bool chunk_finished_ = false;
+
+    // Fan-out: decoders that are never opened, fed references to frame_;
+    // each runs only the output stage (resampler, conversion, F16)
+    std::vector<std::unique_ptr<SingleStreamDecoder>> branches_;
+    std::vector<AVFrame *> branch_frames_;
 
     AudioStreamOptions options_;
     Metadata metadata_;
     int audio_stream_index_ = -1;
-    bool eof_reached_ = false;
+    bool input_eof_ = false;   // Demuxer has no more packets
+    bool eof_reached_ = false; // Decoder fully drained
     bool needs_resample_ = true;
+    bool fast_convert_ = false; // frame_ is converted by fast_converter_, not swr_ctx_
+    bool use_polyphase_ = false; // Rate conversion by polyphase_, not swr_ctx_
+    bool premix_ = false; // fast_converter_ remixes to planar float output channels before the rate conversion
     bool resampler_initialized_ = false;
 
     // Data provider callback for streaming
     AVIOReadCallback avio_read_callback_;
+    InputGate input_gate_;
+    int64_t gate_lookahead_ = 0;
     int64_t total_samples_decoded_ = 0;
+    uint64_t frame_generation_ = 0;
+
+    // Output format: what the resampler produces (float for F16 output,
+    // which is converted afterwards), planes and elements per sample and plane
+    AVSampleFormat output_sample_format_ = AV_SAMPLE_FMT_FLTP;
+    bool half_output_ = false;
+    int output_planes_ = 0;
+    int plane_elements_ = 1;
+
+    // decode_into state: output plane pointers and samples of frame_
+    // already handed out (passthrough path only)
+    std::vector<uint8_t *> dst_planes_;
+    int64_t pending_offset_ = 0;
+
+    // Rate conversion input remixed to planar float, its plane pointers,
+    // and polyphase output plane pointers
+    std::vector<float> premix_input_;
+    std::vector<const uint8_t *> premix_planes_;
+    std::vector<float *> polyphase_dst_;
+
+    // Float staging for F16 output written by decode_into()
+    std::vector<float> half_staging_;
+    std::vector<uint8_t *> staging_planes_;
+
+    // Seek state: source sample where decoding resumes (-1 when not seeking),
+    // source position of the next frame, and output samples to drop once the
+    // resampler is restarted
+    int64_t seek_restart_sample_ = -1;
+    int64_t next_frame_sample_ = -1;
+    int64_t seek_drop_output_ = 0;
+
+    std::shared_ptr<const PacketIndex> packet_index_;
+    std::string source_path_; // Path of the opened file, stamped into saved indexes; empty for memory / streams
+    bool index_timestamps_ = false; // Packet timestamps come from the index (after a byte seek)
 
 #ifdef AVIOFLOW_HAS_WASAPI
     std::unique_ptr<WasapiHandler> wasapi_handler_;
@@ -74,7 +269,12 @@ namespace avioflow
 #endif
 
     // static
-    static constexpr AVSampleFormat output_sample_format_ = AV_SAMPLE_FMT_FLTP;
+    // Samples per channel converted through the F16 staging buffer at a time
+    static constexpr int kHalfStagingSamples = 4096;
+    // Codec frames decoded (and discarded) before a seek target
+    static constexpr int kPrerollFrames = 4;
+    // Source samples the resampler runs before a seek target
+    static constexpr int64_t kResamplerWarmupSamples = 2048;
   };
 
 } // namespace avioflow
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace avioflow
+{
+
+  // Lock-free single-producer / single-consumer byte ring.
+  // One thread writes, one thread reads (they may be the same thread);
+  // neither side ever waits: write() takes what fits, read() returns what is
+  // there. Reads only advance the consumer's cursor; the space is handed
+  // back to the producer by commit(), so a reader can rewind() and read the
+  // same bytes again (e.g. to retry a failed format probe).
+  class ByteRing
+  {
+  public:
+    // Capacity is rounded up to a power of two
+    explicit ByteRing(size_t capacity)
+    {
+      capacity_ = 1;
+      while (capacity_ < capacity)
+        capacity_ <<= 1;
+      data_ = std::make_unique<uint8_t[]>(capacity_);
+    }
+
+    ByteRing(const ByteRing &) = delete;
+    ByteRing &operator=(const ByteRing &) = delete;
+
+    size_t capacity() const { return capacity_; }
+
+    // --- Producer ---
+
+    // Bytes that can be written without overwriting uncommitted ones
+    size_t free_space() const
+    {
+      return capacity_ - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+    }
+
+    // Copy up to `size` bytes in; returns the number written
+    size_t write(const uint8_t *data, size_t size)
+    {
+      uint64_t head = head_.load(std::memory_order_relaxed);
+      size = std::min(size, free_space());
+      copy_in(head, data, size);
+      head_.store(head + size, std::memory_order_release);
+      return size;
+    }
+
+    // --- Consumer ---
+
+    // Bytes written but not yet read
+    size_t readable() const
+    {
+      return static_cast<size_t>(head_.load(std::memory_order_acquire) - read_);
+    }
+
+    // Copy up to `size` bytes out; returns the number read
+    size_t read(uint8_t *data, size_t size)
+    {
+      size = std::min(size, readable());
+      copy_out(read_, data, size);
+      read_ += size;
+      return size;
+    }
+
+    // Release everything read so far to the producer
+    void commit() { tail_.store(read_, std::memory_order_release); }
+
+    // Forget the reads since the last commit()
+    void rewind() { read_ = tail_.load(std::memory_order_relaxed); }
+
+  private:
+    void copy_in(uint64_t pos, const uint8_t *src, size_t size)
+    {
+      if (size == 0)
+        return;
+      size_t offset = static_cast<size_t>(pos & (capacity_ - 1));
+      size_t first = std::min(size, capacity_ - offset);
+      std::memcpy(data_.get() + offset, src, first);
+      std::memcpy(data_.get(), src + first, size - first);
+    }
+
+    void copy_out(uint64_t pos, uint8_t *dst, size_t size) const
+    {
+      if (size == 0)
+        return;
+      size_t offset = static_cast<size_t>(pos & (capacity_ - 1));
+      size_t first = std::min(size, capacity_ - offset);
+      std::memcpy(dst, data_.get() + offset, first);
+      std::memcpy(dst + first, data_.get(), size - first);
+    }
+
+    std::unique_ptr<uint8_t[]> data_;
+    size_t capacity_ = 0;
+    // Monotonic positions; the producer owns head_, the consumer tail_ and read_
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t read_ = 0;
+  };
+
+} // namespace avioflow
@@ -0,0 +1,157 @@
+#include "polyphase-resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace avioflow
+{
+
+  namespace
+  {
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Zeroth-order modified Bessel function of the first kind
+    double bessel_i0(double x)
+    {
+      double sum = 1.0, term = 1.0;
+      for (int k = 1; k < 50; ++k)
+      {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-17)
+          break;
+      }
+      return sum;
+    }
+
+  } // namespace
+
+  bool PolyphaseResampler::supports(int in_rate, int out_rate)
+  {
+    if (in_rate <= 0 || out_rate <= 0)
+      return false;
+    return out_rate / std::gcd(in_rate, out_rate) <= kMaxPhases;
+  }
+
+  void PolyphaseResampler::init(int in_rate, int out_rate, int channels, const PolyphaseDesign &design,
+                                const simd::Kernels &kernels)
+  {
+    if (!supports(in_rate, out_rate) || channels <= 0)
+      throw std::runtime_error("Unsupported polyphase resampling ratio: " + std::to_string(in_rate) +
+                               " -> " + std::to_string(out_rate) + " Hz");
+    if (design.filter_size <= 0 || !(design.cutoff > 0.0 && design.cutoff <= 1.0))
+      throw std::runtime_error("Invalid polyphase filter design");
+
+    in_rate_ = in_rate;
+    out_rate_ = out_rate;
+    channels_ = channels;
+    design_ = design;
+    kernels_ = &kernels;
+    int g = std::gcd(in_rate, out_rate);
+    up_ = out_rate / g;
+    down_ = in_rate / g;
+
+    // Cutoff relative to the input Nyquist frequency; downsampling widens
+    // the filter by the ratio. Rounding the length up to the kernel's
+    // multiple of 16 widens the window too, rather than padding with zeros.
+    double factor = design.cutoff * std::min(1.0, static_cast<double>(up_) / down_);
+    int half = static_cast<int>(std::ceil(design.filter_size / 2.0 / factor));
+    taps_ = (2 * half + 15) / 16 * 16;
+    half = taps_ / 2;
+
+    filters_.assign(static_cast<size_t>(up_) * taps_, 0.0f);
+    const double window_norm = bessel_i0(design.kaiser_beta);
+    std::vector<double> filter(taps_);
+    for (int p = 0; p < up_; ++p)
+    {
+      // Tap k weighs input (position + k - (half - 1)) for an output at
+      // position + p / up: distance d from the output instant
+      double sum = 0.0;
+      for (int k = 0; k < taps_; ++k)
+      {
+        double d = static_cast<double>(p) / up_ + (half - 1 - k);
+        double x = factor * d;
+        double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+        double r = d / half;
+        double window = r * r < 1.0 ? bessel_i0(design.kaiser_beta * std::sqrt(1.0 - r * r)) / window_norm : 0.0;
+        filter[k] = factor * sinc * window;
+        sum += filter[k];
+      }
+      // Unity gain at DC for every phase
+      for (int k = 0; k < taps_; ++k)
+        filters_[static_cast<size_t>(p) * taps_ + k] = static_cast<float>(filter[k] / sum);
+    }
+
+    reset();
+  }
+
+  void PolyphaseResampler::reset()
+  {
+    int64_t lead = taps_ / 2 - 1;
+    buffers_.resize(channels_);
+    for (auto &buffer : buffers_)
+      buffer.assign(static_cast<size_t>(lead), 0.0f);
+    buffered_ = lead;
+    position_ = 0;
+    phase_ = 0;
+    drop_ = 0;
+  }
+
+  int64_t PolyphaseResampler::available() const
+  {
+    // Outputs n with position_ + (phase_ + n * down_) / up_ + taps_ <= buffered_
+    int64_t room = buffered_ - taps_ - position_;
+    if (room < 0)
+      return 0;
+    return ((room + 1) * up_ - 1 - phase_) / down_ + 1;
+  }
+
+  void PolyphaseResampler::advance(int64_t outputs)
+  {
+    int64_t total = phase_ + outputs * down_;
+    position_ += total / up_;
+    phase_ = static_cast<int>(total % up_);
+  }
+
+  int64_t PolyphaseResampler::convert(float *const *dst, ptrdiff_t dst_stride, int64_t capacity,
+                                      const float *const *src, int64_t src_samples)
+  {
+    // Drop consumed input, keep the history the next outputs need
+    if (position_ > 0)
+    {
+      for (auto &buffer : buffers_)
+        buffer.erase(buffer.begin(), buffer.begin() + position_);
+      buffered_ -= position_;
+      position_ = 0;
+    }
+
+    if (src && src_samples > 0)
+    {
+      for (int c = 0; c < channels_; ++c)
+        buffers_[c].insert(buffers_[c].end(), src[c], src[c] + src_samples);
+      buffered_ += src_samples;
+    }
+
+    if (drop_ > 0)
+    {
+      int64_t skipped = std::min(drop_, available());
+      advance(skipped);
+      drop_ -= skipped;
+    }
+
+    int64_t count = std::min(capacity, available());
+    if (count <= 0)
+      return 0;
+    for (int c = 0; c < channels_; ++c)
+    {
+      kernels_->polyphase_f32(buffers_[c].data() + position_, filters_.data(), taps_, up_, down_,
+                              phase_, dst[c], dst_stride, static_cast<size_t>(count));
+    }
+    advance(count);
+    return count;
+  }
+
+} // namespace avioflow
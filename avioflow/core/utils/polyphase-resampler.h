@@ -0,0 +1,90 @@
+#pragma once
+
+#include "simd-kernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace avioflow
+{
+
+  // Filter parameters of a PolyphaseResampler, as swresample's options of
+  // the same names (and with the same defaults)
+  struct PolyphaseDesign
+  {
+    int filter_size = 32;
+    double cutoff = 0.97;
+    double kaiser_beta = 9.0;
+
+    bool operator==(const PolyphaseDesign &) const = default;
+  };
+
+  // Windowed-sinc polyphase FIR resampler for rational rate ratios, on
+  // planar float samples. The ratio out/in is reduced to up/down; output n
+  // is taken at input position n * down / up with one of `up` precomputed
+  // filters, so no phase is interpolated. The filter follows swresample's
+  // defaults (Kaiser window, beta 9, cutoff 0.97 of the lower Nyquist
+  // frequency, 32 taps at the input rate widened for downsampling), and
+  // output stays on the same sample grid as swresample's. A PolyphaseDesign can
+  // trade filter length and cutoff for speed.
+  //
+  // Input is buffered across calls, so it can be fed frame by frame.
+  class PolyphaseResampler
+  {
+  public:
+    // Ratios with more phases are left to swresample
+    static constexpr int kMaxPhases = 1024;
+
+    static bool supports(int in_rate, int out_rate);
+
+    // Throws std::runtime_error for an unsupported ratio
+    void init(int in_rate, int out_rate, int channels, const PolyphaseDesign &design = {},
+              const simd::Kernels &kernels = simd::kernels());
+
+    bool matches(int in_rate, int out_rate, int channels, const PolyphaseDesign &design = {}) const
+    {
+      return in_rate == in_rate_ && out_rate == out_rate_ && channels == channels_ && design == design_;
+    }
+
+    // Forget all buffered input (as after init)
+    void reset();
+
+    // Discard the next `count` output samples
+    void drop_output(int64_t count) { drop_ += count; }
+
+    // Buffered input samples per channel not consumed yet
+    int64_t delay() const { return buffered_ - position_; }
+
+    // Append `src_samples` input samples (one pointer per channel) and write
+    // up to `capacity` output samples per channel to dst[c][n * dst_stride].
+    // Input that does not fit stays buffered for the next call; pass no
+    // input to drain it.
+    int64_t convert(float *const *dst, ptrdiff_t dst_stride, int64_t capacity,
+                    const float *const *src, int64_t src_samples);
+
+    int taps() const { return taps_; }
+    int phases() const { return up_; }
+
+  private:
+    int64_t available() const;
+    void advance(int64_t outputs);
+
+    int in_rate_ = 0, out_rate_ = 0, channels_ = 0;
+    PolyphaseDesign design_;
+    int up_ = 1, down_ = 1; // Reduced out_rate / in_rate
+    int taps_ = 0;          // Per phase, a multiple of 16
+    std::vector<float> filters_; // up_ phases of taps_ coefficients
+
+    // Input history per channel. Output `next` reads buffer[position_ ...]
+    // with filter phase_; the buffer starts with taps_ / 2 - 1 zeros so the
+    // first output is centered on the first input sample.
+    std::vector<std::vector<float>> buffers_;
+    int64_t buffered_ = 0;
+    int64_t position_ = 0;
+    int phase_ = 0;
+    int64_t drop_ = 0;
+
+    const simd::Kernels *kernels_ = nullptr;
+  };
+
+} // namespace avioflow
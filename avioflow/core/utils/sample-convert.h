@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace avioflow
+{
+
+  // IEEE 754 binary16 from binary32, round to nearest even.
+  // Overflow saturates to infinity, NaN stays NaN, small values become
+  // subnormal halves.
+  inline uint16_t float_to_half(float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t abs = bits & 0x7fffffffu;
+
+    if (abs >= 0x7f800000u) // Inf / NaN
+      return sign | (abs > 0x7f800000u ? 0x7e00u : 0x7c00u);
+    if (abs >= 0x477ff000u) // Rounds to above the largest half (65504)
+      return sign | 0x7c00u;
+    if (abs < 0x38800000u) // Below the smallest normal half: subnormal or zero
+    {
+      if (abs < 0x33000000u) // Below half of the smallest subnormal
+        return sign;
+      uint32_t mantissa = (abs & 0x007fffffu) | 0x00800000u;
+      int shift = 126 - static_cast<int>(abs >> 23);
+      uint32_t half = mantissa >> shift;
+      uint32_t rest = mantissa & ((1u << shift) - 1);
+      uint32_t halfway = 1u << (shift - 1);
+      if (rest > halfway || (rest == halfway && (half & 1u)))
+        ++half;
+      return sign | static_cast<uint16_t>(half);
+    }
+
+    // Normal: rebias the exponent, round the 13 dropped mantissa bits
+    uint32_t half = (abs - 0x38000000u) >> 13;
+    uint32_t rest = abs & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+      ++half; // A carry into the exponent is still the correctly rounded value
+    return sign | static_cast<uint16_t>(half);
+  }
+
+  inline float half_to_float(uint16_t half)
+  {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+    uint32_t bits;
+
+    if (exponent == 0x1f) // Inf / NaN
+      bits = sign | 0x7f800000u | (mantissa << 13);
+    else if (exponent != 0)
+      bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+      bits = sign;
+    else
+    {
+      // Subnormal half: normalize into a binary32 exponent
+      int shift = 0;
+      while (!(mantissa & 0x400u))
+      {
+        mantissa <<= 1;
+        ++shift;
+      }
+      bits = sign | (static_cast<uint32_t>(113 - shift) << 23) | ((mantissa & 0x3ffu) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // Convert `count` floats to halves. Uses F16C when the build targets it.
+  inline void convert_float_to_half(const float *src, uint16_t *dst, size_t count)
+  {
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= count; i += 8)
+    {
+      __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+      dst[i] = float_to_half(src[i]);
+  }
+
+} // namespace avioflow
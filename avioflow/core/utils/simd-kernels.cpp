@@ -0,0 +1,444 @@
+#include "simd-kernels.h"
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+// Every kernel is written once as a plain loop and instantiated per
+// instruction set: the entry points below are compiled with different target
+// attributes, and the always-inlined loop bodies are vectorized for each.
+// GCC/Clang on x86 get SSE2 (the x86-64 baseline), AVX2 and AVX-512 builds
+// selected at runtime; other compilers and architectures get the portable
+// build only.
+
+// Multiply-add contraction is chosen per section: the FIR filter may fuse
+// (FMA), the conversions and downmix keep separate roundings to match
+// swresample's C and SIMD code bit for bit
+#if defined(__clang__)
+#define AVIOFLOW_FP_CONTRACT_BEGIN(MODE) _Pragma("STDC FP_CONTRACT " #MODE)
+#define AVIOFLOW_FP_CONTRACT_END
+#elif defined(__GNUC__)
+#define AVIOFLOW_FP_CONTRACT_BEGIN(MODE) \
+  _Pragma("GCC push_options") AVIOFLOW_FP_CONTRACT_PRAGMA_##MODE
+#define AVIOFLOW_FP_CONTRACT_PRAGMA_ON _Pragma("GCC optimize(\"fp-contract=fast\")")
+#define AVIOFLOW_FP_CONTRACT_PRAGMA_OFF _Pragma("GCC optimize(\"fp-contract=off\")")
+#define AVIOFLOW_FP_CONTRACT_END _Pragma("GCC pop_options")
+#else
+#define AVIOFLOW_FP_CONTRACT_BEGIN(MODE)
+#define AVIOFLOW_FP_CONTRACT_END
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVIOFLOW_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define AVIOFLOW_ALWAYS_INLINE __forceinline
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define AVIOFLOW_SIMD_X86_DISPATCH 1
+#if defined(__clang__)
+#define AVIOFLOW_SCALAR_ATTR
+#else
+#define AVIOFLOW_SCALAR_ATTR __attribute__((optimize("no-tree-vectorize", "no-tree-slp-vectorize")))
+#endif
+#define AVIOFLOW_SSE2_ATTR
+#define AVIOFLOW_AVX2_ATTR __attribute__((target("avx2,fma")))
+#define AVIOFLOW_AVX512_ATTR __attribute__((target("avx512f,avx512bw,prefer-vector-width=512")))
+#elif defined(_M_X64) || defined(__x86_64__)
+#define AVIOFLOW_SIMD_X64_BASELINE 1
+#endif
+
+namespace avioflow::simd
+{
+
+  AVIOFLOW_FP_CONTRACT_BEGIN(ON)
+
+  namespace
+  {
+
+    // Sixteen independent partial sums: one AVX-512, two AVX2 or four SSE
+    // registers, so the loop vectorizes without reassociating the sum
+    constexpr int kDotLanes = 16;
+
+    template <int TAPS>
+    AVIOFLOW_ALWAYS_INLINE float dot(const float *__restrict a, const float *__restrict b, int taps)
+    {
+      const int n = TAPS > 0 ? TAPS : taps;
+      float acc[kDotLanes] = {};
+      for (int k = 0; k < n; k += kDotLanes)
+      {
+        for (int j = 0; j < kDotLanes; ++j)
+          acc[j] += a[k + j] * b[k + j];
+      }
+      // Pairwise reduction with constant trip counts, so it stays in registers
+      for (int j = 0; j < 8; ++j)
+        acc[j] += acc[j + 8];
+      for (int j = 0; j < 4; ++j)
+        acc[j] += acc[j + 4];
+      return (acc[0] + acc[2]) + (acc[1] + acc[3]);
+    }
+
+    template <int TAPS>
+    AVIOFLOW_ALWAYS_INLINE void polyphase(const float *src, const float *filters, int taps, int phases,
+                                          int step, int phase, float *dst, ptrdiff_t dst_stride,
+                                          size_t count)
+    {
+      const int step_index = step / phases;
+      const int step_phase = step % phases;
+      const float *in = src;
+      for (size_t n = 0; n < count; ++n)
+      {
+        dst[n * dst_stride] = dot<TAPS>(filters + static_cast<ptrdiff_t>(phase) * taps, in, taps);
+        in += step_index;
+        phase += step_phase;
+        if (phase >= phases)
+        {
+          phase -= phases;
+          ++in;
+        }
+      }
+    }
+
+    // Filter lengths of the common ratios get an unrolled dot product:
+    // 48 taps for 2:1 and 44.1 <-> 48 kHz, 80 for 1:2, 96 for 44.1 -> 16 kHz,
+    // 112 for 48 -> 16 kHz
+    AVIOFLOW_ALWAYS_INLINE void polyphase_dispatch(const float *src, const float *filters, int taps,
+                                                   int phases, int step, int phase, float *dst,
+                                                   ptrdiff_t dst_stride, size_t count)
+    {
+      switch (taps)
+      {
+      case 48:
+        return polyphase<48>(src, filters, taps, phases, step, phase, dst, dst_stride, count);
+      case 80:
+        return polyphase<80>(src, filters, taps, phases, step, phase, dst, dst_stride, count);
+      case 96:
+        return polyphase<96>(src, filters, taps, phases, step, phase, dst, dst_stride, count);
+      case 112:
+        return polyphase<112>(src, filters, taps, phases, step, phase, dst, dst_stride, count);
+      default:
+        return polyphase<0>(src, filters, taps, phases, step, phase, dst, dst_stride, count);
+      }
+    }
+
+  } // namespace
+
+#define AVIOFLOW_DEFINE_POLYPHASE(NS, ATTR)                                                             \
+  namespace NS                                                                                         \
+  {                                                                                                    \
+    ATTR void polyphase_f32(const float *src, const float *filters, int taps, int phases, int step,   \
+                            int phase, float *dst, ptrdiff_t dst_stride, size_t count)                 \
+    {                                                                                                  \
+      polyphase_dispatch(src, filters, taps, phases, step, phase, dst, dst_stride, count);             \
+    }                                                                                                  \
+  }
+
+#if defined(AVIOFLOW_SIMD_X86_DISPATCH)
+  AVIOFLOW_DEFINE_POLYPHASE(scalar, AVIOFLOW_SCALAR_ATTR)
+  AVIOFLOW_DEFINE_POLYPHASE(sse2, AVIOFLOW_SSE2_ATTR)
+  AVIOFLOW_DEFINE_POLYPHASE(avx2, AVIOFLOW_AVX2_ATTR)
+  AVIOFLOW_DEFINE_POLYPHASE(avx512, AVIOFLOW_AVX512_ATTR)
+#elif defined(AVIOFLOW_SIMD_X64_BASELINE)
+  AVIOFLOW_DEFINE_POLYPHASE(sse2, )
+#else
+  AVIOFLOW_DEFINE_POLYPHASE(scalar, )
+#endif
+
+#undef AVIOFLOW_DEFINE_POLYPHASE
+
+  AVIOFLOW_FP_CONTRACT_END
+  AVIOFLOW_FP_CONTRACT_BEGIN(OFF)
+
+  namespace
+  {
+
+    // Same scaling as swresample's integer to float conversions
+    AVIOFLOW_ALWAYS_INLINE float to_float(int16_t x) { return static_cast<float>(x) * (1.0f / (1 << 15)); }
+    AVIOFLOW_ALWAYS_INLINE float to_float(int32_t x) { return static_cast<float>(x) * (1.0f / (1u << 31)); }
+    AVIOFLOW_ALWAYS_INLINE float to_float(float x) { return x; }
+
+    template <typename T>
+    AVIOFLOW_ALWAYS_INLINE void convert(const T *__restrict src, float *__restrict dst, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+        dst[i] = to_float(src[i]);
+    }
+
+    template <typename T>
+    AVIOFLOW_ALWAYS_INLINE void deinterleave(const T *__restrict src, float *const *dst, int channels,
+                                             size_t frames)
+    {
+      if (channels == 1)
+      {
+        convert(src, dst[0], frames);
+        return;
+      }
+      if (channels == 2)
+      {
+        float *__restrict left = dst[0];
+        float *__restrict right = dst[1];
+        for (size_t i = 0; i < frames; ++i)
+        {
+          left[i] = to_float(src[2 * i]);
+          right[i] = to_float(src[2 * i + 1]);
+        }
+        return;
+      }
+      for (int c = 0; c < channels; ++c)
+      {
+        float *__restrict out = dst[c];
+        for (size_t i = 0; i < frames; ++i)
+          out[i] = to_float(src[i * channels + c]);
+      }
+    }
+
+    // The term order and the one/two/many-term forms follow swresample's
+    // float rematrixing (mix_1_1, mix_2_1, and the generic v = 0; v += ...)
+    template <typename T>
+    AVIOFLOW_ALWAYS_INLINE void downmix_planar(const T *const *src, const float *coeffs, int terms,
+                                               float *__restrict dst, size_t frames)
+    {
+      if (terms == 1)
+      {
+        const T *__restrict a = src[0];
+        const float ca = coeffs[0];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] = to_float(a[i]) * ca;
+        return;
+      }
+      if (terms == 2)
+      {
+        const T *__restrict a = src[0];
+        const T *__restrict b = src[1];
+        const float ca = coeffs[0], cb = coeffs[1];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] = to_float(a[i]) * ca + to_float(b[i]) * cb;
+        return;
+      }
+      const T *__restrict first = src[0];
+      const float c0 = coeffs[0];
+      for (size_t i = 0; i < frames; ++i)
+        dst[i] = 0.0f + to_float(first[i]) * c0;
+      for (int k = 1; k < terms; ++k)
+      {
+        const T *__restrict in = src[k];
+        const float ck = coeffs[k];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] += to_float(in[i]) * ck;
+      }
+    }
+
+    template <typename T>
+    AVIOFLOW_ALWAYS_INLINE void downmix_interleaved(const T *__restrict src, int channels,
+                                                    const int *offsets, const float *coeffs,
+                                                    int terms, float *__restrict dst, size_t frames)
+    {
+      if (channels == 2 && terms == 2)
+      {
+        // Stereo to mono, the common case
+        const float ca = coeffs[0], cb = coeffs[1];
+        const T *__restrict a = src + offsets[0];
+        const T *__restrict b = src + offsets[1];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] = to_float(a[2 * i]) * ca + to_float(b[2 * i]) * cb;
+        return;
+      }
+      if (terms == 1)
+      {
+        const float ca = coeffs[0];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] = to_float(src[i * channels + offsets[0]]) * ca;
+        return;
+      }
+      if (terms == 2)
+      {
+        const float ca = coeffs[0], cb = coeffs[1];
+        for (size_t i = 0; i < frames; ++i)
+          dst[i] = to_float(src[i * channels + offsets[0]]) * ca +
+                   to_float(src[i * channels + offsets[1]]) * cb;
+        return;
+      }
+      for (size_t i = 0; i < frames; ++i)
+      {
+        const T *frame = src + i * channels;
+        float v = 0.0f;
+        for (int k = 0; k < terms; ++k)
+          v += to_float(frame[offsets[k]]) * coeffs[k];
+        dst[i] = v;
+      }
+    }
+
+  } // namespace
+
+#define AVIOFLOW_DEFINE_KERNELS(NS, LEVEL, ATTR)                                                        \
+  namespace NS                                                                                         \
+  {                                                                                                    \
+    ATTR void s16_to_f32(const int16_t *src, float *dst, size_t count) { convert(src, dst, count); }  \
+    ATTR void s32_to_f32(const int32_t *src, float *dst, size_t count) { convert(src, dst, count); }  \
+    ATTR void deinterleave_s16(const int16_t *src, float *const *dst, int channels, size_t frames)    \
+    {                                                                                                  \
+      deinterleave(src, dst, channels, frames);                                                        \
+    }                                                                                                  \
+    ATTR void deinterleave_s32(const int32_t *src, float *const *dst, int channels, size_t frames)    \
+    {                                                                                                  \
+      deinterleave(src, dst, channels, frames);                                                        \
+    }                                                                                                  \
+    ATTR void deinterleave_f32(const float *src, float *const *dst, int channels, size_t frames)      \
+    {                                                                                                  \
+      deinterleave(src, dst, channels, frames);                                                        \
+    }                                                                                                  \
+    ATTR void downmix_s16p(const int16_t *const *src, const float *coeffs, int terms, float *dst,     \
+                           size_t frames)                                                              \
+    {                                                                                                  \
+      downmix_planar(src, coeffs, terms, dst, frames);                                                 \
+    }                                                                                                  \
+    ATTR void downmix_s32p(const int32_t *const *src, const float *coeffs, int terms, float *dst,     \
+                           size_t frames)                                                              \
+    {                                                                                                  \
+      downmix_planar(src, coeffs, terms, dst, frames);                                                 \
+    }                                                                                                  \
+    ATTR void downmix_fltp(const float *const *src, const float *coeffs, int terms, float *dst,       \
+                           size_t frames)                                                              \
+    {                                                                                                  \
+      downmix_planar(src, coeffs, terms, dst, frames);                                                 \
+    }                                                                                                  \
+    ATTR void downmix_s16(const int16_t *src, int channels, const int *offsets, const float *coeffs,  \
+                          int terms, float *dst, size_t frames)                                        \
+    {                                                                                                  \
+      downmix_interleaved(src, channels, offsets, coeffs, terms, dst, frames);                         \
+    }                                                                                                  \
+    ATTR void downmix_s32(const int32_t *src, int channels, const int *offsets, const float *coeffs,  \
+                          int terms, float *dst, size_t frames)                                        \
+    {                                                                                                  \
+      downmix_interleaved(src, channels, offsets, coeffs, terms, dst, frames);                         \
+    }                                                                                                  \
+    ATTR void downmix_flt(const float *src, int channels, const int *offsets, const float *coeffs,    \
+                          int terms, float *dst, size_t frames)                                        \
+    {                                                                                                  \
+      downmix_interleaved(src, channels, offsets, coeffs, terms, dst, frames);                         \
+    }                                                                                                  \
+    const Kernels table = {LEVEL,            s16_to_f32,       s32_to_f32,   deinterleave_s16,        \
+                           deinterleave_s32, deinterleave_f32, downmix_s16p, downmix_s32p,            \
+                           downmix_fltp,     downmix_s16,      downmix_s32,  downmix_flt,             \
+                           polyphase_f32};                                                             \
+  }
+
+#if defined(AVIOFLOW_SIMD_X86_DISPATCH)
+  AVIOFLOW_DEFINE_KERNELS(scalar, Level::Scalar, AVIOFLOW_SCALAR_ATTR)
+  AVIOFLOW_DEFINE_KERNELS(sse2, Level::SSE2, AVIOFLOW_SSE2_ATTR)
+  AVIOFLOW_DEFINE_KERNELS(avx2, Level::AVX2, AVIOFLOW_AVX2_ATTR)
+  AVIOFLOW_DEFINE_KERNELS(avx512, Level::AVX512, AVIOFLOW_AVX512_ATTR)
+#elif defined(AVIOFLOW_SIMD_X64_BASELINE)
+  // x64 always has SSE2: the portable build is the SSE2 build
+  AVIOFLOW_DEFINE_KERNELS(sse2, Level::SSE2, )
+#else
+  AVIOFLOW_DEFINE_KERNELS(scalar, Level::Scalar, )
+#endif
+
+#undef AVIOFLOW_DEFINE_KERNELS
+
+  AVIOFLOW_FP_CONTRACT_END
+
+  namespace
+  {
+
+    bool cpu_supports(Level level)
+    {
+#if defined(AVIOFLOW_SIMD_X86_DISPATCH)
+      switch (level)
+      {
+      case Level::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+      case Level::AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+      default:
+        return true;
+      }
+#else
+      (void)level;
+      return true;
+#endif
+    }
+
+    // Highest level allowed by AVIOFLOW_SIMD (all when unset or unknown)
+    Level level_cap()
+    {
+      const char *env = std::getenv("AVIOFLOW_SIMD");
+      if (env == nullptr)
+        return Level::AVX512;
+      for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2, Level::AVX512})
+      {
+        if (std::strcmp(env, level_name(level)) == 0)
+          return level;
+      }
+      return Level::AVX512;
+    }
+
+    const Kernels &select_kernels()
+    {
+      Level cap = level_cap();
+      for (Level level : {Level::AVX512, Level::AVX2, Level::SSE2, Level::Scalar})
+      {
+        const Kernels *table = kernels_for(level);
+        if (table && level <= cap)
+          return *table;
+      }
+      // The portable build is always present
+      for (Level level : {Level::Scalar, Level::SSE2})
+      {
+        if (const Kernels *table = kernels_for(level))
+          return *table;
+      }
+      std::abort();
+    }
+
+  } // namespace
+
+  const Kernels *kernels_for(Level level)
+  {
+    if (!cpu_supports(level))
+      return nullptr;
+    switch (level)
+    {
+#if defined(AVIOFLOW_SIMD_X86_DISPATCH)
+    case Level::Scalar:
+      return &scalar::table;
+    case Level::SSE2:
+      return &sse2::table;
+    case Level::AVX2:
+      return &avx2::table;
+    case Level::AVX512:
+      return &avx512::table;
+#elif defined(AVIOFLOW_SIMD_X64_BASELINE)
+    case Level::SSE2:
+      return &sse2::table;
+#else
+    case Level::Scalar:
+      return &scalar::table;
+#endif
+    default:
+      return nullptr;
+    }
+  }
+
+  const Kernels &kernels()
+  {
+    static const Kernels &selected = select_kernels();
+    return selected;
+  }
+
+  const char *level_name(Level level)
+  {
+    switch (level)
+    {
+    case Level::SSE2:
+      return "sse2";
+    case Level::AVX2:
+      return "avx2";
+    case Level::AVX512:
+      return "avx512";
+    default:
+      return "scalar";
+    }
+  }
+
+} // namespace avioflow::simd
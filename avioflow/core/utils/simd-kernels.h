@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace avioflow::simd
+{
+
+  enum class Level
+  {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+  };
+
+  // Sample conversion kernels compiled for one instruction set.
+  // Integers are scaled like swresample (x / 2^15, x / 2^31) and mixing adds
+  // the weighted terms in order, so results match swresample bit for bit.
+  struct Kernels
+  {
+    Level level;
+
+    // Contiguous samples to float: dst[i] = src[i]
+    void (*s16_to_f32)(const int16_t *src, float *dst, size_t count);
+    void (*s32_to_f32)(const int32_t *src, float *dst, size_t count);
+
+    // Interleaved frames to planar float: dst[c][i] = src[i * channels + c]
+    void (*deinterleave_s16)(const int16_t *src, float *const *dst, int channels, size_t frames);
+    void (*deinterleave_s32)(const int32_t *src, float *const *dst, int channels, size_t frames);
+    void (*deinterleave_f32)(const float *src, float *const *dst, int channels, size_t frames);
+
+    // Mix planar input down to one channel: dst[i] = sum_k coeffs[k] * src[k][i]
+    void (*downmix_s16p)(const int16_t *const *src, const float *coeffs, int terms, float *dst, size_t frames);
+    void (*downmix_s32p)(const int32_t *const *src, const float *coeffs, int terms, float *dst, size_t frames);
+    void (*downmix_fltp)(const float *const *src, const float *coeffs, int terms, float *dst, size_t frames);
+
+    // Mix interleaved input down to one channel:
+    // dst[i] = sum_k coeffs[k] * src[i * channels + offsets[k]]
+    void (*downmix_s16)(const int16_t *src, int channels, const int *offsets, const float *coeffs,
+                        int terms, float *dst, size_t frames);
+    void (*downmix_s32)(const int32_t *src, int channels, const int *offsets, const float *coeffs,
+                        int terms, float *dst, size_t frames);
+    void (*downmix_flt)(const float *src, int channels, const int *offsets, const float *coeffs,
+                        int terms, float *dst, size_t frames);
+
+    // Polyphase FIR filtering for rational resampling. Output n is the dot
+    // product of `taps` coefficients of filter `phase` (filters[phase * taps])
+    // with the input starting at `index`; both start at 0 / `phase` and
+    // advance by `step` / `phases` per output. `taps` is a multiple of 16.
+    // dst[n * dst_stride] receives output n.
+    void (*polyphase_f32)(const float *src, const float *filters, int taps, int phases, int step,
+                          int phase, float *dst, ptrdiff_t dst_stride, size_t count);
+  };
+
+  // Kernels for the best instruction set this CPU supports, selected once.
+  // The AVIOFLOW_SIMD environment variable (scalar, sse2, avx2, avx512) caps it.
+  const Kernels &kernels();
+
+  // Kernels for a specific level, or nullptr when it is not built in or not
+  // supported by this CPU
+  const Kernels *kernels_for(Level level);
+
+  const char *level_name(Level level);
+
+} // namespace avioflow::simd
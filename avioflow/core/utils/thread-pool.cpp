@@ -0,0 +1,115 @@
+#include "thread-pool.h"
+#include <algorithm>
+#include <utility>
+
+namespace avioflow
+{
+
+  ThreadPool::ThreadPool(int num_threads)
+  {
+    if (num_threads <= 0)
+      num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < num_threads; ++i)
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    threads_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i)
+      threads_.emplace_back(&ThreadPool::run, this, i);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &thread : threads_)
+      thread.join();
+  }
+
+  void ThreadPool::submit(Task task)
+  {
+    size_t target;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      target = next_queue_++ % queues_.size();
+      ++pending_;
+      ++queued_; // Counted before the push so it never drops below zero
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+      queues_[target]->tasks.push_back(std::move(task));
+    }
+    work_cv_.notify_one();
+  }
+
+  void ThreadPool::wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return pending_ == 0; });
+    if (error_)
+      std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+  bool ThreadPool::try_pop(int worker, Task &task)
+  {
+    // Own deque first (front), then steal from the others (back)
+    size_t count = queues_.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+      WorkerQueue &queue = *queues_[(worker + i) % count];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty())
+        continue;
+      if (i == 0)
+      {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      else
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  void ThreadPool::run(int worker)
+  {
+    while (true)
+    {
+      Task task;
+      if (try_pop(worker, task))
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          --queued_;
+        }
+        try
+        {
+          task(worker);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!error_)
+            error_ = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0)
+          idle_cv_.notify_all();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+      if (stop_ && queued_ == 0)
+        return;
+    }
+  }
+
+} // namespace avioflow
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace avioflow
+{
+
+  // Fixed-size work-stealing thread pool.
+  // Every worker owns a deque: it takes tasks from the front of its own deque
+  // and, when that is empty, steals from the back of the others. Tasks receive
+  // the index of the worker running them, so callers can keep per-worker
+  // state (e.g. one reusable decoder per thread) without locking.
+  class ThreadPool
+  {
+  public:
+    using Task = std::function<void(int worker)>;
+
+    // num_threads <= 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(int num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int num_threads() const { return static_cast<int>(threads_.size()); }
+
+    // Queue a task; tasks are spread round-robin over the worker deques
+    void submit(Task task);
+
+    // Block until every submitted task has finished. Rethrows the first
+    // exception thrown by a task since the last wait().
+    void wait();
+
+  private:
+    struct WorkerQueue
+    {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    bool try_pop(int worker, Task &task);
+    void run(int worker);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_; // Guards the counters below
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    size_t queued_ = 0;  // Tasks waiting in a deque
+    size_t pending_ = 0; // Tasks submitted and not finished
+    size_t next_queue_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+  };
+
+} // namespace avioflow
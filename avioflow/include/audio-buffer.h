@@ -0,0 +1,196 @@
+#pragma once
+
+#include "metadata.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace avioflow {
+
+// Contiguous buffer (channels x samples) for offline results, in any output
+// sample format and layout. Everything lives in one 64-byte aligned
+// allocation. Planar buffers hold one plane per channel: channel c starts at
+// data() + c * stride(), and the stride is padded so every channel is
+// aligned. Interleaved buffers hold a single plane of frames (L R L R ...).
+class AudioBuffer {
+public:
+  static constexpr size_t kAlignment = 64;
+  // Slack added to capacity estimates, and to the first growth past one
+  static constexpr int64_t kHeadroomSamples = 4096;
+
+  AudioBuffer() = default;
+
+  AudioBuffer(int num_channels, int64_t capacity, int sample_rate = 0,
+              SampleFormat format = SampleFormat::F32,
+              SampleLayout layout = SampleLayout::Planar)
+      : num_channels_(num_channels), sample_rate_(sample_rate), format_(format),
+        layout_(layout) {
+    reserve(capacity);
+  }
+
+  ~AudioBuffer() { release(); }
+
+  // Non-copyable
+  AudioBuffer(const AudioBuffer &) = delete;
+  AudioBuffer &operator=(const AudioBuffer &) = delete;
+
+  // Movable
+  AudioBuffer(AudioBuffer &&other) noexcept { swap(other); }
+  AudioBuffer &operator=(AudioBuffer &&other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // --- Shape ---
+
+  int num_channels() const { return num_channels_; }
+  int64_t num_samples() const { return num_samples_; } // Valid samples per channel
+  int64_t capacity() const { return capacity_; }       // Allocated samples per channel
+  int64_t stride() const { return stride_; }           // Distance between channels (in samples, planar)
+  int sample_rate() const { return sample_rate_; }
+  void set_sample_rate(int sample_rate) { sample_rate_ = sample_rate; }
+  bool empty() const { return num_samples_ == 0; }
+
+  SampleFormat format() const { return format_; }
+  SampleLayout layout() const { return layout_; }
+  int bytes_per_sample() const { return avioflow::bytes_per_sample(format_); }
+  int num_planes() const { return layout_ == SampleLayout::Planar ? num_channels_ : 1; }
+  size_t size_bytes() const { return plane_bytes(stride_) * num_planes(); }
+
+  // --- Data Access ---
+  // T is the element type of format(): float, int16_t or uint16_t (F16 bits)
+
+  template <typename T = float> T *data() { return reinterpret_cast<T *>(data_); }
+  template <typename T = float> const T *data() const { return reinterpret_cast<const T *>(data_); }
+
+  // Planar layout only
+  template <typename T = float> T *channel(int c) { return data<T>() + c * stride_; }
+  template <typename T = float> const T *channel(int c) const { return data<T>() + c * stride_; }
+
+  template <typename T = float>
+  std::span<const T> channel_span(int c) const {
+    return {channel<T>(c), static_cast<size_t>(num_samples_)};
+  }
+
+  // Interleaved layout only: num_samples() * num_channels() elements
+  template <typename T = float>
+  std::span<const T> interleaved_span() const {
+    return {data<T>(), static_cast<size_t>(num_samples_) * num_channels_};
+  }
+
+  // Byte address of sample `offset` in plane `p` (a channel, or the single
+  // interleaved plane)
+  uint8_t *plane_data(int p, int64_t offset = 0) {
+    return data_ + plane_bytes(static_cast<int64_t>(p) * stride_ + offset);
+  }
+
+  // --- Modifiers ---
+
+  // Grow to hold at least `capacity` samples per channel (contents preserved)
+  void reserve(int64_t capacity) {
+    if (capacity <= capacity_)
+      return;
+
+    int64_t new_stride = padded_stride(capacity);
+    size_t bytes = plane_bytes(new_stride) * num_planes();
+    uint8_t *new_data = static_cast<uint8_t *>(
+        ::operator new(bytes, std::align_val_t{kAlignment}));
+
+    for (int p = 0; p < num_planes() && num_samples_ > 0; ++p) {
+      std::memcpy(new_data + plane_bytes(p * new_stride), plane_data(p),
+                  plane_bytes(num_samples_));
+    }
+
+    release_storage();
+    data_ = new_data;
+    stride_ = new_stride;
+    capacity_ = new_stride;
+  }
+
+  // Grow past a capacity estimate that turned out too small: once to
+  // `needed` plus headroom, which covers an estimate that was only a little
+  // off, then by 1.5x if even that overflows (unknown or badly wrong length)
+  void grow(int64_t needed) {
+    if (needed <= capacity_)
+      return;
+    reserve(grown_ ? std::max(needed, capacity_ + capacity_ / 2) : needed + kHeadroomSamples);
+    grown_ = true;
+  }
+
+  // Set the number of valid samples per channel, growing if needed
+  void resize(int64_t num_samples) {
+    reserve(num_samples);
+    num_samples_ = num_samples;
+  }
+
+  // Append `count` samples per channel from planes in this buffer's format
+  // and layout, growing (see grow()) if the capacity estimate was too small
+  void append(const uint8_t *const *planes, int64_t count) {
+    int64_t needed = num_samples_ + count;
+    grow(needed);
+
+    for (int p = 0; p < num_planes(); ++p)
+      std::memcpy(plane_data(p, num_samples_), planes[p], plane_bytes(count));
+    num_samples_ = needed;
+  }
+
+  void append(const float *const *planes, int64_t count) {
+    append(reinterpret_cast<const uint8_t *const *>(planes), count);
+  }
+
+private:
+  // Bytes taken by `samples` samples of one plane
+  size_t plane_bytes(int64_t samples) const {
+    int64_t elements = layout_ == SampleLayout::Planar ? samples : samples * num_channels_;
+    return static_cast<size_t>(elements) * bytes_per_sample();
+  }
+
+  int64_t padded_stride(int64_t capacity) const {
+    const int64_t samples_per_line = std::max<int64_t>(
+        1, static_cast<int64_t>(kAlignment) / bytes_per_sample());
+    return (capacity + samples_per_line - 1) / samples_per_line * samples_per_line;
+  }
+
+  void release_storage() {
+    if (data_)
+      ::operator delete(data_, std::align_val_t{kAlignment});
+    data_ = nullptr;
+  }
+
+  void release() {
+    release_storage();
+    num_samples_ = capacity_ = stride_ = 0;
+    grown_ = false;
+  }
+
+  void swap(AudioBuffer &other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(num_channels_, other.num_channels_);
+    std::swap(num_samples_, other.num_samples_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(stride_, other.stride_);
+    std::swap(grown_, other.grown_);
+    std::swap(sample_rate_, other.sample_rate_);
+    std::swap(format_, other.format_);
+    std::swap(layout_, other.layout_);
+  }
+
+  uint8_t *data_ = nullptr;
+  int num_channels_ = 0;
+  int64_t num_samples_ = 0;
+  int64_t capacity_ = 0;
+  int64_t stride_ = 0;
+  bool grown_ = false; // Already grew past the initial estimate once
+  int sample_rate_ = 0;
+  SampleFormat format_ = SampleFormat::F32;
+  SampleLayout layout_ = SampleLayout::Planar;
+};
+
+} // namespace avioflow
@@ -1,6 +1,15 @@
 #include "avioflow-cxx-api.h"
 #include "../core/ffmpeg/device-handler.h"
+#include "../core/ffmpeg/frame-prefetcher.h"
+#include "../core/ffmpeg/parallel-decoder.h"
 #include "../core/ffmpeg/single-stream-decoder.h"
+#include "../core/utils/byte-ring.h"
+#include "../core/utils/thread-pool.h"
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
 
 
 namespace avioflow {
@@ -8,10 +17,124 @@ namespace avioflow {
 // PIMPL Implementation
 class AudioDecoder::Impl {
 public:
-  explicit Impl(const AudioStreamOptions &options) : decoder_(options) {}
+  explicit Impl(const AudioStreamOptions &options) : decoder_(options) {
+    if (options.prefetch_frames < 0)
+      throw std::invalid_argument("prefetch_frames must not be negative");
+    if (options.prefetch_frames > 0)
+      prefetcher_ = std::make_unique<FramePrefetcher>(decoder_, options.prefetch_frames);
+  }
+
+  // Caller buffers are typed; their element type must match the output format
+  size_t decode_into(SampleFormat format, const void *planes, size_t capacity, bool all) {
+    require_sync("decode_into()");
+    if (format != decoder_.output_format())
+      throw std::runtime_error("Output buffer element type does not match output_sample_format");
+    auto *dst = static_cast<uint8_t *const *>(const_cast<void *>(planes));
+    int64_t count = all ? decoder_.decode_all_into(dst, static_cast<int64_t>(capacity))
+                        : decoder_.decode_into(dst, static_cast<int64_t>(capacity));
+    return static_cast<size_t>(count);
+  }
+
+  // Run an open / seek on the decoder with the background thread stopped,
+  // then let it decode ahead from the new position
+  template <typename Action> void reposition(Action &&action) {
+    if (prefetcher_) {
+      prefetcher_->stop();
+      ++prefetch_generation_;
+    }
+    action();
+    cached_metadata_ = decoder_.get_metadata();
+    if (prefetcher_)
+      prefetcher_->start();
+  }
+
+  // Whole-stream and caller-buffer decoding bypass the frame queue
+  void require_sync(const char *method) const {
+    if (prefetcher_)
+      throw std::runtime_error(std::string(method) +
+                               " is not available with prefetch_frames; use decode_next_view()");
+  }
+
+  AudioFrameView view_of(const AVFrame *frame, uint64_t generation) const {
+    AudioFrameView view;
+    view.generation = generation;
+    if (!frame)
+      return view; // Empty view
+    view.planes = frame->extended_data;
+    view.num_channels = frame->ch_layout.nb_channels;
+    view.num_samples = frame->nb_samples;
+    view.sample_rate = frame->sample_rate;
+    view.format = decoder_.output_format();
+    view.layout = decoder_.output_layout();
+    return view;
+  }
+
+  // Next output frame, nullptr when none; bumps frame_generation()
+  AVFrame *next_frame(std::optional<std::chrono::milliseconds> timeout) {
+    if (!prefetcher_)
+      return decoder_.decode_next();
+
+    AVFrame *frame = prefetcher_->pop(timeout);
+    ++prefetch_generation_;
+    // The thread is done with the decoder: pick up what it learned at EOF
+    if (!frame && prefetcher_->finished())
+      cached_metadata_ = decoder_.get_metadata();
+    return frame;
+  }
+
+  uint64_t generation() const {
+    return prefetcher_ ? prefetch_generation_ : decoder_.frame_generation();
+  }
+
+  AudioFrameView next_view(std::optional<std::chrono::milliseconds> timeout) {
+    AVFrame *frame = next_frame(timeout);
+    return view_of(frame, generation());
+  }
+
+  // Next output frame as a new reference to its buffer, for AudioFrame;
+  // no owner when there is none
+  std::pair<AudioFrameView, std::shared_ptr<void>> next_owned(std::optional<std::chrono::milliseconds> timeout) {
+    AVFrame *frame = next_frame(timeout);
+    if (!frame)
+      return {};
+    AVFrame *ref = av_frame_clone(frame);
+    if (!ref)
+      throw std::runtime_error("Could not reference decoded frame");
+    std::shared_ptr<void> owner(ref, [](void *p) {
+      auto *owned = static_cast<AVFrame *>(p);
+      av_frame_free(&owned);
+    });
+    return {view_of(ref, 0), std::move(owner)};
+  }
+
+  AudioSamples next_samples(std::optional<std::chrono::milliseconds> timeout) {
+    if (decoder_.output_format() != SampleFormat::F32 ||
+        decoder_.output_layout() != SampleLayout::Planar)
+      throw std::runtime_error("AudioSamples holds planar float32; use decode_next_view() for "
+                               "other output formats or layouts");
+
+    AudioSamples result;
+
+    AudioFrameView view = next_view(timeout);
+    if (!view.planes)
+      return result; // No frame: empty samples. A 0-sample frame still has its channels
+
+    result.sample_rate = view.sample_rate;
+    result.data.resize(view.num_channels);
+
+    for (int c = 0; c < view.num_channels; ++c) {
+      auto channel_data = view.channel(c);
+      result.data[c].assign(channel_data.begin(), channel_data.end());
+    }
+
+    return result;
+  }
 
   SingleStreamDecoder decoder_;
   Metadata cached_metadata_;
+  // Declared after decoder_ so that its thread stops first
+  std::unique_ptr<FramePrefetcher> prefetcher_;
+  uint64_t prefetch_generation_ = 0;
 };
 
 // Constructor
@@ -29,17 +152,44 @@ AudioDecoder &AudioDecoder::operator=(AudioDecoder &&) noexcept = default;
 
 // --- Input Methods ---
 
+Metadata AudioDecoder::probe(const std::string &source, const AudioStreamOptions &options) {
+  AudioStreamOptions probe_options = options;
+  probe_options.probe_only = true;
+  SingleStreamDecoder decoder(probe_options);
+  decoder.open(source);
+  return decoder.get_metadata();
+}
+
 void AudioDecoder::open(const std::string &source) {
-  impl_->decoder_.open(source);
-  impl_->cached_metadata_ = impl_->decoder_.get_metadata();
+  impl_->reposition([&] { impl_->decoder_.open(source); });
 }
 
-void AudioDecoder::open_memory(const uint8_t *data, size_t size) {
-  impl_->decoder_.open_memory(data, size);
-  impl_->cached_metadata_ = impl_->decoder_.get_metadata();
+void AudioDecoder::open_memory(const uint8_t *data, size_t size) { open_memory(data, size, nullptr); }
+
+void AudioDecoder::open_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner) {
+  impl_->reposition([&] { impl_->decoder_.open_memory(data, size, std::move(owner)); });
+}
+
+void AudioDecoder::reopen(const std::string &source) {
+  impl_->reposition([&] { impl_->decoder_.reopen(source); });
+}
+
+void AudioDecoder::reopen_memory(const uint8_t *data, size_t size) {
+  reopen_memory(data, size, nullptr);
+}
+
+void AudioDecoder::reopen_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner) {
+  impl_->reposition([&] { impl_->decoder_.reopen_memory(data, size, std::move(owner)); });
 }
 
 void AudioDecoder::open_stream(AVIOReadCallback avio_read_callback, const AudioStreamOptions &options) {
+  // A known stream description names its own container and needs no probing
+  if (options.stream_description.has_value() && !options.input_format.has_value()) {
+    impl_ = std::make_unique<Impl>(options);
+    impl_->reposition([&] { impl_->decoder_.open_stream(std::move(avio_read_callback)); });
+    return;
+  }
+
   // Validate that format is specified
   if (!options.input_format.has_value()) {
     throw std::runtime_error("input_format must be specified for streaming (e.g., aac, opus, pcm_s16le, wav)");
@@ -55,43 +205,409 @@ void AudioDecoder::open_stream(AVIOReadCallback avio_read_callback, const AudioS
   
   // Recreate impl with streaming options
   impl_ = std::make_unique<Impl>(options);
-  impl_->decoder_.open_stream(std::move(avio_read_callback));
-  impl_->cached_metadata_ = impl_->decoder_.get_metadata();
+  impl_->reposition([&] { impl_->decoder_.open_stream(std::move(avio_read_callback)); });
 }
 
-// --- Decoding Methods ---
+void AudioDecoder::open_stream(AVIOReadCallback avio_read_callback,
+                               AVIOSeekCallback avio_seek_callback,
+                               const AudioStreamOptions &options) {
+  // Recreate impl with streaming options
+  impl_ = std::make_unique<Impl>(options);
+  impl_->reposition([&] {
+    impl_->decoder_.open_stream(std::move(avio_read_callback), std::move(avio_seek_callback));
+  });
+}
+
+// --- Seeking ---
+
+void AudioDecoder::seek(double seconds) {
+  impl_->reposition([&] { impl_->decoder_.seek(seconds); });
+}
+
+void AudioDecoder::seek_to_sample(int64_t sample) {
+  impl_->reposition([&] { impl_->decoder_.seek_to_sample(sample); });
+}
+
+void AudioDecoder::build_packet_index() {
+  impl_->reposition([&] { impl_->decoder_.build_packet_index(); });
+}
 
-AudioSamples AudioDecoder::decode_next() {
-  AudioSamples result;
+void AudioDecoder::save_packet_index(const std::string &index_path) const {
+  impl_->decoder_.save_packet_index(index_path);
+}
 
-  AVFrame *frame = impl_->decoder_.decode_next();
-  if (!frame)
-    return result; // Empty samples
+// --- Decoding Methods ---
 
-  result.sample_rate = frame->sample_rate;
-  int num_channels = frame->ch_layout.nb_channels;
-  result.data.resize(num_channels);
+AudioSamples AudioDecoder::decode_next() { return impl_->next_samples(std::nullopt); }
 
-  for (int c = 0; c < num_channels; ++c) {
-    const float *channel_data = reinterpret_cast<const float *>(frame->data[c]);
-    result.data[c].assign(channel_data, channel_data + frame->nb_samples);
+AudioSamples AudioDecoder::decode_next(std::chrono::milliseconds timeout) {
+  return impl_->next_samples(timeout);
+}
+
+int64_t AudioFrame::plane_stride() const {
+  if (view_.layout == SampleLayout::Interleaved || view_.num_channels < 2)
+    return view_.num_samples; // One plane
+  int bytes = bytes_per_sample(view_.format);
+  ptrdiff_t step = view_.planes[1] - view_.planes[0];
+  if (step <= 0 || step % bytes != 0)
+    return 0;
+  for (int c = 2; c < view_.num_channels; ++c) {
+    if (view_.planes[c] - view_.planes[c - 1] != step)
+      return 0;
   }
+  return step / bytes;
+}
+
+AudioFrameView AudioDecoder::decode_next_view() { return impl_->next_view(std::nullopt); }
+
+AudioFrameView AudioDecoder::decode_next_view(std::chrono::milliseconds timeout) {
+  return impl_->next_view(timeout);
+}
+
+AudioFrame AudioDecoder::decode_next_frame() {
+  auto [view, owner] = impl_->next_owned(std::nullopt);
+  return AudioFrame(view, std::move(owner));
+}
 
-  return result;
+AudioFrame AudioDecoder::decode_next_frame(std::chrono::milliseconds timeout) {
+  auto [view, owner] = impl_->next_owned(timeout);
+  return AudioFrame(view, std::move(owner));
+}
+
+size_t AudioDecoder::decode_into(float *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::F32, planes, capacity, false);
+}
+
+size_t AudioDecoder::decode_into(int16_t *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::S16, planes, capacity, false);
+}
+
+size_t AudioDecoder::decode_into(uint16_t *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::F16, planes, capacity, false);
+}
+
+size_t AudioDecoder::decode_all_into(float *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::F32, planes, capacity, true);
+}
+
+size_t AudioDecoder::decode_all_into(int16_t *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::S16, planes, capacity, true);
+}
+
+size_t AudioDecoder::decode_all_into(uint16_t *const *planes, size_t capacity) {
+  return impl_->decode_into(SampleFormat::F16, planes, capacity, true);
 }
 
 AudioSamples AudioDecoder::get_all_samples() {
+  impl_->require_sync("get_all_samples()");
   return impl_->decoder_.get_all_samples();
 }
 
+AudioBuffer AudioDecoder::decode_all() {
+  impl_->require_sync("decode_all()");
+  return impl_->decoder_.decode_all();
+}
+
+std::vector<AudioFrameView> AudioDecoder::decode_next_branch_views() {
+  impl_->require_sync("decode_next_branch_views()");
+  auto &decoder = impl_->decoder_;
+  const auto &frames = decoder.decode_next_branches();
+  std::vector<AudioFrameView> views(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const AVFrame *frame = frames[i];
+    views[i].planes = frame->extended_data;
+    views[i].num_channels = frame->ch_layout.nb_channels;
+    views[i].num_samples = frame->nb_samples;
+    views[i].sample_rate = frame->sample_rate;
+    views[i].format = decoder.branch(i).output_format();
+    views[i].layout = decoder.branch(i).output_layout();
+    views[i].generation = decoder.frame_generation();
+  }
+  return views;
+}
+
+std::vector<AudioBuffer> AudioDecoder::decode_all_branches() {
+  impl_->require_sync("decode_all_branches()");
+  return impl_->decoder_.decode_all_branches();
+}
+
 // --- Status ---
 
-bool AudioDecoder::is_finished() const { return impl_->decoder_.is_finished(); }
+bool AudioDecoder::is_finished() const {
+  if (impl_->prefetcher_)
+    return impl_->prefetcher_->finished();
+  return impl_->decoder_.is_finished();
+}
+
+uint64_t AudioDecoder::frame_generation() const {
+  if (impl_->prefetcher_)
+    return impl_->prefetch_generation_;
+  return impl_->decoder_.frame_generation();
+}
+
+SampleFormat AudioDecoder::output_sample_format() const {
+  return impl_->decoder_.output_format();
+}
+
+SampleLayout AudioDecoder::output_layout() const {
+  return impl_->decoder_.output_layout();
+}
+
+int AudioDecoder::output_num_channels() const {
+  return impl_->decoder_.output_channels();
+}
 
 const Metadata &AudioDecoder::get_metadata() const {
+  // The decoder may be updating its own copy on the background thread
+  if (impl_->prefetcher_)
+    return impl_->cached_metadata_;
   return impl_->decoder_.get_metadata();
 }
 
+StreamDescription AudioDecoder::get_stream_description() const {
+  return impl_->decoder_.get_stream_description();
+}
+
+AllocationStats AudioDecoder::get_allocation_stats() const {
+  if (impl_->prefetcher_)
+    return impl_->prefetcher_->stats();
+  return impl_->decoder_.get_allocation_stats();
+}
+
+// --- Push-Mode Streaming ---
+
+class StreamingDecoder::Impl {
+public:
+  // First probe attempt; doubled after every probe that runs out of input
+  static constexpr size_t kFirstProbeBytes = 4 << 10;
+
+  // Stream analysis default: FFmpeg's 5 s would hold back the first frames
+  static constexpr int64_t kAnalyzeDuration = 500000;
+
+  Impl(const AudioStreamOptions &options, size_t capacity, size_t reserve_bytes)
+      : options_(options), ring_(capacity), reserve_(reserve_bytes),
+        probe_at_(std::min(kFirstProbeBytes, ring_.capacity())) {
+    if (!options_.analyze_duration.has_value())
+      options_.analyze_duration = kAnalyzeDuration;
+  }
+
+  // AVIO read callback: buffered bytes, or EOF once input has ended. A probe
+  // that runs out of bytes also sees EOF (avformat_find_stream_info retries
+  // "no data" in a busy loop) and is discarded; after the probe the input
+  // gate keeps packet reads from running dry.
+  int read(uint8_t *buf, int size) {
+    bool ended = ended_.load(std::memory_order_acquire);
+    size_t count = ring_.read(buf, static_cast<size_t>(size));
+    if (count > 0) {
+      if (decoder_)
+        ring_.commit();
+      return static_cast<int>(count);
+    }
+    if (ended)
+      return 0;
+    if (!decoder_) {
+      starved_ = true;
+      return 0;
+    }
+    return -1;
+  }
+
+  // Probe the format and set up the decoder from the buffered bytes. The
+  // probe only reads from the ring; its bytes are released once it has
+  // succeeded without running out of input.
+  bool try_open() {
+    if (!ended_.load(std::memory_order_acquire) && ring_.readable() < probe_at_)
+      return false;
+
+    starved_ = false;
+    auto decoder = std::make_unique<SingleStreamDecoder>(options_);
+    // A full ring passes the gate, so a reserve above the capacity cannot stall
+    decoder->set_input_gate([this](int64_t buffered, int64_t lookahead) {
+      size_t needed = std::min(std::max(reserve_, static_cast<size_t>(lookahead)), ring_.capacity());
+      return ended_.load(std::memory_order_acquire) ||
+             static_cast<size_t>(buffered) + ring_.readable() >= needed;
+    });
+    try {
+      decoder->open_stream([this](uint8_t *buf, int size) { return read(buf, size); });
+    } catch (const std::exception &) {
+      if (!starved_)
+        throw;
+    }
+    if (starved_) {
+      ring_.rewind();
+      if (ring_.readable() >= ring_.capacity())
+        throw std::runtime_error("Stream header does not fit in the StreamingDecoder capacity");
+      probe_at_ = std::min(ring_.readable() * 2, ring_.capacity());
+      return false;
+    }
+
+    ring_.commit();
+    decoder_ = std::move(decoder);
+    return true;
+  }
+
+  const SingleStreamDecoder &decoder() const {
+    if (!decoder_)
+      throw std::runtime_error("Stream format not detected yet; feed more input");
+    return *decoder_;
+  }
+
+  AudioStreamOptions options_;
+  ByteRing ring_;
+  size_t reserve_;
+  size_t probe_at_;
+  std::atomic<bool> ended_{false};
+  bool starved_ = false;
+  std::unique_ptr<SingleStreamDecoder> decoder_;
+};
+
+StreamingDecoder::StreamingDecoder(const AudioStreamOptions &options, size_t capacity,
+                                   size_t reserve_bytes)
+    : impl_(std::make_unique<Impl>(options, capacity, reserve_bytes)) {}
+
+StreamingDecoder::~StreamingDecoder() = default;
+
+StreamingDecoder::StreamingDecoder(StreamingDecoder &&) noexcept = default;
+
+StreamingDecoder &StreamingDecoder::operator=(StreamingDecoder &&) noexcept = default;
+
+size_t StreamingDecoder::feed(const uint8_t *data, size_t size) {
+  if (impl_->ended_.load(std::memory_order_relaxed))
+    throw std::runtime_error("feed() called after end_of_input()");
+  return impl_->ring_.write(data, size);
+}
+
+void StreamingDecoder::end_of_input() { impl_->ended_.store(true, std::memory_order_release); }
+
+std::vector<AudioBuffer> StreamingDecoder::poll_frames() {
+  std::vector<AudioBuffer> frames;
+  if (!impl_->decoder_ && !impl_->try_open())
+    return frames;
+
+  auto &decoder = *impl_->decoder_;
+  while (AVFrame *frame = decoder.decode_next()) {
+    AudioBuffer buffer(frame->ch_layout.nb_channels, frame->nb_samples, frame->sample_rate,
+                       decoder.output_format(), decoder.output_layout());
+    buffer.append(frame->extended_data, frame->nb_samples);
+    frames.push_back(std::move(buffer));
+  }
+  return frames;
+}
+
+bool StreamingDecoder::is_open() const { return impl_->decoder_ != nullptr; }
+
+bool StreamingDecoder::is_finished() const {
+  return impl_->decoder_ && impl_->decoder_->is_finished();
+}
+
+const Metadata &StreamingDecoder::get_metadata() const { return impl_->decoder().get_metadata(); }
+
+AllocationStats StreamingDecoder::get_allocation_stats() const {
+  return impl_->decoder().get_allocation_stats();
+}
+
+// --- Parallel Offline Decoding ---
+
+AudioBuffer decode_file_parallel(const std::string &path, const AudioStreamOptions &options,
+                                 int num_threads) {
+  ParallelDecoder decoder(
+      options, [&path](SingleStreamDecoder &d) { d.open(path); }, num_threads);
+  return decoder.decode_all();
+}
+
+AudioBuffer decode_memory_parallel(const uint8_t *data, size_t size,
+                                   const AudioStreamOptions &options, int num_threads) {
+  ParallelDecoder decoder(
+      options, [data, size](SingleStreamDecoder &d) { d.open_memory(data, size); }, num_threads);
+  return decoder.decode_all();
+}
+
+// --- Batch Decoding ---
+
+class BatchDecoder::Impl {
+public:
+  Impl(const AudioStreamOptions &options, int num_threads)
+      : options_(options), pool_(num_threads), decoders_(pool_.num_threads()) {}
+
+  void decode(const std::vector<BatchSource> &sources, const CompletionCallback &on_complete) {
+    // Longest first (by encoded size): the tail of the batch is then made of
+    // short items that stealing can spread evenly
+    std::vector<size_t> order(sources.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<uint64_t> cost(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+      cost[i] = estimate_cost(sources[i]);
+    std::stable_sort(order.begin(), order.end(),
+                     [&cost](size_t a, size_t b) { return cost[a] > cost[b]; });
+
+    std::mutex callback_mutex;
+    for (size_t index : order) {
+      pool_.submit([&, index](int worker) {
+        BatchResult result = decode_one(worker, sources[index]);
+        result.index = index;
+        std::lock_guard<std::mutex> lock(callback_mutex);
+        on_complete(std::move(result));
+      });
+    }
+    pool_.wait();
+  }
+
+  int num_threads() const { return pool_.num_threads(); }
+
+private:
+  static uint64_t estimate_cost(const BatchSource &source) {
+    if (source.data)
+      return source.size;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(source.path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+  }
+
+  BatchResult decode_one(int worker, const BatchSource &source) {
+    BatchResult result;
+    auto &decoder = decoders_[worker];
+    try {
+      if (!decoder)
+        decoder = std::make_unique<SingleStreamDecoder>(options_);
+      if (source.data)
+        decoder->reopen_memory(source.data, source.size);
+      else
+        decoder->reopen(source.path);
+      result.audio = decoder->decode_all();
+      result.metadata = decoder->get_metadata();
+    } catch (const std::exception &e) {
+      result.error = e.what();
+      decoder.reset(); // Do not reuse a decoder left in an unknown state
+    }
+    return result;
+  }
+
+  AudioStreamOptions options_;
+  ThreadPool pool_;
+  // One decoder per worker, only touched by that worker
+  std::vector<std::unique_ptr<SingleStreamDecoder>> decoders_;
+};
+
+BatchDecoder::BatchDecoder(const AudioStreamOptions &options, int num_threads)
+    : impl_(std::make_unique<Impl>(options, num_threads)) {}
+
+BatchDecoder::~BatchDecoder() = default;
+
+std::vector<BatchResult> BatchDecoder::decode(const std::vector<BatchSource> &sources) {
+  std::vector<BatchResult> results(sources.size());
+  impl_->decode(sources, [&results](BatchResult &&result) {
+    size_t index = result.index;
+    results[index] = std::move(result);
+  });
+  return results;
+}
+
+void BatchDecoder::decode(const std::vector<BatchSource> &sources, CompletionCallback on_complete) {
+  impl_->decode(sources, on_complete);
+}
+
+int BatchDecoder::num_threads() const { return impl_->num_threads(); }
+
 // --- Device Manager ---
 
 std::vector<DeviceInfo> DeviceManager::list_audio_devices() {
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "audio-buffer.h"
 #include "metadata.h"
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #ifdef AVIOFLOW_STATIC
@@ -25,11 +28,43 @@ namespace avioflow {
 // Returns: >0 (bytes read), 0 (EOF), <0 (no data available, try again)
 using AVIOReadCallback = std::function<int(uint8_t *, int)>;
 
+// AVIO seek callback for seekable streaming input
+// whence: SEEK_SET, SEEK_CUR or SEEK_END. Returns: new position, or <0 on failure
+using AVIOSeekCallback = std::function<int64_t(int64_t, int)>;
+
 // Global configuration
 // level: "quiet", "panic", "fatal", "error", "warning", "info", "verbose", "debug", "trace"
 // If level is nullptr, it reads from the environment variable AVIOFLOW_LOG_LEVEL.
 AVIOFLOW_API void avioflow_set_log_level(const char *level = nullptr);
 
+// One decoded frame that keeps its samples alive: it holds a reference to
+// the decoder's (pooled) output buffer instead of a copy, so it stays valid
+// across later decode calls, seeks and even the decoder's destruction. The
+// buffer goes back to the pool when the last AudioFrame sharing it is gone.
+class AVIOFLOW_API AudioFrame {
+public:
+  AudioFrame() = default;
+
+  // No frame (EOF or no data available); a frame may still hold 0 samples
+  bool empty() const { return owner_ == nullptr; }
+
+  // The samples; `generation` is not used
+  const AudioFrameView &view() const { return view_; }
+
+  // Distance between consecutive channel planes in samples, when they are
+  // equally spaced in one allocation (planar output of the frame pools);
+  // num_samples when there is a single plane, 0 otherwise
+  int64_t plane_stride() const;
+
+private:
+  friend class AudioDecoder;
+  AudioFrame(const AudioFrameView &view, std::shared_ptr<void> owner)
+      : view_(view), owner_(std::move(owner)) {}
+
+  AudioFrameView view_;
+  std::shared_ptr<void> owner_;
+};
+
 // Audio Decoder - Public API using PIMPL
 class AVIOFLOW_API AudioDecoder {
 public:
@@ -46,32 +81,266 @@ public:
 
   // --- Input Methods ---
 
+  // Read only the metadata of `source` with minimal I/O: no codec is opened,
+  // and container headers that are complete (WAV, FLAC, MP3 with Xing/LAME)
+  // are trusted without analyzing packets. `options` may bound probing with
+  // probe_size / analyze_duration; probe_only is implied.
+  static Metadata probe(const std::string &source, const AudioStreamOptions &options = {});
+
   // Open from file path, URL, or device
   void open(const std::string &source);
 
-  // Open from memory buffer
+  // Open from memory buffer. The data is not copied: it must stay valid
+  // until the next open call or the decoder's destruction. Pass `owner` to
+  // have the decoder hold it alive for exactly that long.
   void open_memory(const uint8_t *data, size_t size);
+  void open_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner);
+
+  // Open the next source when decoding many in a row (e.g. short clips).
+  // Reuses the codec context and resampler of the previous source when the
+  // codec parameters and formats match, instead of setting them up again.
+  void reopen(const std::string &source);
+  void reopen_memory(const uint8_t *data, size_t size);
+  void reopen_memory(const uint8_t *data, size_t size, std::shared_ptr<const void> owner);
 
   // Open for streaming with read callback
   // Requires explicit format specification for non-seekable streams
   // Supported formats: aac, opus, pcm_s16le, pcm_f32le, wav
-  // Note: format MUST be specified in options.input_format
+  // Note: format MUST be specified in options.input_format, or implied by
+  // options.stream_description (which then also skips probing)
   void open_stream(AVIOReadCallback avio_read_callback, const AudioStreamOptions &options);
 
+  // Open for seekable streaming with read and seek callbacks
+  // The format is probed when options.input_format is not set
+  void open_stream(AVIOReadCallback avio_read_callback, AVIOSeekCallback avio_seek_callback,
+                   const AudioStreamOptions &options);
+
+  // --- Seeking ---
+
+  // Seek so that the next decoded sample is the one at `seconds`
+  // Requires a seekable source (file, memory buffer, or stream with seek callback)
+  void seek(double seconds);
+
+  // Seek so that the next decoded sample is `sample` (index in the output
+  // sample rate, i.e. counted the same way as samples returned by decoding)
+  void seek_to_sample(int64_t sample);
+
+  // Build a packet index (one demux-only pass) used by later seeks to jump
+  // straight to the right packet. Rewinds decoding to the start.
+  // See also AudioStreamOptions::use_packet_index / packet_index_path.
+  void build_packet_index();
+
+  // Write the packet index to a sidecar file for reuse across processes
+  void save_packet_index(const std::string &index_path) const;
+
   // --- Decoding Methods ---
 
-  // Decode next frame and return as AudioSamples
+  // Decode next frame and return as AudioSamples (F32 / Planar output only)
   // Returns empty AudioSamples if no data available or EOF
+  // `timeout` as for decode_next_view()
   AudioSamples decode_next();
+  AudioSamples decode_next(std::chrono::milliseconds timeout);
+
+  // Decode next frame and return a borrowed view of the decoder's buffer
+  // No allocation or copy; the view is invalidated by the next decode/open call
+  // Returns a view without planes if no data available or EOF; a frame
+  // whose output the resampler held back has planes but 0 samples
+  // With prefetch_frames it takes the next queued frame, waiting for one
+  // (up to `timeout` in the second form; an empty view then means timeout
+  // or EOF, told apart by is_finished()). Without prefetching `timeout` is
+  // ignored.
+  AudioFrameView decode_next_view();
+  AudioFrameView decode_next_view(std::chrono::milliseconds timeout);
+
+  // Decode next frame and take a reference to its buffer (no copy), see
+  // AudioFrame. Empty as for decode_next_view(); `timeout` likewise.
+  AudioFrame decode_next_frame();
+  AudioFrame decode_next_frame(std::chrono::milliseconds timeout);
+
+  // Decode into caller-owned buffers (not with prefetch_frames): one pointer per output channel for
+  // planar output, a single pointer for interleaved output, each with room
+  // for `capacity` samples per channel. The element type must match
+  // output_sample_format (float: F32, int16_t: S16, uint16_t: F16 bits).
+  // Resampling writes straight into these buffers; output that does not fit
+  // is kept for the next call. Returns samples written per channel, which is
+  // less than `capacity` only at EOF or when no data is currently available.
+  size_t decode_into(float *const *planes, size_t capacity);
+  size_t decode_into(int16_t *const *planes, size_t capacity);
+  size_t decode_into(uint16_t *const *planes, size_t capacity);
 
-  // Decode entire audio at once (offline mode)
+  // Decode the remaining audio into caller-owned buffers (see decode_into).
+  // Stops early (is_finished() stays false) if `capacity` is reached.
+  size_t decode_all_into(float *const *planes, size_t capacity);
+  size_t decode_all_into(int16_t *const *planes, size_t capacity);
+  size_t decode_all_into(uint16_t *const *planes, size_t capacity);
+
+  // Decode entire audio at once (offline mode, F32 / Planar output only)
   AudioSamples get_all_samples();
 
+  // Decode entire audio into one contiguous, 64-byte aligned buffer in the
+  // output sample format and layout. Presized from the stream duration, so
+  // it avoids repeated reallocation
+  AudioBuffer decode_all();
+
+  // Fan-out (AudioStreamOptions::branches): one decode pass, one output per
+  // branch in branch order. Views follow decode_next_view() rules; the list
+  // is empty at EOF or when no data is currently available.
+  std::vector<AudioFrameView> decode_next_branch_views();
+  std::vector<AudioBuffer> decode_all_branches();
+
   // --- Status ---
 
   bool is_finished() const;
+  uint64_t frame_generation() const;
   const Metadata &get_metadata() const;
 
+  // Shape of decoded output, for sizing decode_into() buffers: the options'
+  // format and layout, and channels after selection or remixing (known once
+  // a source is open)
+  SampleFormat output_sample_format() const;
+  SampleLayout output_layout() const;
+  int output_num_channels() const;
+
+  // Codec parameters of the opened stream. Pass it as
+  // AudioStreamOptions::stream_description to open further inputs of the
+  // same kind without format probing or stream analysis.
+  StreamDescription get_stream_description() const;
+
+  // Output frame buffers allocated vs handed out. Frame buffers are pooled:
+  // in steady state decoding allocates none, so a growing buffers_allocated
+  // signals a regression.
+  AllocationStats get_allocation_stats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// --- Push-Mode Streaming ---
+
+// Decoder fed with encoded bytes as they arrive (e.g. websocket messages)
+// instead of pulling them through a read callback. feed() copies into a
+// lock-free byte ring and poll_frames() decodes what the buffered bytes
+// allow; no call waits for input, so one event-loop thread can drive many
+// sessions. feed()/end_of_input() and poll_frames() may also run on two
+// different threads (one producer, one consumer).
+//
+// The demuxer never sees a "no data yet" read mid-header or mid-packet:
+// the format is probed once enough bytes are buffered (a probe that runs
+// out of input is discarded and retried on more data), and packets are only
+// read while at least `reserve_bytes` are buffered or input has ended.
+// `reserve_bytes` must cover the largest packet of the stream (the default
+// covers PCM, WAV, MP3 and ADTS; raise it for Ogg with large pages).
+// Stream analysis is capped at 0.5 s unless options.analyze_duration is set,
+// and skipped when the header names codec, rate and channels (WAV, raw PCM).
+class AVIOFLOW_API StreamingDecoder {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+  static constexpr size_t DEFAULT_RESERVE = 8 << 10;
+
+  // `capacity` bounds the encoded bytes buffered at once, including the
+  // whole format probe. As with open_stream(), input_format or
+  // stream_description in `options` skips format detection.
+  explicit StreamingDecoder(const AudioStreamOptions &options = {}, size_t capacity = DEFAULT_CAPACITY,
+                            size_t reserve_bytes = DEFAULT_RESERVE);
+  ~StreamingDecoder();
+
+  StreamingDecoder(const StreamingDecoder &) = delete;
+  StreamingDecoder &operator=(const StreamingDecoder &) = delete;
+  StreamingDecoder(StreamingDecoder &&) noexcept;
+  StreamingDecoder &operator=(StreamingDecoder &&) noexcept;
+
+  // Append encoded bytes. Returns the number accepted, which is less than
+  // `size` when the ring is full: poll_frames(), then feed the rest again.
+  size_t feed(const uint8_t *data, size_t size);
+
+  // No more input will come; the buffered bytes are decoded to the end
+  void end_of_input();
+
+  // Decode everything the buffered input allows: one buffer per output frame
+  // (per chunk with chunk_samples). Empty while more input is needed.
+  std::vector<AudioBuffer> poll_frames();
+
+  bool is_open() const;     // Format detected and decoder set up
+  bool is_finished() const; // Input ended and every frame returned
+
+  // Available once is_open()
+  const Metadata &get_metadata() const;
+  AllocationStats get_allocation_stats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// --- Parallel Offline Decoding ---
+
+// Decode a whole seekable input on several threads. The packet stream is cut
+// into contiguous segments, each decoded by its own decoder (with codec
+// pre-roll and the resampler restarted on the serial sample grid) straight
+// into one contiguous buffer. The result is sample-identical to
+// AudioDecoder::decode_all(). Inputs shorter than ~20 s per thread use fewer
+// threads. num_threads <= 0 uses all hardware threads.
+AVIOFLOW_API AudioBuffer decode_file_parallel(const std::string &path,
+                                              const AudioStreamOptions &options = {},
+                                              int num_threads = 0);
+
+// Same as decode_file_parallel() for an encoded file held in memory.
+// `data` must stay valid until the call returns.
+AVIOFLOW_API AudioBuffer decode_memory_parallel(const uint8_t *data, size_t size,
+                                                const AudioStreamOptions &options = {},
+                                                int num_threads = 0);
+
+// --- Batch Decoding ---
+
+// One input of a batch: a file path / URL, or an encoded buffer in memory
+struct BatchSource {
+  std::string path;
+  const uint8_t *data = nullptr; // Memory input when set; must outlive the decode call
+  size_t size = 0;
+
+  BatchSource(std::string source_path) : path(std::move(source_path)) {}
+  BatchSource(const char *source_path) : path(source_path) {}
+  BatchSource(const uint8_t *buffer, size_t buffer_size) : data(buffer), size(buffer_size) {}
+};
+
+// Decoded audio of one batch item, or the error that stopped it
+struct BatchResult {
+  size_t index = 0; // Position of the source in the input list
+  AudioBuffer audio;
+  Metadata metadata;
+  std::string error; // Empty on success
+
+  bool ok() const { return error.empty(); }
+};
+
+// Decodes many sources concurrently on a work-stealing thread pool.
+// Each worker thread reuses one decoder for all the items it processes.
+// Items are started largest first, and idle workers steal queued items, so
+// a few long files do not leave the other threads waiting at the end.
+// A failing item only sets its BatchResult::error.
+class AVIOFLOW_API BatchDecoder {
+public:
+  // Called once per item as soon as it finishes. Calls are serialized but
+  // come from worker threads, in completion order.
+  using CompletionCallback = std::function<void(BatchResult &&)>;
+
+  // num_threads <= 0 uses all hardware threads
+  explicit BatchDecoder(const AudioStreamOptions &options = {}, int num_threads = 0);
+  ~BatchDecoder();
+
+  BatchDecoder(const BatchDecoder &) = delete;
+  BatchDecoder &operator=(const BatchDecoder &) = delete;
+
+  // Decode all sources; results are returned in input order
+  std::vector<BatchResult> decode(const std::vector<BatchSource> &sources);
+
+  // Decode all sources, handing each result to `on_complete`.
+  // Returns once every item has been reported.
+  void decode(const std::vector<BatchSource> &sources, CompletionCallback on_complete);
+
+  int num_threads() const;
+
 private:
   class Impl;
   std::unique_ptr<Impl> impl_;
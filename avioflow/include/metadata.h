@@ -3,18 +3,155 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 
 namespace avioflow {
 
+// Element type of decoded output. F16 is IEEE half precision, exposed in C++
+// as its raw uint16_t bit pattern.
+enum class SampleFormat { F32, S16, F16 };
+
+// Arrangement of decoded output: one buffer per channel, or all channels in
+// one buffer with samples interleaved (L R L R ...)
+enum class SampleLayout { Planar, Interleaved };
+
+// Sample rate converter. Polyphase is the built-in polyphase FIR for
+// rational ratios (44.1/48 kHz -> 16 kHz, 8 kHz -> 16 kHz, ...) with
+// SIMD kernels; it handles float output (F32 / F16) and falls back to
+// swresample for S16 output or ratios with more than 1024 phases.
+enum class Resampler { SwResample, Polyphase };
+
+// Speed/quality trade-off of the sample rate converter. Default keeps
+// swresample's own filter; Fastest uses short filters for bulk
+// preprocessing (less stopband attenuation), High long ones for archival.
+enum class ResamplerPreset { Default, Fastest, Balanced, High };
+
+// A preset plus optional overrides of its values. filter_size and cutoff
+// apply to both engines; phase_shift and linear_interp to swresample only,
+// since the polyphase engine computes every phase of a rational ratio.
+struct ResamplerQuality {
+  ResamplerPreset preset = ResamplerPreset::Default;
+  std::optional<int> filter_size;    // Filter length in samples at the lower rate
+  std::optional<int> phase_shift;    // log2 of the number of filter phases
+  std::optional<bool> linear_interp; // Interpolate between neighbouring phases
+  std::optional<double> cutoff;      // Passband edge, fraction of the lower Nyquist frequency
+  bool soxr = false;                 // SoX engine (swresample only); ignored unless FFmpeg has libsoxr
+};
+
+// Last chunk of chunked output (AudioStreamOptions::chunk_samples) when the
+// stream ends mid-chunk: zero-padded to the full size, or only the samples left
+enum class ChunkTail { Pad, Short };
+
+// One output of a multi-rate decoder (AudioStreamOptions::branches): the
+// same decoded stream converted to its own rate, channels, format and
+// layout by its own resampler.
+struct OutputBranch {
+  std::optional<int> output_sample_rate;
+  std::optional<int> output_num_channels;
+  SampleFormat output_sample_format = SampleFormat::F32;
+  SampleLayout output_layout = SampleLayout::Planar;
+  Resampler resampler = Resampler::SwResample;
+  ResamplerQuality resampler_quality;
+};
+
+inline int bytes_per_sample(SampleFormat format) {
+  return format == SampleFormat::F32 ? 4 : 2;
+}
+
+// Pre-known description of an audio stream, for inputs that always carry
+// the same kind of audio (e.g. 8 kHz mono Opus). Passed through
+// AudioStreamOptions::stream_description, it replaces format probing and
+// stream analysis: the demuxer is opened directly and the codec is
+// configured from these fields. Capture one from an opened decoder with
+// AudioDecoder::get_stream_description().
+struct StreamDescription {
+  std::string container;          // Demuxer name (e.g. "aac" for ADTS, "ogg", "wav", "mp3")
+  std::string codec;              // Codec name (e.g. "aac", "opus", "mp3", "pcm_s16le")
+  int sample_rate = 0;
+  int num_channels = 0;
+  uint64_t channel_mask = 0;      // Native channel order; 0 = default layout for num_channels
+  std::vector<uint8_t> extradata; // Codec private data (AudioSpecificConfig, OpusHead, ...)
+  int block_align = 0;
+  int bits_per_coded_sample = 0;
+};
+
 struct AudioStreamOptions {
   std::optional<int> output_sample_rate;
   std::optional<int> output_num_channels;
   std::optional<int> input_sample_rate;
   std::optional<int> input_channels;
   std::optional<std::string> input_format;
+
+  // Element type and layout of decoded samples. Conversion happens in the
+  // same pass as resampling; sources already in the requested format (e.g.
+  // 16-bit WAV to interleaved S16) are copied without conversion.
+  SampleFormat output_sample_format = SampleFormat::F32;
+  SampleLayout output_layout = SampleLayout::Planar;
+
+  // Channel selection or mapping, applied in the conversion stage so that
+  // dropped channels are never resampled, copied or stored. Output channel
+  // c is input channel channel_indices[c], or sum_i mix_matrix[c][i] *
+  // input channel i (one row of input-channel-count coefficients per
+  // output channel). Set at most one; output_num_channels, if set, must
+  // match. Applies to the main output, not to branches.
+  std::vector<int> channel_indices;
+  std::vector<std::vector<double>> mix_matrix;
+
+  // Fixed-size output for frame-synchronous consumers (VAD, streaming ASR):
+  // decode_next() / decode_next_view() return exactly chunk_samples samples
+  // per call, each chunk starting hop_samples after the previous one
+  // (default chunk_samples; less overlaps chunks, more skips samples).
+  // decode_into() and decode_all() are not chunked.
+  // is_finished() turns true with the call that returns a partial last
+  // chunk. When no samples are left after a full chunk (the stream ends on
+  // the hop grid), the end shows only on the next call, which returns no
+  // chunk: finding it sooner would mean decoding ahead of the consumer.
+  std::optional<int> chunk_samples;
+  std::optional<int> hop_samples;
+  ChunkTail chunk_tail = ChunkTail::Pad;
+
+  // Background decoding (AudioDecoder): I/O, demux, decode and resampling
+  // run on a thread of their own, up to prefetch_frames output frames
+  // (chunks) ahead of decode_next() / decode_next_view(), which then only
+  // take the next queued frame. 0 decodes inside those calls. Stream read
+  // callbacks are then called on that thread; whole-stream, caller-buffer
+  // and fan-out decoding are not available.
+  int prefetch_frames = 0;
+
+  // Engine used when the sample rate changes
+  Resampler resampler = Resampler::SwResample;
+  ResamplerQuality resampler_quality;
+
+  // Fan-out: one demux+decode pass feeds every branch, read with
+  // decode_next_branch_views() / decode_all_branches(). The output fields
+  // above then only apply to the single-output calls. Branches do not
+  // support seeking or chunking.
+  std::vector<OutputBranch> branches;
+
+  // Packet index for fast, exact seeking (file sources). use_packet_index
+  // builds it on open, reusing an in-process cache keyed by path+mtime+size;
+  // packet_index_path names a sidecar file that is loaded if valid, or
+  // built and written otherwise.
+  bool use_packet_index = false;
+  std::optional<std::string> packet_index_path;
+
+  // Probing limits. probe_size caps the bytes read to detect the format and
+  // analyze the streams; analyze_duration caps the stream analysis (in
+  // microseconds). FFmpeg defaults apply when unset.
+  std::optional<int64_t> probe_size;
+  std::optional<int64_t> analyze_duration;
+
+  // Only fill Metadata: no codec is opened and stream analysis is skipped
+  // when the container header is complete (WAV, FLAC, MP3 with Xing/LAME).
+  // Decoding calls throw.
+  bool probe_only = false;
+
+  // Skip probing entirely and configure the codec from a known description.
+  // Its container is used as input_format unless input_format is set.
+  std::optional<StreamDescription> stream_description;
 };
 
 struct DeviceInfo {
@@ -34,10 +171,49 @@ struct Metadata {
   std::string container;     // Container format (e.g., "mp3", "wav")
 };
 
-// Output structure for complete decoded audio (offline decoding)
+// Sample buffer allocations of a decoder's output frames. Buffers come from
+// a pool and are recycled, so buffers_allocated stops growing once decoding
+// reaches a steady state while buffers_served counts every frame.
+struct AllocationStats {
+  uint64_t buffers_allocated = 0;
+  uint64_t buffers_served = 0;
+};
+
+// Output structure for complete decoded audio (offline decoding).
+// Always planar float: only produced for the default F32 / Planar output.
 struct AudioSamples {
   std::vector<std::vector<float>> data; // Planar float data per channel
   int sample_rate = 0;
 };
 
+// Borrowed, non-owning view of one decoded frame in the output sample
+// format and layout. Points directly into the decoder's internal frame, so
+// it is only valid until the next decode/open call. Compare `generation`
+// with AudioDecoder::frame_generation() to check whether it is still valid.
+struct AudioFrameView {
+  const uint8_t *const *planes = nullptr; // One per channel (planar) or one interleaved plane
+  int num_channels = 0;
+  int num_samples = 0;                    // Samples per channel
+  int sample_rate = 0;
+  SampleFormat format = SampleFormat::F32;
+  SampleLayout layout = SampleLayout::Planar;
+  uint64_t generation = 0;
+
+  bool empty() const { return planes == nullptr || num_samples == 0; }
+
+  // Samples of channel `c` (planar layout). T is float, int16_t or uint16_t
+  // (F16 bits), matching `format`.
+  template <typename T = float>
+  std::span<const T> channel(int c) const {
+    return {reinterpret_cast<const T *>(planes[c]), static_cast<size_t>(num_samples)};
+  }
+
+  // All samples, channel-interleaved (interleaved layout)
+  template <typename T = float>
+  std::span<const T> interleaved() const {
+    return {reinterpret_cast<const T *>(planes[0]),
+            static_cast<size_t>(num_samples) * num_channels};
+  }
+};
+
 } // namespace avioflow
@@ -1,4 +1,5 @@
 #include "avioflow-cxx-api.h"
+#include <cstring>
 #include <napi.h>
 
 
@@ -17,6 +18,204 @@ Napi::Value ListAudioDevices(const Napi::CallbackInfo &info) {
   return result;
 }
 
+// --- Options ---
+
+// { outputSampleRate, outputNumChannels, outputSampleFormat: 'f32' | 's16' | 'f16',
+//   outputLayout: 'planar' | 'interleaved', resampler: 'swr' | 'polyphase',
+//   resamplerQuality: { preset: 'default' | 'fastest' | 'balanced' | 'high',
+//                       filterSize, phaseShift, linearInterp, cutoff, soxr },
+//   channelIndices: number[], mixMatrix: number[][],
+//   chunkSamples, hopSamples, chunkTail: 'pad' | 'short', prefetchFrames,
+//   branches: [{ outputSampleRate, outputNumChannels, outputSampleFormat,
+//                outputLayout, resampler, resamplerQuality }, ...] }
+avioflow::AudioStreamOptions ParseOptions(const Napi::Env &env, const Napi::Object &obj) {
+  avioflow::AudioStreamOptions options;
+  if (obj.Has("outputSampleRate"))
+    options.output_sample_rate = obj.Get("outputSampleRate").As<Napi::Number>().Int32Value();
+  if (obj.Has("outputNumChannels"))
+    options.output_num_channels = obj.Get("outputNumChannels").As<Napi::Number>().Int32Value();
+  if (obj.Has("outputSampleFormat")) {
+    std::string format = obj.Get("outputSampleFormat").As<Napi::String>().Utf8Value();
+    if (format == "f32")
+      options.output_sample_format = avioflow::SampleFormat::F32;
+    else if (format == "s16")
+      options.output_sample_format = avioflow::SampleFormat::S16;
+    else if (format == "f16")
+      options.output_sample_format = avioflow::SampleFormat::F16;
+    else
+      throw Napi::TypeError::New(env, "outputSampleFormat must be 'f32', 's16' or 'f16'");
+  }
+  if (obj.Has("outputLayout")) {
+    std::string layout = obj.Get("outputLayout").As<Napi::String>().Utf8Value();
+    if (layout == "planar")
+      options.output_layout = avioflow::SampleLayout::Planar;
+    else if (layout == "interleaved")
+      options.output_layout = avioflow::SampleLayout::Interleaved;
+    else
+      throw Napi::TypeError::New(env, "outputLayout must be 'planar' or 'interleaved'");
+  }
+  if (obj.Has("resampler")) {
+    std::string resampler = obj.Get("resampler").As<Napi::String>().Utf8Value();
+    if (resampler == "swr")
+      options.resampler = avioflow::Resampler::SwResample;
+    else if (resampler == "polyphase")
+      options.resampler = avioflow::Resampler::Polyphase;
+    else
+      throw Napi::TypeError::New(env, "resampler must be 'swr' or 'polyphase'");
+  }
+  if (obj.Has("resamplerQuality")) {
+    Napi::Object quality = obj.Get("resamplerQuality").As<Napi::Object>();
+    auto &out = options.resampler_quality;
+    if (quality.Has("preset")) {
+      std::string preset = quality.Get("preset").As<Napi::String>().Utf8Value();
+      if (preset == "default")
+        out.preset = avioflow::ResamplerPreset::Default;
+      else if (preset == "fastest")
+        out.preset = avioflow::ResamplerPreset::Fastest;
+      else if (preset == "balanced")
+        out.preset = avioflow::ResamplerPreset::Balanced;
+      else if (preset == "high")
+        out.preset = avioflow::ResamplerPreset::High;
+      else
+        throw Napi::TypeError::New(env, "resamplerQuality.preset must be 'default', 'fastest', 'balanced' or 'high'");
+    }
+    if (quality.Has("filterSize"))
+      out.filter_size = quality.Get("filterSize").As<Napi::Number>().Int32Value();
+    if (quality.Has("phaseShift"))
+      out.phase_shift = quality.Get("phaseShift").As<Napi::Number>().Int32Value();
+    if (quality.Has("linearInterp"))
+      out.linear_interp = quality.Get("linearInterp").As<Napi::Boolean>().Value();
+    if (quality.Has("cutoff"))
+      out.cutoff = quality.Get("cutoff").As<Napi::Number>().DoubleValue();
+    if (quality.Has("soxr"))
+      out.soxr = quality.Get("soxr").As<Napi::Boolean>().Value();
+  }
+  if (obj.Has("channelIndices")) {
+    Napi::Array indices = obj.Get("channelIndices").As<Napi::Array>();
+    for (uint32_t i = 0; i < indices.Length(); ++i)
+      options.channel_indices.push_back(indices.Get(i).As<Napi::Number>().Int32Value());
+  }
+  if (obj.Has("mixMatrix")) {
+    Napi::Array rows = obj.Get("mixMatrix").As<Napi::Array>();
+    for (uint32_t r = 0; r < rows.Length(); ++r) {
+      Napi::Array row = rows.Get(r).As<Napi::Array>();
+      auto &weights = options.mix_matrix.emplace_back();
+      for (uint32_t c = 0; c < row.Length(); ++c)
+        weights.push_back(row.Get(c).As<Napi::Number>().DoubleValue());
+    }
+  }
+  if (obj.Has("chunkSamples"))
+    options.chunk_samples = obj.Get("chunkSamples").As<Napi::Number>().Int32Value();
+  if (obj.Has("hopSamples"))
+    options.hop_samples = obj.Get("hopSamples").As<Napi::Number>().Int32Value();
+  if (obj.Has("chunkTail")) {
+    std::string tail = obj.Get("chunkTail").As<Napi::String>().Utf8Value();
+    if (tail == "pad")
+      options.chunk_tail = avioflow::ChunkTail::Pad;
+    else if (tail == "short")
+      options.chunk_tail = avioflow::ChunkTail::Short;
+    else
+      throw Napi::TypeError::New(env, "chunkTail must be 'pad' or 'short'");
+  }
+  if (obj.Has("prefetchFrames"))
+    options.prefetch_frames = obj.Get("prefetchFrames").As<Napi::Number>().Int32Value();
+  if (obj.Has("branches")) {
+    Napi::Array branches = obj.Get("branches").As<Napi::Array>();
+    for (uint32_t i = 0; i < branches.Length(); ++i) {
+      // A branch takes the output fields of an options object
+      auto parsed = ParseOptions(env, branches.Get(i).As<Napi::Object>());
+      avioflow::OutputBranch branch;
+      branch.output_sample_rate = parsed.output_sample_rate;
+      branch.output_num_channels = parsed.output_num_channels;
+      branch.output_sample_format = parsed.output_sample_format;
+      branch.output_layout = parsed.output_layout;
+      branch.resampler = parsed.resampler;
+      branch.resampler_quality = parsed.resampler_quality;
+      options.branches.push_back(branch);
+    }
+  }
+  return options;
+}
+
+// Typed array matching the output format: Float32Array, Int16Array, or
+// Uint16Array holding IEEE half bit patterns for f16
+Napi::Value NewSampleArray(const Napi::Env &env, avioflow::SampleFormat format,
+                           const uint8_t *data, size_t count) {
+  switch (format) {
+  case avioflow::SampleFormat::S16: {
+    auto array = Napi::Int16Array::New(env, count);
+    std::memcpy(array.Data(), data, count * sizeof(int16_t));
+    return array;
+  }
+  case avioflow::SampleFormat::F16: {
+    auto array = Napi::Uint16Array::New(env, count);
+    std::memcpy(array.Data(), data, count * sizeof(uint16_t));
+    return array;
+  }
+  default: {
+    auto array = Napi::Float32Array::New(env, count);
+    std::memcpy(array.Data(), data, count * sizeof(float));
+    return array;
+  }
+  }
+}
+
+const char *FormatName(avioflow::SampleFormat format) {
+  switch (format) {
+  case avioflow::SampleFormat::S16:
+    return "s16";
+  case avioflow::SampleFormat::F16:
+    return "f16";
+  default:
+    return "f32";
+  }
+}
+
+// { sampleRate, channels, format, layout, data }: data is one typed array
+// per channel (planar) or a single interleaved typed array
+Napi::Object ViewToObject(const Napi::Env &env, const avioflow::AudioFrameView &view) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("sampleRate", view.sample_rate);
+  obj.Set("channels", static_cast<uint32_t>(view.num_channels));
+  obj.Set("format", FormatName(view.format));
+
+  if (view.layout == avioflow::SampleLayout::Interleaved) {
+    obj.Set("layout", "interleaved");
+    obj.Set("data", NewSampleArray(env, view.format, view.planes[0],
+                                   static_cast<size_t>(view.num_samples) * view.num_channels));
+    return obj;
+  }
+
+  obj.Set("layout", "planar");
+  Napi::Array channelsArr = Napi::Array::New(env, view.num_channels);
+  for (int c = 0; c < view.num_channels; ++c) {
+    channelsArr[static_cast<uint32_t>(c)] =
+        NewSampleArray(env, view.format, view.planes[c], view.num_samples);
+  }
+  obj.Set("data", channelsArr);
+  return obj;
+}
+
+Napi::Object MetadataToObject(const Napi::Env &env, const avioflow::Metadata &meta) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("duration", meta.duration);
+  obj.Set("sampleRate", meta.sample_rate);
+  obj.Set("numChannels", meta.num_channels);
+  obj.Set("codec", meta.codec);
+  obj.Set("numSamples", meta.num_samples);
+  obj.Set("sampleFormat", meta.sample_format);
+  obj.Set("bitRate", meta.bit_rate);
+  obj.Set("container", meta.container);
+  return obj;
+}
+
+Napi::Object StatsToObject(const Napi::Env &env, const avioflow::AllocationStats &stats) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("buffersAllocated", static_cast<double>(stats.buffers_allocated));
+  obj.Set("buffersServed", static_cast<double>(stats.buffers_served));
+  return obj;
+}
+
 // --- AudioDecoder ---
 
 class AudioDecoderAddon : public Napi::ObjectWrap<AudioDecoderAddon> {
@@ -26,7 +225,9 @@ public:
         env, "AudioDecoder",
         {InstanceMethod("open", &AudioDecoderAddon::Open),
          InstanceMethod("decodeNext", &AudioDecoderAddon::DecodeNext),
+         InstanceMethod("decodeNextBranches", &AudioDecoderAddon::DecodeNextBranches),
          InstanceMethod("getMetadata", &AudioDecoderAddon::GetMetadata),
+         InstanceMethod("getAllocationStats", &AudioDecoderAddon::GetAllocationStats),
          InstanceMethod("isFinished", &AudioDecoderAddon::IsFinished)});
     constructor = Napi::Persistent(func);
     constructor.SuppressDestruct();
@@ -34,9 +235,14 @@ public:
     return exports;
   }
 
+  // new AudioDecoder(options?)
   AudioDecoderAddon(const Napi::CallbackInfo &info)
-      : Napi::ObjectWrap<AudioDecoderAddon>(info),
-        decoder(std::make_unique<avioflow::AudioDecoder>()) {}
+      : Napi::ObjectWrap<AudioDecoderAddon>(info) {
+    avioflow::AudioStreamOptions options;
+    if (info.Length() > 0 && info[0].IsObject())
+      options = ParseOptions(info.Env(), info[0].As<Napi::Object>());
+    decoder = std::make_unique<avioflow::AudioDecoder>(options);
+  }
 
 private:
   static Napi::FunctionReference constructor;
@@ -51,38 +257,35 @@ private:
     decoder->open(info[0].As<Napi::String>().Utf8Value());
   }
 
+  // decodeNext(timeoutMs?): with prefetchFrames, waits at most timeoutMs
+  // for the next frame
   Napi::Value DecodeNext(const Napi::CallbackInfo &info) {
-    auto samples = decoder->decode_next();
-    if (samples.data.empty())
-      return info.Env().Null();
+    auto view = info.Length() > 0 && info[0].IsNumber()
+                    ? decoder->decode_next_view(
+                          std::chrono::milliseconds(info[0].As<Napi::Number>().Int64Value()))
+                    : decoder->decode_next_view();
+    if (!view.planes)
+      return info.Env().Null(); // No frame; a 0-sample frame is returned as such
+    return ViewToObject(info.Env(), view);
+  }
 
-    Napi::Object obj = Napi::Object::New(info.Env());
-    obj.Set("sampleRate", samples.sample_rate);
-    obj.Set("channels", static_cast<uint32_t>(samples.data.size()));
-
-    Napi::Array channelsArr = Napi::Array::New(info.Env(), samples.data.size());
-    for (size_t c = 0; c < samples.data.size(); ++c) {
-      Napi::Float32Array data =
-          Napi::Float32Array::New(info.Env(), samples.data[c].size());
-      std::copy(samples.data[c].begin(), samples.data[c].end(), data.Data());
-      channelsArr[c] = data;
-    }
-    obj.Set("data", channelsArr);
-    return obj;
+  // One frame object per branch, or null when no data
+  Napi::Value DecodeNextBranches(const Napi::CallbackInfo &info) {
+    auto views = decoder->decode_next_branch_views();
+    if (views.empty())
+      return info.Env().Null();
+    Napi::Array result = Napi::Array::New(info.Env(), views.size());
+    for (size_t i = 0; i < views.size(); ++i)
+      result[static_cast<uint32_t>(i)] = ViewToObject(info.Env(), views[i]);
+    return result;
   }
 
   Napi::Value GetMetadata(const Napi::CallbackInfo &info) {
-    auto meta = decoder->get_metadata();
-    Napi::Object obj = Napi::Object::New(info.Env());
-    obj.Set("duration", meta.duration);
-    obj.Set("sampleRate", meta.sample_rate);
-    obj.Set("numChannels", meta.num_channels);
-    obj.Set("codec", meta.codec);
-    obj.Set("numSamples", meta.num_samples);
-    obj.Set("sampleFormat", meta.sample_format);
-    obj.Set("bitRate", meta.bit_rate);
-    obj.Set("container", meta.container);
-    return obj;
+    return MetadataToObject(info.Env(), decoder->get_metadata());
+  }
+
+  Napi::Value GetAllocationStats(const Napi::CallbackInfo &info) {
+    return StatsToObject(info.Env(), decoder->get_allocation_stats());
   }
 
   Napi::Value IsFinished(const Napi::CallbackInfo &info) {
@@ -92,9 +295,104 @@ private:
 
 Napi::FunctionReference AudioDecoderAddon::constructor;
 
+// --- StreamingDecoder ---
+
+class StreamingDecoderAddon : public Napi::ObjectWrap<StreamingDecoderAddon> {
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    Napi::Function func = DefineClass(
+        env, "StreamingDecoder",
+        {InstanceMethod("feed", &StreamingDecoderAddon::Feed),
+         InstanceMethod("endOfInput", &StreamingDecoderAddon::EndOfInput),
+         InstanceMethod("pollFrames", &StreamingDecoderAddon::PollFrames),
+         InstanceMethod("isOpen", &StreamingDecoderAddon::IsOpen),
+         InstanceMethod("isFinished", &StreamingDecoderAddon::IsFinished),
+         InstanceMethod("getMetadata", &StreamingDecoderAddon::GetMetadata),
+         InstanceMethod("getAllocationStats", &StreamingDecoderAddon::GetAllocationStats)});
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    exports.Set("StreamingDecoder", func);
+    return exports;
+  }
+
+  // new StreamingDecoder(options?, { capacity, reserveBytes }?)
+  StreamingDecoderAddon(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<StreamingDecoderAddon>(info) {
+    avioflow::AudioStreamOptions options;
+    if (info.Length() > 0 && info[0].IsObject())
+      options = ParseOptions(info.Env(), info[0].As<Napi::Object>());
+    size_t capacity = avioflow::StreamingDecoder::DEFAULT_CAPACITY;
+    size_t reserve = avioflow::StreamingDecoder::DEFAULT_RESERVE;
+    if (info.Length() > 1 && info[1].IsObject()) {
+      Napi::Object ring = info[1].As<Napi::Object>();
+      if (ring.Has("capacity"))
+        capacity = static_cast<size_t>(ring.Get("capacity").As<Napi::Number>().Int64Value());
+      if (ring.Has("reserveBytes"))
+        reserve = static_cast<size_t>(ring.Get("reserveBytes").As<Napi::Number>().Int64Value());
+    }
+    decoder = std::make_unique<avioflow::StreamingDecoder>(options, capacity, reserve);
+  }
+
+private:
+  static Napi::FunctionReference constructor;
+  std::unique_ptr<avioflow::StreamingDecoder> decoder;
+
+  // feed(Buffer | Uint8Array): bytes accepted; fewer than given when full
+  Napi::Value Feed(const Napi::CallbackInfo &info) {
+    if (info.Length() < 1 || !info[0].IsTypedArray()) {
+      Napi::TypeError::New(info.Env(), "Buffer or Uint8Array expected").ThrowAsJavaScriptException();
+      return info.Env().Undefined();
+    }
+    auto bytes = info[0].As<Napi::Uint8Array>();
+    return Napi::Number::New(info.Env(), static_cast<double>(decoder->feed(bytes.Data(), bytes.ByteLength())));
+  }
+
+  void EndOfInput(const Napi::CallbackInfo &) { decoder->end_of_input(); }
+
+  // Frame objects (see ViewToObject) decodable from the input so far
+  Napi::Value PollFrames(const Napi::CallbackInfo &info) {
+    auto frames = decoder->poll_frames();
+    Napi::Array result = Napi::Array::New(info.Env(), frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      auto &frame = frames[i];
+      std::vector<const uint8_t *> planes;
+      for (int p = 0; p < frame.num_planes(); ++p)
+        planes.push_back(frame.plane_data(p));
+      avioflow::AudioFrameView view;
+      view.planes = planes.data();
+      view.num_channels = frame.num_channels();
+      view.num_samples = static_cast<int>(frame.num_samples());
+      view.sample_rate = frame.sample_rate();
+      view.format = frame.format();
+      view.layout = frame.layout();
+      result[static_cast<uint32_t>(i)] = ViewToObject(info.Env(), view);
+    }
+    return result;
+  }
+
+  Napi::Value IsOpen(const Napi::CallbackInfo &info) {
+    return Napi::Boolean::New(info.Env(), decoder->is_open());
+  }
+
+  Napi::Value IsFinished(const Napi::CallbackInfo &info) {
+    return Napi::Boolean::New(info.Env(), decoder->is_finished());
+  }
+
+  Napi::Value GetMetadata(const Napi::CallbackInfo &info) {
+    return MetadataToObject(info.Env(), decoder->get_metadata());
+  }
+
+  Napi::Value GetAllocationStats(const Napi::CallbackInfo &info) {
+    return StatsToObject(info.Env(), decoder->get_allocation_stats());
+  }
+};
+
+Napi::FunctionReference StreamingDecoderAddon::constructor;
+
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
   exports.Set("listAudioDevices", Napi::Function::New(env, ListAudioDevices));
   AudioDecoderAddon::Init(env, exports);
+  StreamingDecoderAddon::Init(env, exports);
   return exports;
 }
 
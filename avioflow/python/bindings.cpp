@@ -2,14 +2,403 @@
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
 #include <pybind11/numpy.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
+#include <unordered_map>
 #include "avioflow-cxx-api.h"
 #include "metadata.h"
 
 namespace py = pybind11;
 using namespace avioflow;
 
+static py::dtype dtype_of(SampleFormat format) {
+    return format == SampleFormat::S16 ? py::dtype::of<int16_t>()
+         : format == SampleFormat::F16 ? py::dtype::from_args(py::str("float16"))
+                                       : py::dtype::of<float>();
+}
+
+// Hand an AudioBuffer over to numpy without copying; the array owns it.
+// Planar buffers are (channels, samples), interleaved ones (samples, channels).
+static py::array buffer_to_array(AudioBuffer &&buffer) {
+    auto *owned = new AudioBuffer(std::move(buffer));
+    py::capsule owner(owned, [](void *p) { delete static_cast<AudioBuffer *>(p); });
+
+    py::dtype dtype = dtype_of(owned->format());
+    py::ssize_t item = owned->bytes_per_sample();
+    py::ssize_t channels = owned->num_channels();
+    py::ssize_t samples = owned->num_samples();
+    if (owned->layout() == SampleLayout::Planar)
+        return py::array(dtype, {channels, samples}, {owned->stride() * item, item},
+                         owned->data<uint8_t>(), owner);
+    return py::array(dtype, {samples, channels}, {channels * item, item},
+                     owned->data<uint8_t>(), owner);
+}
+
+// Same for one decoded frame: the array shares the decoder's pooled buffer,
+// which returns to the pool when the array is freed. Planes the codec
+// allocated apart from each other cannot form one array and are copied.
+static py::array frame_to_array(AudioFrame &&frame) {
+    const AudioFrameView view = frame.view();
+    py::ssize_t channels = view.num_channels;
+    if (view.num_samples == 0) {
+        // Output the resampler held back: an empty frame, not the end
+        bool planar = view.layout == SampleLayout::Planar;
+        return py::array(dtype_of(view.format), planar ? std::vector<py::ssize_t>{channels, 0}
+                                                       : std::vector<py::ssize_t>{0, channels});
+    }
+    int64_t stride = frame.plane_stride();
+    if (stride == 0) {
+        AudioBuffer buffer(view.num_channels, view.num_samples, view.sample_rate, view.format, view.layout);
+        buffer.append(view.planes, view.num_samples);
+        return buffer_to_array(std::move(buffer));
+    }
+
+    auto *owned = new AudioFrame(std::move(frame));
+    py::capsule owner(owned, [](void *p) { delete static_cast<AudioFrame *>(p); });
+
+    py::dtype dtype = dtype_of(view.format);
+    py::ssize_t item = bytes_per_sample(view.format);
+    py::ssize_t samples = view.num_samples;
+    if (view.layout == SampleLayout::Planar)
+        return py::array(dtype, {channels, samples}, {stride * item, item}, view.planes[0], owner);
+    return py::array(dtype, {samples, channels}, {channels * item, item}, view.planes[0], owner);
+}
+
+// --- DLPack ---
+// The stable ABI of dlpack.h (v0.8), declared here rather than vendored:
+// torch.from_dlpack() / jax.dlpack.from_dlpack() take an AudioBuffer without
+// a copy, and tensors they own can be decoded into.
+namespace dlpack {
+constexpr int32_t kCPU = 1;
+constexpr uint8_t kInt = 0, kFloat = 2;
+
+struct Device { int32_t device_type; int32_t device_id; };
+struct DataType { uint8_t code; uint8_t bits; uint16_t lanes; };
+struct Tensor {
+    void *data;
+    Device device;
+    int32_t ndim;
+    DataType dtype;
+    int64_t *shape;
+    int64_t *strides; // In elements; nullptr for compact row-major
+    uint64_t byte_offset;
+};
+struct ManagedTensor {
+    Tensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(ManagedTensor *self);
+};
+
+static DataType data_type(SampleFormat format) {
+    return format == SampleFormat::S16 ? DataType{kInt, 16, 1}
+         : format == SampleFormat::F16 ? DataType{kFloat, 16, 1}
+                                       : DataType{kFloat, 32, 1};
+}
+} // namespace dlpack
+
+// A bound AudioBuffer exported as a "dltensor" capsule. The tensor keeps a
+// reference to the Python object that owns the samples; the consumer drops
+// it through the deleter, from any thread.
+struct DLPackExport {
+    dlpack::ManagedTensor tensor{};
+    int64_t shape[2];
+    int64_t strides[2];
+    py::object owner;
+};
+
+static py::capsule export_dlpack(py::object self) {
+    const AudioBuffer &buffer = self.cast<const AudioBuffer &>();
+    auto *exported = new DLPackExport();
+    exported->owner = self;
+    int64_t channels = buffer.num_channels(), samples = buffer.num_samples();
+    // Same shapes as buffer_to_array()
+    if (buffer.layout() == SampleLayout::Planar) {
+        exported->shape[0] = channels, exported->shape[1] = samples;
+        exported->strides[0] = buffer.stride(), exported->strides[1] = 1;
+    } else {
+        exported->shape[0] = samples, exported->shape[1] = channels;
+        exported->strides[0] = channels, exported->strides[1] = 1;
+    }
+    auto &tensor = exported->tensor;
+    tensor.dl_tensor = {const_cast<uint8_t *>(buffer.data<uint8_t>()), {dlpack::kCPU, 0}, 2,
+                        dlpack::data_type(buffer.format()), exported->shape, exported->strides, 0};
+    tensor.manager_ctx = exported;
+    tensor.deleter = [](dlpack::ManagedTensor *self) {
+        py::gil_scoped_acquire acquire;
+        delete static_cast<DLPackExport *>(self->manager_ctx);
+    };
+    // A consumer renames the capsule to "used_dltensor" and owns the tensor
+    // from then on; an unconsumed capsule deletes it itself
+    return py::capsule(&tensor, "dltensor", [](PyObject *capsule) {
+        if (!PyCapsule_IsValid(capsule, "dltensor"))
+            return;
+        auto *tensor = static_cast<dlpack::ManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+        tensor->deleter(tensor);
+    });
+}
+
+// Caller-provided memory to decode into: a writable buffer-protocol object
+// (numpy array, ...) or a CPU tensor exporting DLPack (torch, JAX). Holds
+// the buffer export or the consumed tensor until decoding is done.
+class OutputTarget {
+public:
+    // Resolve `out` against the decoder's output shape: planar output takes
+    // (channels, capacity) with contiguous rows, interleaved output
+    // (capacity, channels) contiguous; 1-D works for mono
+    OutputTarget(const py::object &out, SampleFormat format, SampleLayout layout, int channels) {
+        uint8_t *data;
+        std::vector<int64_t> shape, strides; // Strides in elements
+        bool dtype_ok;
+        if (PyObject_CheckBuffer(out.ptr())) {
+            info_ = py::reinterpret_borrow<py::buffer>(out).request(true);
+            data = static_cast<uint8_t *>(info_.ptr);
+            std::string code = info_.format;
+            if (!code.empty() && (code[0] == '<' || code[0] == '=' || code[0] == '@'))
+                code.erase(0, 1);
+            dtype_ok = code == (format == SampleFormat::S16 ? "h" : format == SampleFormat::F16 ? "e" : "f");
+            for (py::ssize_t i = 0; i < info_.ndim; ++i) {
+                shape.push_back(info_.shape[i]);
+                strides.push_back(info_.strides[i] % info_.itemsize == 0 ? info_.strides[i] / info_.itemsize : -1);
+            }
+        } else if (py::hasattr(out, "__dlpack__")) {
+            py::capsule capsule = out.attr("__dlpack__")();
+            managed_.reset(static_cast<dlpack::ManagedTensor *>(PyCapsule_GetPointer(capsule.ptr(), "dltensor")));
+            if (!managed_)
+                throw py::error_already_set();
+            PyCapsule_SetName(capsule.ptr(), "used_dltensor"); // Consumed: ours to delete
+            const dlpack::Tensor &t = managed_->dl_tensor;
+            if (t.device.device_type != dlpack::kCPU)
+                throw std::invalid_argument("Output tensor must be in CPU memory");
+            data = static_cast<uint8_t *>(t.data) + t.byte_offset;
+            dlpack::DataType expected = dlpack::data_type(format);
+            dtype_ok = t.dtype.code == expected.code && t.dtype.bits == expected.bits && t.dtype.lanes == 1;
+            shape.assign(t.shape, t.shape + t.ndim);
+            if (t.strides) {
+                strides.assign(t.strides, t.strides + t.ndim);
+            } else {
+                strides.resize(t.ndim);
+                for (int64_t i = t.ndim - 1, step = 1; i >= 0; step *= shape[i], --i)
+                    strides[i] = step;
+            }
+        } else {
+            throw py::type_error("Output must support the buffer protocol or __dlpack__");
+        }
+        if (!dtype_ok)
+            throw std::invalid_argument("Output dtype does not match output_sample_format");
+
+        size_t item = static_cast<size_t>(bytes_per_sample(format));
+        if (shape.size() == 1 && channels == 1 && strides[0] == 1) {
+            capacity_ = static_cast<size_t>(shape[0]);
+            planes_.push_back(data);
+        } else if (shape.size() == 2 && layout == SampleLayout::Planar && shape[0] == channels && strides[1] == 1 &&
+                   (strides[0] >= shape[1] || channels == 1)) {
+            capacity_ = static_cast<size_t>(shape[1]);
+            for (int c = 0; c < channels; ++c)
+                planes_.push_back(data + static_cast<size_t>(c * strides[0]) * item);
+        } else if (shape.size() == 2 && layout == SampleLayout::Interleaved && shape[1] == channels &&
+                   strides[1] == 1 && (strides[0] == channels || shape[0] <= 1)) {
+            capacity_ = static_cast<size_t>(shape[0]);
+            planes_.push_back(data);
+        } else {
+            std::ostringstream msg;
+            msg << "Output must be " << (layout == SampleLayout::Planar ? "(channels, samples)" : "(samples, channels)")
+                << " with channels = " << channels << " and contiguous samples";
+            throw std::invalid_argument(msg.str());
+        }
+    }
+
+    // Samples written per channel; call without the GIL
+    size_t decode(AudioDecoder &decoder, SampleFormat format, bool all) {
+        switch (format) {
+        case SampleFormat::S16: return decode_as<int16_t>(decoder, all);
+        case SampleFormat::F16: return decode_as<uint16_t>(decoder, all);
+        default: return decode_as<float>(decoder, all);
+        }
+    }
+
+private:
+    template <typename T> size_t decode_as(AudioDecoder &decoder, bool all) {
+        std::vector<T *> planes;
+        for (uint8_t *plane : planes_)
+            planes.push_back(reinterpret_cast<T *>(plane));
+        return all ? decoder.decode_all_into(planes.data(), capacity_) : decoder.decode_into(planes.data(), capacity_);
+    }
+
+    static void release(dlpack::ManagedTensor *tensor) {
+        if (tensor->deleter)
+            tensor->deleter(tensor);
+    }
+
+    py::buffer_info info_;
+    std::unique_ptr<dlpack::ManagedTensor, void (*)(dlpack::ManagedTensor *)> managed_{nullptr, release};
+    std::vector<uint8_t *> planes_;
+    size_t capacity_ = 0;
+};
+
+// Run native work (I/O, decoding) without the GIL, so that other Python
+// threads, e.g. DataLoader workers, keep running meanwhile
+template <typename Fn> static auto without_gil(Fn &&fn) {
+    py::gil_scoped_release release;
+    return fn();
+}
+
+// Encoded bytes of a buffer-protocol object (bytes, bytearray, memoryview,
+// numpy array, mmap), borrowed without a copy. The returned owner holds the
+// buffer export, which keeps the object alive and, for resizable objects
+// like bytearray, prevents resizing; the decoder releases it when it closes
+// the input, GIL held or not.
+static std::shared_ptr<const void> borrow_bytes(const py::buffer &data, const uint8_t *&bytes, size_t &size) {
+    auto *view = new Py_buffer();
+    // Simple request: the exporter must provide one contiguous block
+    if (PyObject_GetBuffer(data.ptr(), view, PyBUF_SIMPLE) != 0) {
+        delete view;
+        throw py::error_already_set();
+    }
+    bytes = static_cast<const uint8_t *>(view->buf);
+    size = static_cast<size_t>(view->len);
+    return std::shared_ptr<const void>(view, [](const void *p) {
+        py::gil_scoped_acquire acquire;
+        auto *owned = static_cast<Py_buffer *>(const_cast<void *>(p));
+        PyBuffer_Release(owned);
+        delete owned;
+    });
+}
+
+// Exception raised by an open_stream() read callback. It must not unwind
+// through FFmpeg, so the callback stores it and ends the stream; the Python
+// call that was decoding raises it once the native work has returned.
+// Accessed with the GIL held.
+struct ReadError {
+    std::exception_ptr error;
+};
+
+static std::unordered_map<const AudioDecoder *, std::shared_ptr<ReadError>> &read_errors() {
+    static std::unordered_map<const AudioDecoder *, std::shared_ptr<ReadError>> errors;
+    return errors;
+}
+
+static void raise_read_error(const AudioDecoder &decoder) {
+    auto it = read_errors().find(&decoder);
+    if (it != read_errors().end() && it->second->error)
+        std::rethrow_exception(std::exchange(it->second->error, nullptr));
+}
+
+// without_gil() for decoder calls that may read through a Python callback:
+// the callback's exception replaces the decoder's own outcome
+template <typename Fn> static auto reading(const AudioDecoder &decoder, Fn &&fn) {
+    try {
+        if constexpr (std::is_void_v<std::invoke_result_t<Fn &>>) {
+            without_gil(fn);
+            raise_read_error(decoder);
+        } else {
+            auto result = without_gil(fn);
+            raise_read_error(decoder);
+            return result;
+        }
+    } catch (...) {
+        raise_read_error(decoder);
+        throw;
+    }
+}
+
+// open_stream() read callback: read(size) returns at most `size` bytes (more is a ValueError), b""
+// at the end, or None when no data is available yet. The decoder calls it
+// without the GIL (possibly from its prefetch thread), so it takes the GIL
+// for the call only.
+static AVIOReadCallback python_read_callback(py::function read, std::shared_ptr<ReadError> failure) {
+    // Released wherever the decoder drops it, GIL held or not
+    std::shared_ptr<py::function> fn(new py::function(std::move(read)), [](py::function *f) {
+        py::gil_scoped_acquire acquire;
+        delete f;
+    });
+    return [fn, failure](uint8_t *buf, int size) -> int {
+        py::gil_scoped_acquire acquire;
+        if (failure->error)
+            return 0; // Still at the end until the error is raised
+        try {
+            py::object data = (*fn)(size);
+            if (data.is_none())
+                return -1;
+            // One contiguous block, as for open_memory()
+            const uint8_t *bytes = nullptr;
+            size_t count = 0;
+            auto view = borrow_bytes(py::reinterpret_borrow<py::buffer>(data), bytes, count);
+            if (count > static_cast<size_t>(size))
+                throw py::value_error("read(size) returned " + std::to_string(count) +
+                                      " bytes, more than the " + std::to_string(size) + " requested");
+            std::memcpy(buf, bytes, count);
+            return static_cast<int>(count);
+        } catch (...) {
+            failure->error = std::current_exception();
+            return 0;
+        }
+    };
+}
+
+static size_t decode_to(AudioDecoder &decoder, const py::object &out, bool all) {
+    SampleFormat format = decoder.output_sample_format();
+    OutputTarget target(out, format, decoder.output_layout(), decoder.output_num_channels());
+    return reading(decoder, [&] { return target.decode(decoder, format, all); });
+}
+
+// Batch results as one zero-padded array, (batch, channels, max_len) for
+// planar output or (batch, max_len, channels) for interleaved output, plus
+// the valid length of every item (0 for failed ones)
+static py::tuple pad_results(std::vector<BatchResult> &results, SampleFormat format, SampleLayout layout) {
+    py::ssize_t batch = static_cast<py::ssize_t>(results.size());
+    py::ssize_t channels = 0, max_len = 0;
+    for (const auto &r : results) {
+        channels = std::max<py::ssize_t>(channels, r.audio.num_channels());
+        max_len = std::max<py::ssize_t>(max_len, r.audio.num_samples());
+    }
+    bool planar = layout == SampleLayout::Planar;
+    py::array padded(dtype_of(format), planar ? std::vector<py::ssize_t>{batch, channels, max_len}
+                                              : std::vector<py::ssize_t>{batch, max_len, channels});
+    py::array_t<int64_t> lengths(batch);
+    for (py::ssize_t i = 0; i < batch; ++i)
+        lengths.mutable_at(i) = results[i].audio.num_samples();
+
+    auto *out = static_cast<uint8_t *>(padded.mutable_data());
+    size_t item = static_cast<size_t>(bytes_per_sample(format));
+    size_t item_bytes = static_cast<size_t>(channels * max_len) * item;
+    without_gil([&] {
+        std::memset(out, 0, item_bytes * results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            const AudioBuffer &audio = results[i].audio;
+            size_t len = static_cast<size_t>(audio.num_samples());
+            size_t src_channels = static_cast<size_t>(audio.num_channels());
+            uint8_t *dst = out + i * item_bytes;
+            if (planar) {
+                for (size_t c = 0; c < src_channels; ++c)
+                    std::memcpy(dst + c * max_len * item, audio.data<uint8_t>() + c * audio.stride() * item, len * item);
+            } else if (src_channels == static_cast<size_t>(channels)) {
+                std::memcpy(dst, audio.data<uint8_t>(), len * src_channels * item);
+            } else {
+                // Fewer channels than the widest item: frame by frame
+                for (size_t s = 0; s < len; ++s)
+                    std::memcpy(dst + s * channels * item, audio.data<uint8_t>() + s * src_channels * item,
+                                src_channels * item);
+            }
+        }
+    });
+    return py::make_tuple(padded, lengths);
+}
+
+// Python drops decoders with the GIL held; a prefetch thread blocked on the
+// GIL in a read callback must be able to finish before it is joined
+struct ReleaseGilDelete {
+    void operator()(AudioDecoder *decoder) const {
+        read_errors().erase(decoder);
+        py::gil_scoped_release release;
+        delete decoder;
+    }
+};
+
 PYBIND11_MODULE(_avioflow, m) {
     m.doc() = "avioflow: High-performance audio decoding library powered by FFmpeg";
 
@@ -19,7 +408,63 @@ PYBIND11_MODULE(_avioflow, m) {
     }, py::arg("level") = "info", 
        "Set FFmpeg log level. Options: quiet, fatal, error, warning, info, debug, trace");
 
+    // --- Enums ---
+    py::enum_<SampleFormat>(m, "SampleFormat", "Element type of decoded output")
+        .value("F32", SampleFormat::F32, "float32")
+        .value("S16", SampleFormat::S16, "int16")
+        .value("F16", SampleFormat::F16, "float16");
+
+    py::enum_<SampleLayout>(m, "SampleLayout", "Channel arrangement of decoded output")
+        .value("PLANAR", SampleLayout::Planar, "(channels, samples)")
+        .value("INTERLEAVED", SampleLayout::Interleaved, "(samples, channels)");
+
+    py::enum_<Resampler>(m, "Resampler", "Engine used when the sample rate changes")
+        .value("SWRESAMPLE", Resampler::SwResample, "FFmpeg swresample")
+        .value("POLYPHASE", Resampler::Polyphase, "Built-in SIMD polyphase filter (float output)");
+
+    py::enum_<ResamplerPreset>(m, "ResamplerPreset", "Speed/quality trade-off of the sample rate converter")
+        .value("DEFAULT", ResamplerPreset::Default, "swresample's own filter")
+        .value("FASTEST", ResamplerPreset::Fastest, "Short filter, for bulk preprocessing")
+        .value("BALANCED", ResamplerPreset::Balanced, "Shorter filter, passband to ~0.8 Nyquist")
+        .value("HIGH", ResamplerPreset::High, "Long filter, for archival");
+
+    py::enum_<ChunkTail>(m, "ChunkTail", "Last chunk of chunked output when the stream ends mid-chunk")
+        .value("PAD", ChunkTail::Pad, "Zero-padded to chunk_samples")
+        .value("SHORT", ChunkTail::Short, "Only the samples left");
+
     // --- Structs ---
+    py::class_<StreamDescription>(m, "StreamDescription", "Pre-known stream parameters; skips probing when passed in AudioStreamOptions")
+        .def(py::init<>())
+        .def_readwrite("container", &StreamDescription::container, "(str): Demuxer name (e.g. 'aac' for ADTS, 'ogg', 'wav').")
+        .def_readwrite("codec", &StreamDescription::codec, "(str): Codec name (e.g. 'aac', 'opus', 'mp3').")
+        .def_readwrite("sample_rate", &StreamDescription::sample_rate, "(int): Sample rate (Hz).")
+        .def_readwrite("num_channels", &StreamDescription::num_channels, "(int): Channel count.")
+        .def_readwrite("channel_mask", &StreamDescription::channel_mask, "(int): Native channel mask; 0 for the default layout.")
+        .def_property("extradata",
+            [](const StreamDescription& self) { return py::bytes(reinterpret_cast<const char*>(self.extradata.data()), self.extradata.size()); },
+            [](StreamDescription& self, py::bytes data) { std::string s = data; self.extradata.assign(s.begin(), s.end()); },
+            "(bytes): Codec private data.")
+        .def_readwrite("block_align", &StreamDescription::block_align)
+        .def_readwrite("bits_per_coded_sample", &StreamDescription::bits_per_coded_sample);
+
+    py::class_<ResamplerQuality>(m, "ResamplerQuality", "Resampler preset plus optional overrides of its values")
+        .def(py::init<>())
+        .def_readwrite("preset", &ResamplerQuality::preset, "(ResamplerPreset): Base settings.")
+        .def_readwrite("filter_size", &ResamplerQuality::filter_size, "(int or None): Filter length at the lower rate.")
+        .def_readwrite("phase_shift", &ResamplerQuality::phase_shift, "(int or None): log2 of the phase count (swresample only).")
+        .def_readwrite("linear_interp", &ResamplerQuality::linear_interp, "(bool or None): Interpolate between phases (swresample only).")
+        .def_readwrite("cutoff", &ResamplerQuality::cutoff, "(float or None): Passband edge as a fraction of the lower Nyquist frequency.")
+        .def_readwrite("soxr", &ResamplerQuality::soxr, "(bool): Use the SoX engine when FFmpeg has libsoxr.");
+
+    py::class_<OutputBranch>(m, "OutputBranch", "One output of a multi-rate decoder, converted by its own resampler")
+        .def(py::init<>())
+        .def_readwrite("output_sample_rate", &OutputBranch::output_sample_rate, "(int or None): Output sample rate (Hz). If null, keeps original.")
+        .def_readwrite("output_num_channels", &OutputBranch::output_num_channels, "(int or None): Output channel count. If null, keeps original.")
+        .def_readwrite("output_sample_format", &OutputBranch::output_sample_format, "(SampleFormat): Output element type.")
+        .def_readwrite("output_layout", &OutputBranch::output_layout, "(SampleLayout): PLANAR or INTERLEAVED.")
+        .def_readwrite("resampler", &OutputBranch::resampler, "(Resampler): SWRESAMPLE or POLYPHASE.")
+        .def_readwrite("resampler_quality", &OutputBranch::resampler_quality, "(ResamplerQuality): Preset and filter overrides.");
+
     py::class_<AudioStreamOptions>(m, "AudioStreamOptions", "Configuration options for audio decoding and resampling")
         .def(py::init<>())
         .def_readwrite("output_sample_rate", &AudioStreamOptions::output_sample_rate, "(int or None): Target output sample rate (Hz). If null, keeps original.")
@@ -27,6 +472,23 @@ PYBIND11_MODULE(_avioflow, m) {
         .def_readwrite("input_sample_rate", &AudioStreamOptions::input_sample_rate, "(int or None): Force input sample rate (only for raw PCM).")
         .def_readwrite("input_channels", &AudioStreamOptions::input_channels, "(int or None): Force input channel count (only for raw PCM).")
         .def_readwrite("input_format", &AudioStreamOptions::input_format, "(str or None): Force input format hint (e.g., 'wav', 'mp3', 's16le').")
+        .def_readwrite("output_sample_format", &AudioStreamOptions::output_sample_format, "(SampleFormat): Output element type (F32, S16 or F16).")
+        .def_readwrite("output_layout", &AudioStreamOptions::output_layout, "(SampleLayout): PLANAR (channels, samples) or INTERLEAVED (samples, channels).")
+        .def_readwrite("channel_indices", &AudioStreamOptions::channel_indices, "(list[int]): Input channels to keep, in output order; others are never resampled or stored.")
+        .def_readwrite("mix_matrix", &AudioStreamOptions::mix_matrix, "(list[list[float]]): One row of input-channel weights per output channel.")
+        .def_readwrite("chunk_samples", &AudioStreamOptions::chunk_samples, "(int or None): decode_next() returns exactly this many samples per call.")
+        .def_readwrite("hop_samples", &AudioStreamOptions::hop_samples, "(int or None): Distance between chunk starts; defaults to chunk_samples (less overlaps, more skips).")
+        .def_readwrite("chunk_tail", &AudioStreamOptions::chunk_tail, "(ChunkTail): PAD or SHORT last chunk.")
+        .def_readwrite("prefetch_frames", &AudioStreamOptions::prefetch_frames, "(int): Decode on a background thread up to this many frames ahead of decode_next(); 0 decodes inside it.")
+        .def_readwrite("resampler", &AudioStreamOptions::resampler, "(Resampler): SWRESAMPLE or POLYPHASE; POLYPHASE falls back to swresample for S16 output.")
+        .def_readwrite("resampler_quality", &AudioStreamOptions::resampler_quality, "(ResamplerQuality): Preset and filter overrides for the resampler.")
+        .def_readwrite("branches", &AudioStreamOptions::branches, "(list[OutputBranch]): Outputs fed by one decode pass; read with decode_all_branches().")
+        .def_readwrite("use_packet_index", &AudioStreamOptions::use_packet_index, "(bool): Build a packet index on open (cached per path+mtime+size) for fast, exact seeking.")
+        .def_readwrite("packet_index_path", &AudioStreamOptions::packet_index_path, "(str or None): Packet index sidecar file; loaded if valid, otherwise built and written.")
+        .def_readwrite("probe_size", &AudioStreamOptions::probe_size, "(int or None): Max bytes read to detect the format and analyze streams.")
+        .def_readwrite("analyze_duration", &AudioStreamOptions::analyze_duration, "(int or None): Max stream analysis duration in microseconds.")
+        .def_readwrite("probe_only", &AudioStreamOptions::probe_only, "(bool): Only read metadata; no codec is opened and decoding raises.")
+        .def_readwrite("stream_description", &AudioStreamOptions::stream_description, "(StreamDescription or None): Known stream parameters; skips format probing and stream analysis.")
         .def("__repr__", [](const AudioStreamOptions& self) {
             std::stringstream ss;
             ss << "<avioflow.AudioStreamOptions"
@@ -54,6 +516,10 @@ PYBIND11_MODULE(_avioflow, m) {
             return ss.str();
         });
 
+    py::class_<AllocationStats>(m, "AllocationStats", "Output frame buffer allocations of a decoder")
+        .def_readonly("buffers_allocated", &AllocationStats::buffers_allocated, "(int): Buffers allocated by the frame pools")
+        .def_readonly("buffers_served", &AllocationStats::buffers_served, "(int): Frame buffers handed out, mostly recycled");
+
     py::class_<Metadata>(m, "Metadata", "Audio stream information")
         .def(py::init<>())
         .def_readonly("duration", &Metadata::duration, "(float): Duration in seconds")
@@ -77,41 +543,215 @@ PYBIND11_MODULE(_avioflow, m) {
             return ss.str();
         });
 
-    py::class_<AudioSamples>(m, "AudioSamples", "Buffer containing decoded audio data")
-        .def(py::init<>())
-        .def_readonly("data", &AudioSamples::data, "(list[list[float]]): Planar float data: (channels, samples)")
-        .def_readonly("sample_rate", &AudioSamples::sample_rate, "(int): The sample rate of this data")
-        .def("__repr__", [](const AudioSamples& self) {
-            std::stringstream ss;
-            ss << "<avioflow.AudioSamples"
-               << " channels=" << self.data.size()
-               << " samples_per_channel=" << (self.data.empty() ? 0 : self.data[0].size())
-               << " sample_rate=" << self.sample_rate
-               << ">";
-            return ss.str();
-        });
-
     // --- Main Decoder Class ---
-    py::class_<AudioDecoder>(m, "AudioDecoder", "Main class for audio decoding and device capture")
+    py::class_<AudioBuffer>(m, "AudioBuffer", py::buffer_protocol(),
+                            "Decoded audio in native memory, shared without a copy with numpy (buffer protocol) and "
+                            "torch/JAX (DLPack). Planar: (channels, samples), interleaved: (samples, channels).")
+        .def_buffer([](AudioBuffer& self) {
+            py::ssize_t item = self.bytes_per_sample();
+            py::ssize_t channels = self.num_channels();
+            py::ssize_t samples = self.num_samples();
+            std::string format = self.format() == SampleFormat::S16 ? "h" : self.format() == SampleFormat::F16 ? "e" : "f";
+            if (self.layout() == SampleLayout::Planar)
+                return py::buffer_info(self.data<uint8_t>(), item, format, 2, {channels, samples},
+                                       {self.stride() * item, item});
+            return py::buffer_info(self.data<uint8_t>(), item, format, 2, {samples, channels}, {channels * item, item});
+        })
+        .def_property_readonly("shape", [](const AudioBuffer& self) {
+            return self.layout() == SampleLayout::Planar ? py::make_tuple(self.num_channels(), self.num_samples())
+                                                          : py::make_tuple(self.num_samples(), self.num_channels());
+        })
+        .def_property_readonly("dtype", [](const AudioBuffer& self) { return dtype_of(self.format()); })
+        .def_property_readonly("sample_rate", &AudioBuffer::sample_rate)
+        .def_property_readonly("num_channels", &AudioBuffer::num_channels)
+        .def_property_readonly("num_samples", &AudioBuffer::num_samples)
+        .def("__dlpack__", [](py::object self, py::object stream, py::kwargs) {
+            // CPU memory: there is no stream to synchronize with
+            (void)stream;
+            return export_dlpack(self);
+        }, py::arg("stream") = py::none(), "Export as a DLPack capsule (no copy)")
+        .def("__dlpack_device__", [](const AudioBuffer&) {
+            return py::make_tuple(dlpack::kCPU, 0);
+        }, "DLPack device: (kDLCPU, 0)");
+
+    py::class_<AudioDecoder, std::unique_ptr<AudioDecoder, ReleaseGilDelete>>(m, "AudioDecoder", "Main class for audio decoding and device capture")
         .def(py::init<const AudioStreamOptions&>(), py::arg("options") = AudioStreamOptions(), "Initialize decoder with optional resampling settings")
-        .def("open", &AudioDecoder::open, py::arg("source"), 
-             "Open an audio source (file path, URL, or wasapi_loopback/audio=...)")
-        .def("open_memory", [](AudioDecoder& self, py::bytes data) {
-            std::string s = data;
-            self.open_memory(reinterpret_cast<const uint8_t*>(s.data()), s.size());
-        }, py::arg("data"), "Open audio from a memory buffer")
-        .def("open_stream", &AudioDecoder::open_stream, py::arg("callback"), py::arg("options") = AudioStreamOptions(), 
-             "Open audio from a custom stream-like object with a read callback")
-        .def("decode_next", [](AudioDecoder& self) -> py::object {
-            auto samples = self.decode_next();
-            if (samples.data.empty()) return py::none();
-            return py::cast(samples);
-        }, "Decode next available frame. Returns AudioSamples or None if end of stream reached.")
-        .def("get_all_samples", &AudioDecoder::get_all_samples, "Synchronously decode the entire source and return all samples.")
+        .def("open", [](AudioDecoder& self, const std::string& source) {
+            read_errors().erase(&self);
+            without_gil([&] { self.open(source); });
+        }, py::arg("source"),
+           "Open an audio source (file path, URL, or wasapi_loopback/audio=...)")
+        .def("open_memory", [](AudioDecoder& self, py::buffer data) {
+            const uint8_t *bytes = nullptr;
+            size_t size = 0;
+            auto owner = borrow_bytes(data, bytes, size);
+            read_errors().erase(&self);
+            without_gil([&] { self.open_memory(bytes, size, std::move(owner)); });
+        }, py::arg("data"),
+           "Open audio from any contiguous buffer (bytes, bytearray, memoryview, numpy array, mmap). "
+           "The bytes are not copied; the decoder keeps the object alive until the next open.")
+        .def("reopen", [](AudioDecoder& self, const std::string& source) {
+            read_errors().erase(&self);
+            without_gil([&] { self.reopen(source); });
+        }, py::arg("source"),
+           "Open the next source, reusing codec and resampler setup when formats match")
+        .def("reopen_memory", [](AudioDecoder& self, py::buffer data) {
+            const uint8_t *bytes = nullptr;
+            size_t size = 0;
+            auto owner = borrow_bytes(data, bytes, size);
+            read_errors().erase(&self);
+            without_gil([&] { self.reopen_memory(bytes, size, std::move(owner)); });
+        }, py::arg("data"), "Like open_memory(), reusing codec and resampler setup when formats match")
+        .def("open_stream", [](AudioDecoder& self, py::function read, const AudioStreamOptions& options) {
+            auto failure = std::make_shared<ReadError>();
+            read_errors()[&self] = failure;
+            auto callback = python_read_callback(std::move(read), failure);
+            reading(self, [&] { self.open_stream(std::move(callback), options); });
+        }, py::arg("callback"), py::arg("options") = AudioStreamOptions(),
+           "Open audio from a read callback: callback(size) returns at most size bytes (any buffer; more raises ValueError), b'' at the end, "
+           "or None when no data is available yet. An exception it raises ends the stream and is re-raised by "
+           "the decoder call that was reading.")
+        .def("seek", [](AudioDecoder& self, double seconds) {
+            reading(self, [&] { self.seek(seconds); });
+        }, py::arg("seconds"),
+           "Seek so that the next decoded sample is the one at `seconds`")
+        .def("seek_to_sample", [](AudioDecoder& self, int64_t sample) {
+            reading(self, [&] { self.seek_to_sample(sample); });
+        }, py::arg("sample"),
+           "Seek to a sample index (in the output sample rate)")
+        .def("build_packet_index", [](AudioDecoder& self) {
+            reading(self, [&] { self.build_packet_index(); });
+        }, "Build a packet index for fast seeking; rewinds to the start")
+        .def("save_packet_index", &AudioDecoder::save_packet_index, py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+             "Write the packet index to a sidecar file")
+        .def("decode_next", [](AudioDecoder& self, std::optional<double> timeout) -> py::object {
+            AudioFrame frame = reading(self, [&] {
+                return timeout ? self.decode_next_frame(std::chrono::milliseconds(std::llround(*timeout * 1000)))
+                               : self.decode_next_frame();
+            });
+            if (frame.empty()) return py::none();
+            return frame_to_array(std::move(frame));
+        }, py::arg("timeout") = py::none(),
+           "Decode next available frame into a numpy array (no copy) in the output sample format and layout. "
+           "Returns None if no data is available or the stream ended; a frame whose output the resampler "
+           "held back comes as an array with 0 samples. "
+           "With prefetch_frames, waits at most `timeout` seconds (None: no limit) for the next frame.")
+        .def("get_all_samples", [](AudioDecoder& self) {
+            return buffer_to_array(reading(self, [&] { return self.decode_all(); }));
+        }, "Synchronously decode the entire source into a numpy array (same as decode_all()).")
+        .def("decode_all", [](AudioDecoder& self) {
+            return buffer_to_array(reading(self, [&] { return self.decode_all(); }));
+        }, "Decode the entire source into a numpy array in the output sample format and layout.")
+        .def("decode_all_buffer", [](AudioDecoder& self) {
+            return reading(self, [&] { return self.decode_all(); });
+        }, "Decode the entire source into an AudioBuffer, which torch.from_dlpack() and np.asarray() take without a copy.")
+        .def("decode_into", [](AudioDecoder& self, py::object out) {
+            return decode_to(self, out, false);
+        }, py::arg("out"),
+           "Decode the next samples straight into `out`: a writable numpy array or a CPU torch/JAX tensor "
+           "(DLPack) of the output dtype, shaped (channels, n) for planar or (n, channels) for interleaved output. "
+           "Returns samples written per channel, fewer than n only at the end or when no data is available.")
+        .def("decode_all_into", [](AudioDecoder& self, py::object out) {
+            return decode_to(self, out, true);
+        }, py::arg("out"), "Decode the remaining audio into `out` (see decode_into()) until it is full.")
+        .def("decode_next_branches", [](AudioDecoder& self) -> py::object {
+            auto buffers = reading(self, [&] {
+                std::vector<AudioBuffer> copies;
+                for (const auto& view : self.decode_next_branch_views()) {
+                    AudioBuffer& buffer = copies.emplace_back(view.num_channels, view.num_samples, view.sample_rate,
+                                                              view.format, view.layout);
+                    buffer.append(view.planes, view.num_samples);
+                }
+                return copies;
+            });
+            if (buffers.empty()) return py::none();
+            py::list arrays;
+            for (auto& buffer : buffers)
+                arrays.append(buffer_to_array(std::move(buffer)));
+            return arrays;
+        }, "Decode the next frame for every output branch. Returns a list of numpy arrays, or None if no data.")
+        .def("decode_all_branches", [](AudioDecoder& self) {
+            py::list arrays;
+            for (auto& buffer : reading(self, [&] { return self.decode_all_branches(); }))
+                arrays.append(buffer_to_array(std::move(buffer)));
+            return arrays;
+        }, "Decode the entire source once into one numpy array per output branch.")
         .def("is_finished", &AudioDecoder::is_finished, "Check if the stream has reached the end")
-        .def("get_metadata", &AudioDecoder::get_metadata, py::return_value_policy::reference_internal, "Get detected audio metadata");
+        .def("get_metadata", &AudioDecoder::get_metadata, py::return_value_policy::reference_internal, "Get detected audio metadata")
+        .def("get_stream_description", &AudioDecoder::get_stream_description, "Capture the opened stream's parameters for probe-free reopening")
+        .def("get_allocation_stats", &AudioDecoder::get_allocation_stats, "Frame buffer allocation counters; flat in steady state");
+
+    py::class_<StreamingDecoder>(m, "StreamingDecoder", "Decoder fed with encoded bytes as they arrive; never blocks")
+        .def(py::init<const AudioStreamOptions&, size_t, size_t>(), py::arg("options") = AudioStreamOptions(),
+             py::arg("capacity") = StreamingDecoder::DEFAULT_CAPACITY,
+             py::arg("reserve_bytes") = StreamingDecoder::DEFAULT_RESERVE,
+             "Initialize with output options, ring capacity and the bytes buffered before each packet read")
+        .def("feed", [](StreamingDecoder& self, py::buffer data) {
+            // Borrowed for the call only: feed() copies into the ring
+            const uint8_t* bytes;
+            size_t size;
+            auto owner = borrow_bytes(data, bytes, size);
+            return without_gil([&] { return self.feed(bytes, size); });
+        }, py::arg("data"),
+           "Append encoded bytes from any buffer (bytes, bytearray, memoryview, numpy array). "
+           "Returns the number accepted; fewer than given when the ring is full.")
+        .def("end_of_input", &StreamingDecoder::end_of_input, "Signal that no more input will come")
+        .def("poll_frames", [](StreamingDecoder& self) {
+            py::list arrays;
+            for (auto& buffer : without_gil([&] { return self.poll_frames(); }))
+                arrays.append(buffer_to_array(std::move(buffer)));
+            return arrays;
+        }, "Decode what the buffered input allows. Returns a list of numpy arrays, one per frame.")
+        .def("is_open", &StreamingDecoder::is_open, "Check if the format has been detected")
+        .def("is_finished", &StreamingDecoder::is_finished, "Check if input has ended and every frame was returned")
+        .def("get_metadata", &StreamingDecoder::get_metadata, py::return_value_policy::reference_internal, "Get detected audio metadata")
+        .def("get_allocation_stats", &StreamingDecoder::get_allocation_stats, "Frame buffer allocation counters");
+
+    m.def("probe", &AudioDecoder::probe, py::arg("source"), py::arg("options") = AudioStreamOptions(),
+          py::call_guard<py::gil_scoped_release>(),
+          "Read only the metadata of a source, with minimal I/O and no codec opened");
+
+    m.def("decode_file_parallel", [](const std::string& path, const AudioStreamOptions& options, int num_threads) {
+        return buffer_to_array(without_gil([&] { return decode_file_parallel(path, options, num_threads); }));
+    }, py::arg("path"), py::arg("options") = AudioStreamOptions(), py::arg("num_threads") = 0,
+       "Decode a whole file on several threads into a numpy array; same samples as decode_all()");
+
+    m.def("load_many", [](const py::list& sources, const AudioStreamOptions& options, int num_threads, bool pad) {
+        // Paths (str or os.PathLike) or encoded buffers, borrowed for the call
+        std::vector<BatchSource> batch;
+        std::vector<std::shared_ptr<const void>> owners;
+        for (const py::handle& source : sources) {
+            if (py::isinstance<py::buffer>(source)) {
+                const uint8_t *bytes = nullptr;
+                size_t size = 0;
+                owners.push_back(borrow_bytes(py::reinterpret_borrow<py::buffer>(source), bytes, size));
+                batch.emplace_back(bytes, size);
+            } else {
+                batch.emplace_back(py::str(source).cast<std::string>());
+            }
+        }
+
+        auto results = without_gil([&] { return BatchDecoder(options, num_threads).decode(batch); });
+
+        py::list errors;
+        for (const auto& r : results)
+            errors.append(r.ok() ? py::object(py::none()) : py::object(py::str(r.error)));
+        if (pad) {
+            py::tuple padded = pad_results(results, options.output_sample_format, options.output_layout);
+            return py::make_tuple(py::object(padded[0]), py::object(padded[1]), errors);
+        }
+        py::list arrays;
+        for (auto& r : results)
+            arrays.append(r.ok() ? py::object(buffer_to_array(std::move(r.audio))) : py::object(py::none()));
+        return py::make_tuple(arrays, errors);
+    }, py::arg("sources"), py::arg("options") = AudioStreamOptions(), py::arg("num_threads") = 0, py::arg("pad") = false,
+       "Decode many paths or encoded buffers in parallel on native threads, without the GIL. "
+       "Returns (arrays, errors): one numpy array per source (None if it failed) and one error message per source "
+       "(None if it succeeded). With pad=True returns (padded, lengths, errors): a zero-padded "
+       "(batch, channels, max_len) array, or (batch, max_len, channels) for interleaved output, and the valid "
+       "length of each item (0 for failed ones).");
 
     // --- Device Manager ---
     py::class_<DeviceManager>(m, "DeviceManager", "Static utility for audio device management")
-        .def_static("list_audio_devices", &DeviceManager::list_audio_devices, "Enumerate all available audio input and loopback devices");
+        .def_static("list_audio_devices", &DeviceManager::list_audio_devices, py::call_guard<py::gil_scoped_release>(), "Enumerate all available audio input and loopback devices");
 }
@@ -0,0 +1,132 @@
+// Benchmark: AudioDecoder::decode_next() vs decode_next_view()
+// Reports heap allocations and nanoseconds per decoded frame for both paths.
+// Allocations are counted through the global operator new, so FFmpeg's own
+// av_malloc traffic (identical for both paths) is not included.
+
+#include "avioflow-cxx-api.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string TEST_FILE_PATH = "./public/TownTheme.mp3";
+
+//=============================================================================
+// Allocation counting
+//=============================================================================
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+struct BenchResult
+{
+    uint64_t frames = 0;
+    uint64_t samples = 0;
+    uint64_t allocations = 0;
+    double elapsed_ns = 0.0;
+};
+
+void print_result(const std::string &name, const BenchResult &r)
+{
+    std::cout << "[" << name << "]" << std::endl;
+    std::cout << "  Frames: " << r.frames << ", Samples: " << r.samples << std::endl;
+    std::cout << "  Allocations: " << r.allocations << " ("
+              << static_cast<double>(r.allocations) / r.frames << " per frame)" << std::endl;
+    std::cout << "  Time: " << r.elapsed_ns / r.frames << " ns per frame" << std::endl;
+}
+
+//=============================================================================
+// Bench: Copying decode_next()
+//=============================================================================
+BenchResult bench_decode_next()
+{
+    AudioDecoder decoder;
+    decoder.open(TEST_FILE_PATH);
+
+    BenchResult r;
+    uint64_t alloc_start = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    while (!decoder.is_finished())
+    {
+        auto samples = decoder.decode_next();
+        if (samples.data.empty())
+            break; // No frame
+        r.frames++;
+        r.samples += samples.data[0].size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    r.allocations = g_allocations.load() - alloc_start;
+    r.elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return r;
+}
+
+//=============================================================================
+// Bench: Zero-copy decode_next_view()
+//=============================================================================
+BenchResult bench_decode_next_view()
+{
+    AudioDecoder decoder;
+    decoder.open(TEST_FILE_PATH);
+
+    BenchResult r;
+    uint64_t alloc_start = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    while (!decoder.is_finished())
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue; // No frame, or one that the resampler buffered entirely
+        r.frames++;
+        r.samples += view.channel(0).size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    r.allocations = g_allocations.load() - alloc_start;
+    r.elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return r;
+}
+
+//=============================================================================
+// Main Benchmark Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Frame View Benchmark ===" << std::endl;
+
+    std::ifstream check_file(TEST_FILE_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << TEST_FILE_PATH << std::endl;
+        return 1;
+    }
+
+    avioflow_set_log_level("error");
+
+    auto copy_result = bench_decode_next();
+    auto view_result = bench_decode_next_view();
+
+    print_result("decode_next", copy_result);
+    print_result("decode_next_view", view_result);
+
+    return 0;
+}
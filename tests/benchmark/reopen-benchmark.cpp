@@ -0,0 +1,122 @@
+// Benchmark: short-clip throughput, fresh decoder per clip vs reopen()
+// Cuts TownTheme.mp3 into ~2 s in-memory MP3 clips (same codec and rate,
+// like a dataset of short utterances) and decodes every clip to 16 kHz mono
+// (1) with a new AudioDecoder + open_memory() per clip, and
+// (2) with one AudioDecoder and reopen_memory(), which reuses the codec
+//     context and the resampler.
+
+#include "avioflow-cxx-api.h"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string TEST_FILE_PATH = "./public/TownTheme.mp3";
+
+constexpr double CLIP_SECONDS = 2.0;
+constexpr int PASSES = 5;
+
+std::vector<uint8_t> read_file_bytes(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char *>(buffer.data()), size);
+    return buffer;
+}
+
+struct BenchResult
+{
+    size_t clips = 0;
+    int64_t samples = 0;
+    double elapsed_ms = 0.0;
+};
+
+void print_result(const std::string &name, const BenchResult &r)
+{
+    std::printf("[%s]\n  Clips: %zu, Samples: %lld\n  Time: %.1f ms (%.1f clips/s)\n",
+                name.c_str(), r.clips, static_cast<long long>(r.samples), r.elapsed_ms,
+                r.clips * 1000.0 / r.elapsed_ms);
+}
+
+template <typename DecodeClip>
+BenchResult run(const std::vector<std::vector<uint8_t>> &clips, DecodeClip &&decode_clip)
+{
+    BenchResult r;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; ++pass)
+    {
+        for (const auto &clip : clips)
+        {
+            r.samples += decode_clip(clip);
+            r.clips++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    r.elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return r;
+}
+
+//=============================================================================
+// Main Benchmark Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Reopen Benchmark ===" << std::endl;
+
+    std::ifstream check_file(TEST_FILE_PATH);
+    if (!check_file.good())
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << TEST_FILE_PATH << std::endl;
+        return 1;
+    }
+
+    avioflow_set_log_level("quiet");
+
+    // MP3 frames resynchronize, so byte slices are valid short MP3 clips
+    auto bytes = read_file_bytes(TEST_FILE_PATH);
+    double duration = 0.0;
+    {
+        AudioDecoder probe;
+        probe.open(TEST_FILE_PATH);
+        duration = probe.get_metadata().duration;
+    }
+    size_t clip_bytes = static_cast<size_t>(bytes.size() * CLIP_SECONDS / duration);
+    std::vector<std::vector<uint8_t>> clips;
+    for (size_t pos = 0; pos + clip_bytes <= bytes.size(); pos += clip_bytes)
+        clips.emplace_back(bytes.begin() + pos, bytes.begin() + pos + clip_bytes);
+    std::cout << "Clips: " << clips.size() << " x ~" << CLIP_SECONDS << " s, " << PASSES << " passes" << std::endl;
+
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.output_num_channels = 1;
+
+    auto fresh = run(clips, [&](const std::vector<uint8_t> &clip) {
+        AudioDecoder decoder(options);
+        decoder.open_memory(clip.data(), clip.size());
+        return decoder.decode_all().num_samples();
+    });
+
+    AudioDecoder reused(options);
+    auto reopened = run(clips, [&](const std::vector<uint8_t> &clip) {
+        reused.reopen_memory(clip.data(), clip.size());
+        return reused.decode_all().num_samples();
+    });
+
+    assert(fresh.samples == reopened.samples);
+    print_result("new decoder per clip", fresh);
+    print_result("reopen_memory", reopened);
+    std::printf("Speedup: %.2fx\n", fresh.elapsed_ms / reopened.elapsed_ms);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Unit tests for BatchDecoder
+// Tests cover: results in input order matching a serial decode, completion
+// callbacks, memory sources, and per-item errors that do not abort the batch
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+std::vector<uint8_t> read_file_bytes(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    assert(file.is_open());
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char *>(buffer.data()), size);
+    return buffer;
+}
+
+AudioBuffer decode_reference(const std::string &path, const AudioStreamOptions &options)
+{
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+void assert_identical(const AudioBuffer &actual, const AudioBuffer &expected)
+{
+    assert(actual.num_channels() == expected.num_channels());
+    assert(actual.num_samples() == expected.num_samples());
+    for (int c = 0; c < expected.num_channels(); ++c)
+    {
+        auto a = actual.channel_span(c);
+        auto e = expected.channel_span(c);
+        assert(std::equal(a.begin(), a.end(), e.begin()));
+    }
+}
+
+//=============================================================================
+// Test: Results come back in input order and match serial decoding
+//=============================================================================
+void test_batch_in_order()
+{
+    std::cout << "Running test_batch_in_order..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    auto mp3_reference = decode_reference(MP3_PATH, options);
+    auto wav_reference = decode_reference(WAV_PATH, options);
+
+    // Skewed lengths, more items than threads (decoders are reused)
+    std::vector<BatchSource> sources = {WAV_PATH, MP3_PATH, WAV_PATH, WAV_PATH, MP3_PATH, WAV_PATH};
+    BatchDecoder batch(options, 3);
+    assert(batch.num_threads() == 3);
+
+    auto results = batch.decode(sources);
+    assert(results.size() == sources.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        assert(results[i].ok());
+        assert(results[i].index == i);
+        assert(results[i].metadata.sample_rate > 0);
+        bool is_mp3 = sources[i].path == MP3_PATH;
+        assert_identical(results[i].audio, is_mp3 ? mp3_reference : wav_reference);
+    }
+
+    // The same BatchDecoder can run another batch
+    results = batch.decode({MP3_PATH});
+    assert(results.size() == 1 && results[0].ok());
+}
+
+//=============================================================================
+// Test: Per-item errors, memory sources and completion callback
+//=============================================================================
+void test_batch_errors_and_callback()
+{
+    std::cout << "Running test_batch_errors_and_callback..." << std::endl;
+    auto wav_reference = decode_reference(WAV_PATH, {});
+    auto bytes = read_file_bytes(WAV_PATH);
+    std::vector<uint8_t> garbage(4096, 0x5a);
+
+    std::vector<BatchSource> sources = {
+        BatchSource(bytes.data(), bytes.size()),
+        "./public/does-not-exist.mp3",
+        BatchSource(garbage.data(), garbage.size()),
+        WAV_PATH,
+    };
+
+    BatchDecoder batch({}, 2);
+    std::set<size_t> seen;
+    batch.decode(sources, [&](BatchResult &&result) {
+        assert(seen.insert(result.index).second);
+        bool should_fail = result.index == 1 || result.index == 2;
+        assert(result.ok() != should_fail);
+        if (result.ok())
+            assert_identical(result.audio, wav_reference);
+        else
+            std::cout << "  item " << result.index << " failed: " << result.error << std::endl;
+    });
+    assert(seen.size() == sources.size());
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow BatchDecoder Tests ===" << std::endl;
+    avioflow_set_log_level("quiet");
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_batch_in_order();
+    test_batch_errors_and_callback();
+
+    std::cout << "All BatchDecoder tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+// Unit tests for channel selection and mapping (AudioStreamOptions::
+// channel_indices / mix_matrix)
+// Tests cover: selected channels equal to the same channels of a full
+// decode (same rate through the fast path, resampled through swresample
+// and the polyphase engine, S16 and interleaved output), mix matrices,
+// chunked output, invalid selections, and sources with more channels
+// than AVFrame::data holds
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+constexpr int CHANNELS = 8;
+constexpr int SOURCE_RATE = 48000;
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// 16-bit PCM WAV with a different tone and level on every channel, like a
+// multi-mic meeting recording
+std::vector<uint8_t> make_multichannel_wav(double seconds, int channels = CHANNELS)
+{
+    int frames = static_cast<int>(SOURCE_RATE * seconds);
+    uint32_t data_bytes = frames * channels * 2;
+    std::vector<uint8_t> wav(44 + data_bytes);
+    auto put32 = [&](size_t at, uint32_t v) { std::memcpy(wav.data() + at, &v, 4); };
+    auto put16 = [&](size_t at, uint16_t v) { std::memcpy(wav.data() + at, &v, 2); };
+    std::memcpy(wav.data(), "RIFF", 4);
+    put32(4, 36 + data_bytes);
+    std::memcpy(wav.data() + 8, "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, 1); // PCM
+    put16(22, channels);
+    put32(24, SOURCE_RATE);
+    put32(28, SOURCE_RATE * channels * 2); // Byte rate
+    put16(32, channels * 2);               // Block align
+    put16(34, 16);
+    std::memcpy(wav.data() + 36, "data", 4);
+    put32(40, data_bytes);
+    for (int i = 0; i < frames; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            double phase = 2.0 * M_PI * 150.0 * (c + 1) * i / SOURCE_RATE;
+            auto v = static_cast<int16_t>(std::lround(2000.0 * (c + 1) * std::sin(phase)));
+            put16(44 + (static_cast<size_t>(i) * channels + c) * 2, static_cast<uint16_t>(v));
+        }
+    }
+    return wav;
+}
+
+const std::vector<uint8_t> &test_wav()
+{
+    static const std::vector<uint8_t> wav = make_multichannel_wav(3.0);
+    return wav;
+}
+
+AudioBuffer decode(const AudioStreamOptions &options)
+{
+    AudioDecoder decoder(options);
+    decoder.open_memory(test_wav().data(), test_wav().size());
+    return decoder.decode_all();
+}
+
+// Largest difference between output channel `c` of `a` and `b`'s channel `bc`
+float max_diff(const AudioBuffer &a, int c, const AudioBuffer &b, int bc)
+{
+    assert(a.num_samples() == b.num_samples());
+    float diff = 0;
+    for (int64_t i = 0; i < a.num_samples(); ++i)
+        diff = std::max(diff, std::abs(a.channel(c)[i] - b.channel(bc)[i]));
+    return diff;
+}
+
+//=============================================================================
+// Test: Selected channels equal the same channels of a full decode
+//=============================================================================
+void test_select_channels()
+{
+    std::cout << "Running test_select_channels..." << std::endl;
+    const std::vector<int> indices = {5, 2};
+    for (std::optional<int> rate : {std::optional<int>(), std::optional<int>(16000)})
+    {
+        for (Resampler engine : {Resampler::SwResample, Resampler::Polyphase})
+        {
+            AudioStreamOptions full_options;
+            full_options.output_sample_rate = rate;
+            full_options.resampler = engine;
+            auto full = decode(full_options);
+            assert(full.num_channels() == CHANNELS);
+
+            AudioStreamOptions options = full_options;
+            options.channel_indices = indices;
+            auto selected = decode(options);
+            assert(selected.num_channels() == 2);
+            assert(selected.size_bytes() < full.size_bytes() / 3);
+            for (int c = 0; c < 2; ++c)
+            {
+                float diff = max_diff(selected, c, full, indices[c]);
+                std::cout << "  " << (rate ? "16 kHz " : "48 kHz ")
+                          << (engine == Resampler::Polyphase ? "polyphase" : "swr") << " channel "
+                          << indices[c] << ": max diff " << diff << std::endl;
+                // Remixing before resampling only reorders float operations
+                assert(diff <= (rate ? 1e-6f : 0.0f));
+            }
+        }
+    }
+}
+
+//=============================================================================
+// Test: S16 and interleaved output of a selection
+//=============================================================================
+void test_select_formats()
+{
+    std::cout << "Running test_select_formats..." << std::endl;
+    AudioStreamOptions full_options;
+    full_options.output_sample_format = SampleFormat::S16;
+    auto full = decode(full_options);
+
+    AudioStreamOptions options = full_options;
+    options.channel_indices = {7};
+    auto mono = decode(options);
+    assert(mono.num_channels() == 1);
+    assert(std::memcmp(mono.channel<int16_t>(0), full.channel<int16_t>(7),
+                       mono.num_samples() * sizeof(int16_t)) == 0);
+
+    options.channel_indices = {1, 6, 1};
+    options.output_sample_format = SampleFormat::F32;
+    options.output_layout = SampleLayout::Interleaved;
+    auto interleaved = decode(options);
+    auto reference = decode({});
+    auto frames = interleaved.interleaved_span();
+    for (int64_t i = 0; i < interleaved.num_samples(); ++i)
+    {
+        assert(frames[i * 3 + 0] == reference.channel(1)[i]);
+        assert(frames[i * 3 + 1] == reference.channel(6)[i]);
+        assert(frames[i * 3 + 2] == reference.channel(1)[i]);
+    }
+}
+
+//=============================================================================
+// Test: A mix matrix weights input channels per output channel
+//=============================================================================
+void test_mix_matrix()
+{
+    std::cout << "Running test_mix_matrix..." << std::endl;
+    auto full = decode({});
+
+    AudioStreamOptions options;
+    options.mix_matrix = {{0.5, 0.5, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, -1.0}};
+    auto mixed = decode(options);
+    assert(mixed.num_channels() == 2);
+    for (int64_t i = 0; i < mixed.num_samples(); ++i)
+    {
+        float expected = 0.5f * full.channel(0)[i] + 0.5f * full.channel(1)[i];
+        assert(std::abs(mixed.channel(0)[i] - expected) <= 1e-7f);
+        assert(mixed.channel(1)[i] == -full.channel(7)[i]);
+    }
+}
+
+//=============================================================================
+// Test: Selection combines with chunked output
+//=============================================================================
+void test_select_chunked()
+{
+    std::cout << "Running test_select_chunked..." << std::endl;
+    auto full = decode({});
+    AudioStreamOptions options;
+    options.channel_indices = {3};
+    options.chunk_samples = 480;
+    AudioDecoder decoder(options);
+    decoder.open_memory(test_wav().data(), test_wav().size());
+    int64_t offset = 0;
+    while (!decoder.is_finished())
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue;
+        assert(view.num_channels == 1 && view.num_samples == 480);
+        assert(std::memcmp(view.channel(0).data(), full.channel(3) + offset, 480 * sizeof(float)) == 0);
+        offset += 480;
+    }
+    assert(offset == full.num_samples());
+}
+
+//=============================================================================
+// Test: Invalid selections are rejected
+//=============================================================================
+void test_invalid_selection()
+{
+    std::cout << "Running test_invalid_selection..." << std::endl;
+    auto throws = [](const AudioStreamOptions &options) {
+        try
+        {
+            decode(options);
+        }
+        catch (const std::invalid_argument &)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    AudioStreamOptions out_of_range;
+    out_of_range.channel_indices = {0, CHANNELS};
+    assert(throws(out_of_range));
+
+    AudioStreamOptions negative;
+    negative.channel_indices = {-1};
+    assert(throws(negative));
+
+    AudioStreamOptions both;
+    both.channel_indices = {0};
+    both.mix_matrix = {std::vector<double>(CHANNELS, 0.1)};
+    assert(throws(both));
+
+    AudioStreamOptions short_row;
+    short_row.mix_matrix = {{1.0, 0.0}};
+    assert(throws(short_row));
+
+    AudioStreamOptions conflicting;
+    conflicting.channel_indices = {0, 1};
+    conflicting.output_num_channels = 1;
+    assert(throws(conflicting));
+}
+
+//=============================================================================
+// Test: More channels than AVFrame::data has pointers (AV_NUM_DATA_POINTERS)
+//=============================================================================
+void test_many_channels()
+{
+    std::cout << "Running test_many_channels..." << std::endl;
+    constexpr int MANY = 12;
+    auto wav = make_multichannel_wav(0.5, MANY);
+
+    AudioDecoder decoder;
+    decoder.open_memory(wav.data(), wav.size());
+    auto buffer = decoder.decode_all();
+    decoder.open_memory(wav.data(), wav.size());
+    auto samples = decoder.get_all_samples();
+
+    assert(buffer.num_channels() == MANY && (int)samples.data.size() == MANY);
+    for (int c = 0; c < MANY; ++c)
+    {
+        auto channel = buffer.channel_span(c);
+        assert(samples.data[c].size() == channel.size());
+        assert(std::equal(channel.begin(), channel.end(), samples.data[c].begin()));
+    }
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Channel Selection Tests ===" << std::endl;
+
+    test_select_channels();
+    test_select_formats();
+    test_mix_matrix();
+    test_select_chunked();
+    test_invalid_selection();
+    test_many_channels();
+
+    std::cout << "\nAll channel selection tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,264 @@
+// Unit tests for fixed-size chunked output (AudioStreamOptions::chunk_samples)
+// Tests cover: every chunk holding exactly chunk_samples samples, chunk
+// contents matching decode_all() at multiples of the hop (overlapping and
+// skipping hops, resampled and not), the padded and short tail, F16 and
+// interleaved output, seek restarting the chunk grid, when is_finished()
+// turns true, and invalid sizes
+
+#include "avioflow-cxx-api.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+AudioBuffer decode_reference(const std::string &path, AudioStreamOptions options)
+{
+    options.chunk_samples.reset();
+    options.hop_samples.reset();
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+// Decode all chunks, checking each against `reference` at k * hop; returns
+// the number of chunks and the size of the last one
+std::pair<int64_t, int> check_chunks(const std::string &path, const AudioStreamOptions &options,
+                                     const AudioBuffer &reference)
+{
+    int chunk = *options.chunk_samples;
+    int hop = options.hop_samples.value_or(chunk);
+    int64_t sample_bytes = reference.bytes_per_sample() *
+                           (reference.layout() == SampleLayout::Planar ? 1 : reference.num_channels());
+
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    int64_t chunks = 0;
+    int last_size = 0;
+    while (!decoder.is_finished())
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue;
+        assert(last_size == 0 || last_size == chunk); // Only the last chunk may be short
+
+        int64_t offset = chunks * hop;
+        int64_t valid = std::min<int64_t>(view.num_samples, reference.num_samples() - offset);
+        assert(valid > 0);
+        for (int p = 0; p < reference.num_planes(); ++p)
+        {
+            assert(std::memcmp(view.planes[p], const_cast<AudioBuffer &>(reference).plane_data(p, offset),
+                               valid * sample_bytes) == 0);
+            // Padding is silence
+            for (int64_t i = valid * sample_bytes; i < view.num_samples * sample_bytes; ++i)
+                assert(view.planes[p][i] == 0);
+        }
+        last_size = view.num_samples;
+        ++chunks;
+    }
+    assert(decoder.decode_next_view().empty());
+    return {chunks, last_size};
+}
+
+//=============================================================================
+// Test: Non-overlapping chunks tile the stream exactly
+//=============================================================================
+void test_fixed_chunks()
+{
+    std::cout << "Running test_fixed_chunks..." << std::endl;
+    AudioStreamOptions options;
+    options.chunk_samples = 320;
+    auto reference = decode_reference(WAV_PATH, options);
+
+    auto [chunks, last] = check_chunks(WAV_PATH, options, reference);
+    std::cout << "  " << chunks << " chunks of 320, last " << last << std::endl;
+    assert(chunks == (reference.num_samples() + 319) / 320);
+    assert(last == 320); // Padded by default
+}
+
+//=============================================================================
+// Test: Overlapping chunks (hop < chunk), resampled
+//=============================================================================
+void test_overlap()
+{
+    std::cout << "Running test_overlap..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.chunk_samples = 400;
+    options.hop_samples = 160;
+    auto reference = decode_reference(MP3_PATH, options);
+
+    auto [chunks, last] = check_chunks(MP3_PATH, options, reference);
+    std::cout << "  " << chunks << " chunks of 400 every 160" << std::endl;
+    // The last chunk is the first one holding the final sample
+    assert(chunks == (reference.num_samples() - 400 + 159) / 160 + 1);
+    assert(last == 400);
+}
+
+//=============================================================================
+// Test: Hops longer than a chunk skip the samples in between
+//=============================================================================
+void test_skip()
+{
+    std::cout << "Running test_skip..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 22050;
+    options.chunk_samples = 256;
+    options.hop_samples = 1000;
+    auto reference = decode_reference(MP3_PATH, options);
+
+    auto [chunks, last] = check_chunks(MP3_PATH, options, reference);
+    std::cout << "  " << chunks << " chunks of 256 every 1000" << std::endl;
+    assert(chunks == (reference.num_samples() + 999) / 1000);
+}
+
+//=============================================================================
+// Test: Short tail returns only the samples left
+//=============================================================================
+void test_short_tail()
+{
+    std::cout << "Running test_short_tail..." << std::endl;
+    AudioStreamOptions options;
+    options.chunk_samples = 1000;
+    options.chunk_tail = ChunkTail::Short;
+    auto reference = decode_reference(WAV_PATH, options);
+    assert(reference.num_samples() % 1000 != 0);
+
+    auto [chunks, last] = check_chunks(WAV_PATH, options, reference);
+    std::cout << "  last chunk: " << last << " samples" << std::endl;
+    assert(chunks == (reference.num_samples() + 999) / 1000);
+    assert(last == reference.num_samples() % 1000);
+}
+
+//=============================================================================
+// Test: is_finished() after the last chunk
+//=============================================================================
+void test_end_of_stream()
+{
+    std::cout << "Running test_end_of_stream..." << std::endl;
+    AudioStreamOptions options;
+    int64_t total = decode_reference(WAV_PATH, options).num_samples();
+
+    // Partial last chunk: the end is known when it is returned
+    options.chunk_samples = static_cast<int>(total + 1);
+    AudioDecoder partial(options);
+    partial.open(WAV_PATH);
+    assert(!partial.decode_next_view().empty());
+    assert(partial.is_finished());
+
+    // Full last chunk: one more call finds nothing left
+    options.chunk_samples = static_cast<int>(total);
+    AudioDecoder full(options);
+    full.open(WAV_PATH);
+    assert(full.decode_next_view().num_samples == total);
+    assert(!full.is_finished());
+    assert(full.decode_next_view().empty());
+    assert(full.is_finished());
+}
+
+//=============================================================================
+// Test: F16 and interleaved output are chunked the same way
+//=============================================================================
+void test_formats()
+{
+    std::cout << "Running test_formats..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.output_sample_format = SampleFormat::F16;
+    options.output_layout = SampleLayout::Interleaved;
+    options.chunk_samples = 512;
+    options.hop_samples = 256;
+    check_chunks(MP3_PATH, options, decode_reference(MP3_PATH, options));
+
+    options.output_sample_format = SampleFormat::S16;
+    options.output_layout = SampleLayout::Planar;
+    check_chunks(MP3_PATH, options, decode_reference(MP3_PATH, options));
+}
+
+//=============================================================================
+// Test: Seeking restarts the chunk grid at the seek target
+//=============================================================================
+void test_seek()
+{
+    std::cout << "Running test_seek..." << std::endl;
+    AudioStreamOptions options;
+    options.chunk_samples = 480;
+    options.hop_samples = 240;
+    AudioDecoder decoder(options);
+    decoder.open(WAV_PATH);
+    for (int i = 0; i < 10; ++i)
+        decoder.decode_next_view();
+
+    const int64_t target = 12345;
+    decoder.seek_to_sample(target);
+    auto reference = decode_reference(WAV_PATH, options);
+    int64_t chunks = 0;
+    while (!decoder.is_finished() && chunks < 20)
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue;
+        assert(view.num_samples == 480);
+        assert(std::memcmp(view.planes[0], reference.channel(0) + target + chunks * 240,
+                           480 * sizeof(float)) == 0);
+        ++chunks;
+    }
+    assert(chunks == 20);
+}
+
+//=============================================================================
+// Test: Chunk and hop sizes must be positive
+//=============================================================================
+void test_invalid_sizes()
+{
+    std::cout << "Running test_invalid_sizes..." << std::endl;
+    std::pair<int, int> bad[] = {{0, 100}, {-5, 100}, {100, 0}};
+    for (auto [chunk, hop] : bad)
+    {
+        AudioStreamOptions options;
+        options.chunk_samples = chunk;
+        options.hop_samples = hop;
+        bool threw = false;
+        try
+        {
+            AudioDecoder decoder(options);
+        }
+        catch (const std::exception &)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Chunked Output Tests ===" << std::endl;
+
+    test_fixed_chunks();
+    test_overlap();
+    test_skip();
+    test_short_tail();
+    test_end_of_stream();
+    test_formats();
+    test_seek();
+    test_invalid_sizes();
+
+    std::cout << "\nAll chunked output tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Unit tests for multi-rate fan-out (AudioStreamOptions::branches)
+// Tests cover: every branch matching a separate decoder with the same
+// output options (rates, channels, formats, layouts, both resampler
+// engines), per-frame branch views, reopen, seek rejection, and the time
+// saved over decoding once per output
+
+#include "avioflow-cxx-api.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+OutputBranch make_branch(std::optional<int> rate, std::optional<int> channels = std::nullopt,
+                         SampleFormat format = SampleFormat::F32,
+                         SampleLayout layout = SampleLayout::Planar,
+                         Resampler resampler = Resampler::SwResample)
+{
+    OutputBranch branch;
+    branch.output_sample_rate = rate;
+    branch.output_num_channels = channels;
+    branch.output_sample_format = format;
+    branch.output_layout = layout;
+    branch.resampler = resampler;
+    return branch;
+}
+
+// ASR, telephony and archival outputs, plus the polyphase engine
+std::vector<OutputBranch> test_branches()
+{
+    return {make_branch(16000),
+            make_branch(8000, 1, SampleFormat::S16, SampleLayout::Interleaved),
+            make_branch(std::nullopt),
+            make_branch(16000, 1, SampleFormat::F16, SampleLayout::Planar, Resampler::Polyphase)};
+}
+
+// The same output from a decoder of its own
+AudioBuffer decode_single(const std::string &path, const OutputBranch &branch)
+{
+    AudioStreamOptions options;
+    options.output_sample_rate = branch.output_sample_rate;
+    options.output_num_channels = branch.output_num_channels;
+    options.output_sample_format = branch.output_sample_format;
+    options.output_layout = branch.output_layout;
+    options.resampler = branch.resampler;
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+bool identical(const AudioBuffer &a, const AudioBuffer &b)
+{
+    if (a.num_samples() != b.num_samples() || a.num_channels() != b.num_channels() ||
+        a.format() != b.format() || a.layout() != b.layout() || a.sample_rate() != b.sample_rate())
+        return false;
+    int64_t bytes = a.num_samples() * a.bytes_per_sample() *
+                    (a.layout() == SampleLayout::Planar ? 1 : a.num_channels());
+    for (int p = 0; p < a.num_planes(); ++p)
+    {
+        if (std::memcmp(const_cast<AudioBuffer &>(a).plane_data(p), const_cast<AudioBuffer &>(b).plane_data(p),
+                        bytes) != 0)
+            return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// Test: Each branch equals a separate decode with the same output options
+//=============================================================================
+void test_branches_match_single()
+{
+    std::cout << "Running test_branches_match_single..." << std::endl;
+    for (const std::string &path : {MP3_PATH, WAV_PATH})
+    {
+        AudioStreamOptions options;
+        options.branches = test_branches();
+        AudioDecoder decoder(options);
+        decoder.open(path);
+        auto outputs = decoder.decode_all_branches();
+        assert(outputs.size() == options.branches.size());
+        assert(decoder.is_finished());
+
+        for (size_t i = 0; i < outputs.size(); ++i)
+        {
+            std::cout << "  " << path << " branch " << i << ": " << outputs[i].num_samples() << " samples @ "
+                      << outputs[i].sample_rate() << " Hz, " << outputs[i].num_channels() << " ch" << std::endl;
+            assert(identical(outputs[i], decode_single(path, options.branches[i])));
+        }
+    }
+}
+
+//=============================================================================
+// Test: Frame-by-frame views carry one frame per branch
+//=============================================================================
+void test_branch_views()
+{
+    std::cout << "Running test_branch_views..." << std::endl;
+    AudioStreamOptions options;
+    options.branches = test_branches();
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+
+    std::vector<int64_t> totals(options.branches.size(), 0);
+    while (!decoder.is_finished())
+    {
+        auto views = decoder.decode_next_branch_views();
+        if (views.empty())
+            continue;
+        assert(views.size() == options.branches.size());
+        for (size_t i = 0; i < views.size(); ++i)
+        {
+            assert(views[i].format == options.branches[i].output_sample_format);
+            assert(views[i].layout == options.branches[i].output_layout);
+            assert(views[i].generation == views[0].generation);
+            totals[i] += views[i].num_samples;
+        }
+    }
+    for (size_t i = 0; i < totals.size(); ++i)
+        assert(totals[i] == decode_single(MP3_PATH, options.branches[i]).num_samples());
+}
+
+//=============================================================================
+// Test: Reopening restarts every branch; seeking is rejected
+//=============================================================================
+void test_reopen_and_seek()
+{
+    std::cout << "Running test_reopen_and_seek..." << std::endl;
+    AudioStreamOptions options;
+    options.branches = {make_branch(16000), make_branch(22050, 1)};
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    auto first = decoder.decode_all_branches();
+
+    decoder.reopen(WAV_PATH);
+    auto wav = decoder.decode_all_branches();
+    assert(identical(wav[1], decode_single(WAV_PATH, options.branches[1])));
+
+    decoder.reopen(MP3_PATH);
+    auto again = decoder.decode_all_branches();
+    for (size_t i = 0; i < first.size(); ++i)
+        assert(identical(first[i], again[i]));
+
+    bool threw = false;
+    try
+    {
+        decoder.seek(10.0);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+//=============================================================================
+// Test: One pass for three outputs is cheaper than three decodes
+//=============================================================================
+void test_fanout_cost()
+{
+    std::cout << "Running test_fanout_cost..." << std::endl;
+    AudioStreamOptions options;
+    options.branches = {make_branch(16000), make_branch(8000, 1), make_branch(std::nullopt)};
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &branch : options.branches)
+        decode_single(MP3_PATH, branch);
+    auto separate = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    decoder.decode_all_branches();
+    auto fanout = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "  3 decoders: " << separate * 1000 << " ms, fan-out: " << fanout * 1000 << " ms" << std::endl;
+    assert(fanout < separate);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Fan-out Tests ===" << std::endl;
+
+    test_branches_match_single();
+    test_branch_views();
+    test_reopen_and_seek();
+    test_fanout_cost();
+
+    std::cout << "\nAll fan-out tests passed!" << std::endl;
+    return 0;
+}
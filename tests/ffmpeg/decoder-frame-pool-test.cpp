@@ -0,0 +1,213 @@
+// Unit tests for pooled output frame buffers
+// Tests cover: allocation counters on the resampling, same-rate conversion
+// and F16 paths (a handful of buffers for a whole file), pooled frames
+// holding the same samples as decode_all(), no new buffers after seek or
+// reopen, and owned frames (decode_next_frame) outliving further decoding
+
+#include "avioflow-cxx-api.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+// A decoder draws at most this many buffers per pool (first frame plus
+// growth to the largest frame)
+constexpr uint64_t MAX_BUFFERS = 4;
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// Decode to the end through views; returns the number of frames
+uint64_t decode_views(AudioDecoder &decoder)
+{
+    uint64_t frames = 0;
+    while (!decoder.is_finished())
+    {
+        auto view = decoder.decode_next_view();
+        if (!view.empty())
+            ++frames;
+    }
+    return frames;
+}
+
+void report(const char *name, const AllocationStats &stats, uint64_t frames)
+{
+    std::cout << "  " << name << ": " << frames << " frames, " << stats.buffers_served << " served, "
+              << stats.buffers_allocated << " allocated" << std::endl;
+}
+
+//=============================================================================
+// Test: Resampled output reuses a few buffers for the whole file
+//=============================================================================
+void test_resample_pool()
+{
+    std::cout << "Running test_resample_pool..." << std::endl;
+    for (Resampler engine : {Resampler::SwResample, Resampler::Polyphase})
+    {
+        AudioStreamOptions options;
+        options.output_sample_rate = 16000;
+        options.resampler = engine;
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        assert(decoder.get_allocation_stats().buffers_served == 0);
+
+        uint64_t frames = decode_views(decoder);
+        auto stats = decoder.get_allocation_stats();
+        report(engine == Resampler::Polyphase ? "polyphase" : "swr", stats, frames);
+        assert(frames > 1000);
+        assert(stats.buffers_served >= frames);
+        assert(stats.buffers_allocated >= 1 && stats.buffers_allocated <= MAX_BUFFERS);
+    }
+}
+
+//=============================================================================
+// Test: Same-rate conversion and F16 output are pooled too
+//=============================================================================
+void test_convert_and_half_pools()
+{
+    std::cout << "Running test_convert_and_half_pools..." << std::endl;
+    AudioDecoder wav;
+    wav.open(WAV_PATH);
+    uint64_t frames = decode_views(wav);
+    auto stats = wav.get_allocation_stats();
+    report("wav f32", stats, frames);
+    assert(stats.buffers_allocated <= MAX_BUFFERS);
+
+    AudioStreamOptions options;
+    options.output_sample_format = SampleFormat::F16;
+    options.output_layout = SampleLayout::Interleaved;
+    AudioDecoder half(options);
+    half.open(MP3_PATH);
+    frames = decode_views(half);
+    stats = half.get_allocation_stats();
+    report("mp3 f16", stats, frames);
+    assert(stats.buffers_served >= frames);
+    assert(stats.buffers_allocated <= 2 * MAX_BUFFERS); // Float staging and F16 pools
+}
+
+//=============================================================================
+// Test: Frames from recycled buffers hold the right samples
+//=============================================================================
+void test_pooled_frames_match()
+{
+    std::cout << "Running test_pooled_frames_match..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 22050;
+    AudioDecoder reference(options);
+    reference.open(MP3_PATH);
+    auto all = reference.decode_all();
+
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    int64_t offset = 0;
+    while (!decoder.is_finished())
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue;
+        for (int c = 0; c < view.num_channels; ++c)
+            assert(std::memcmp(view.channel(c).data(), all.channel(c) + offset,
+                               view.num_samples * sizeof(float)) == 0);
+        offset += view.num_samples;
+    }
+    assert(offset == all.num_samples());
+}
+
+//=============================================================================
+// Test: Seeking and reopening keep drawing from the same pool
+//=============================================================================
+void test_seek_and_reopen()
+{
+    std::cout << "Running test_seek_and_reopen..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    decode_views(decoder);
+    uint64_t allocated = decoder.get_allocation_stats().buffers_allocated;
+
+    decoder.seek(60.0);
+    decode_views(decoder);
+    decoder.reopen(MP3_PATH);
+    decode_views(decoder);
+    auto stats = decoder.get_allocation_stats();
+    report("after seek + reopen", stats, 0);
+    assert(stats.buffers_allocated == allocated);
+}
+
+//=============================================================================
+// Test: Owned frames keep their buffers while decoding goes on
+//=============================================================================
+void test_owned_frames()
+{
+    std::cout << "Running test_owned_frames..." << std::endl;
+    for (int prefetch_frames : {0, 4})
+    {
+        for (std::optional<int> chunk_samples : {std::optional<int>(), std::optional<int>(4000)})
+        {
+            AudioStreamOptions options;
+            options.output_sample_rate = 16000;
+            options.chunk_samples = chunk_samples;
+            options.chunk_tail = ChunkTail::Short;
+            AudioDecoder reference(options);
+            reference.open(MP3_PATH);
+            auto all = reference.decode_all();
+
+            options.prefetch_frames = prefetch_frames;
+            std::vector<AudioFrame> frames;
+            {
+                AudioDecoder decoder(options);
+                decoder.open(MP3_PATH);
+                while (!decoder.is_finished())
+                {
+                    auto frame = decoder.decode_next_frame();
+                    if (!frame.empty())
+                        frames.push_back(std::move(frame));
+                }
+            }
+
+            // Compared after the decoder is gone: no frame was overwritten
+            int64_t offset = 0;
+            for (const auto &frame : frames)
+            {
+                const auto &view = frame.view();
+                assert(frame.plane_stride() >= view.num_samples);
+                for (int c = 0; c < view.num_channels; ++c)
+                {
+                    assert(view.planes[c] == view.planes[0] + c * frame.plane_stride() * sizeof(float));
+                    assert(std::memcmp(view.channel(c).data(), all.channel(c) + offset,
+                                       view.num_samples * sizeof(float)) == 0);
+                }
+                offset += view.num_samples;
+            }
+            assert(offset == all.num_samples());
+        }
+    }
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Frame Pool Tests ===" << std::endl;
+
+    test_resample_pool();
+    test_convert_and_half_pools();
+    test_pooled_frames_match();
+    test_seek_and_reopen();
+    test_owned_frames();
+
+    std::cout << "\nAll frame pool tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Unit tests for AudioDecoder::decode_into / decode_all_into
+// Tests cover: chunked decoding into caller-owned buffers (with and without
+// resampling) must produce exactly the same samples as decode_all()
+
+#include "avioflow-cxx-api.h"
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string TEST_FILE_PATH = "./public/TownTheme.mp3";
+
+constexpr int EXPECTED_NUM_CHANNELS = 2;
+
+//=============================================================================
+// Helper: Decode with decode_into() using a fixed chunk capacity
+//=============================================================================
+std::vector<std::vector<float>> decode_in_chunks(const AudioStreamOptions &options, size_t chunk)
+{
+    AudioDecoder decoder(options);
+    decoder.open(TEST_FILE_PATH);
+
+    std::vector<std::vector<float>> result(EXPECTED_NUM_CHANNELS);
+    std::vector<std::vector<float>> staging(EXPECTED_NUM_CHANNELS, std::vector<float>(chunk));
+    float *ptrs[EXPECTED_NUM_CHANNELS] = {staging[0].data(), staging[1].data()};
+
+    while (!decoder.is_finished())
+    {
+        size_t count = decoder.decode_into(ptrs, chunk);
+        assert(count <= chunk);
+        if (count < chunk)
+            assert(decoder.is_finished());
+
+        for (int c = 0; c < EXPECTED_NUM_CHANNELS; ++c)
+            result[c].insert(result[c].end(), staging[c].begin(), staging[c].begin() + count);
+    }
+    return result;
+}
+
+void assert_matches(const std::vector<std::vector<float>> &actual, const AudioBuffer &expected)
+{
+    assert((int)actual.size() == expected.num_channels());
+    for (int c = 0; c < expected.num_channels(); ++c)
+    {
+        auto channel = expected.channel_span(c);
+        assert(actual[c].size() == channel.size());
+        assert(std::equal(channel.begin(), channel.end(), actual[c].begin()));
+    }
+}
+
+AudioBuffer decode_reference(const AudioStreamOptions &options)
+{
+    AudioDecoder decoder(options);
+    decoder.open(TEST_FILE_PATH);
+    return decoder.decode_all();
+}
+
+//=============================================================================
+// Test: decode_into without resampling (passthrough)
+//=============================================================================
+void test_decode_into_passthrough()
+{
+    std::cout << "Running test_decode_into_passthrough..." << std::endl;
+    AudioStreamOptions options;
+    auto expected = decode_reference(options);
+
+    // Chunk sizes smaller and larger than an MP3 frame (1152 samples)
+    assert_matches(decode_in_chunks(options, 480), expected);
+    assert_matches(decode_in_chunks(options, 4096), expected);
+}
+
+//=============================================================================
+// Test: decode_into with resampling (swr writes to caller memory)
+//=============================================================================
+void test_decode_into_resample()
+{
+    std::cout << "Running test_decode_into_resample..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    auto expected = decode_reference(options);
+
+    assert_matches(decode_in_chunks(options, 160), expected);
+    assert_matches(decode_in_chunks(options, 8000), expected);
+}
+
+//=============================================================================
+// Test: decode_all_into with a presized buffer
+//=============================================================================
+void test_decode_all_into()
+{
+    std::cout << "Running test_decode_all_into..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    auto expected = decode_reference(options);
+
+    AudioDecoder decoder(options);
+    decoder.open(TEST_FILE_PATH);
+    assert(decoder.output_num_channels() == EXPECTED_NUM_CHANNELS);
+    assert(decoder.output_sample_format() == SampleFormat::F32);
+    assert(decoder.output_layout() == SampleLayout::Planar);
+
+    size_t capacity = static_cast<size_t>(expected.num_samples()) + 1000;
+    AudioBuffer buffer(EXPECTED_NUM_CHANNELS, static_cast<int64_t>(capacity), 16000);
+    float *ptrs[EXPECTED_NUM_CHANNELS] = {buffer.channel(0), buffer.channel(1)};
+
+    size_t written = decoder.decode_all_into(ptrs, capacity);
+    std::cout << "written: " << written << std::endl;
+    assert(decoder.is_finished());
+    assert((int64_t)written == expected.num_samples());
+
+    buffer.resize(static_cast<int64_t>(written));
+    for (int c = 0; c < EXPECTED_NUM_CHANNELS; ++c)
+    {
+        auto actual = buffer.channel_span(c);
+        auto reference = expected.channel_span(c);
+        assert(std::equal(actual.begin(), actual.end(), reference.begin()));
+    }
+
+    // Too small: stops at capacity, decoding can continue afterwards
+    AudioDecoder partial_decoder(options);
+    partial_decoder.open(TEST_FILE_PATH);
+    written = partial_decoder.decode_all_into(ptrs, 16000);
+    assert(written == 16000);
+    assert(!partial_decoder.is_finished());
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Decoder decode_into Tests ===" << std::endl;
+
+    std::ifstream check_file(TEST_FILE_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << TEST_FILE_PATH << std::endl;
+        return 1;
+    }
+
+    test_decode_into_passthrough();
+    test_decode_into_resample();
+    test_decode_all_into();
+
+    std::cout << "All decode_into tests passed!" << std::endl;
+
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <algorithm>
 
@@ -153,6 +154,33 @@ void test_decode_from_memory()
   assert((int)total_samples == EXPECTED_NUM_FRAMES);
 }
 
+//=============================================================================
+// Test 3b: Memory Decode with the decoder holding the bytes alive
+//=============================================================================
+void test_memory_owner()
+{
+  std::cout << "Running test_memory_owner..." << std::endl;
+  AudioStreamOptions options;
+  options.output_sample_rate = 16000;
+  AudioDecoder reference(options);
+  reference.open(WAV_PATH);
+  auto expected = reference.decode_all();
+
+  auto bytes = std::make_shared<std::vector<uint8_t>>(read_file_bytes(WAV_PATH));
+  std::weak_ptr<std::vector<uint8_t>> watch = bytes;
+  AudioDecoder decoder(options);
+  decoder.open_memory(bytes->data(), bytes->size(), bytes);
+  bytes.reset(); // The decoder's reference is the last one
+  assert(!watch.expired());
+  auto decoded = decoder.decode_all();
+  assert(decoded.num_samples() == expected.num_samples());
+  assert(std::memcmp(decoded.channel(0), expected.channel(0), decoded.num_samples() * sizeof(float)) == 0);
+
+  // Released as soon as the next source replaces it
+  decoder.reopen(WAV_PATH);
+  assert(watch.expired());
+}
+
 //=============================================================================
 // Test 4: PCM Decode from Memory (raw PCM without WAV header)
 //=============================================================================
@@ -296,6 +324,83 @@ void test_metadata_format()
   assert(metadata.duration < 100.0);
 }
 
+//=============================================================================
+// Test 6: Zero-copy frame view
+//=============================================================================
+void test_decode_next_view()
+{
+  std::cout << "Running test_decode_next_view..." << std::endl;
+  AudioDecoder decoder;
+  decoder.open(MP3_PATH);
+
+  size_t total_samples = 0;
+  uint64_t last_generation = decoder.frame_generation();
+  while (!decoder.is_finished())
+  {
+    auto view = decoder.decode_next_view();
+    assert(view.generation != last_generation);
+    assert(view.generation == decoder.frame_generation());
+    last_generation = view.generation;
+    if (view.empty())
+      break;
+
+    assert(view.num_channels == EXPECTED_NUM_CHANNELS);
+    assert(view.sample_rate == EXPECTED_SAMPLE_RATE);
+    assert((int)view.channel(1).size() == view.num_samples);
+    total_samples += view.num_samples;
+  }
+
+  assert((int)total_samples == EXPECTED_NUM_FRAMES);
+}
+
+//=============================================================================
+// Test: reopen() reuses codec/resampler setup without changing the output
+//=============================================================================
+void assert_same_audio(const AudioBuffer &actual, const AudioBuffer &expected)
+{
+  assert(actual.num_channels() == expected.num_channels());
+  assert(actual.num_samples() == expected.num_samples());
+  for (int c = 0; c < expected.num_channels(); ++c)
+  {
+    auto a = actual.channel_span(c);
+    auto e = expected.channel_span(c);
+    assert(std::equal(a.begin(), a.end(), e.begin()));
+  }
+}
+
+void test_reopen()
+{
+  std::cout << "Running test_reopen..." << std::endl;
+  AudioStreamOptions options;
+  options.output_sample_rate = 16000;
+  options.output_num_channels = 1;
+
+  AudioDecoder fresh_mp3(options), fresh_wav(options);
+  fresh_mp3.open(MP3_PATH);
+  fresh_wav.open(WAV_PATH);
+  auto mp3_reference = fresh_mp3.decode_all();
+  auto wav_reference = fresh_wav.decode_all();
+
+  // Same codec back to back (contexts reused), then a codec switch
+  AudioDecoder decoder(options);
+  decoder.reopen(MP3_PATH);
+  assert_same_audio(decoder.decode_all(), mp3_reference);
+
+  // Reopen in the middle of a file, with output still buffered in the resampler
+  decoder.reopen(MP3_PATH);
+  decoder.decode_next_view();
+  decoder.reopen(MP3_PATH);
+  assert_same_audio(decoder.decode_all(), mp3_reference);
+
+  decoder.reopen(WAV_PATH);
+  assert(decoder.get_metadata().codec == "pcm_s16le");
+  assert_same_audio(decoder.decode_all(), wav_reference);
+
+  auto buffer = read_file_bytes(MP3_PATH);
+  decoder.reopen_memory(buffer.data(), buffer.size());
+  assert_same_audio(decoder.decode_all(), mp3_reference);
+}
+
 //=============================================================================
 // Main Test Runner
 //=============================================================================
@@ -317,8 +422,11 @@ int main(int argc, char **argv)
     test_decode_from_filepath();
     test_decode_from_url();
     test_decode_from_memory();
+    test_memory_owner();
     test_decode_pcm_from_memory();
     test_streaming_decode();
+    test_decode_next_view();
+    test_reopen();
 
     std::cout << "All tests passed!" << std::endl;
   }
@@ -0,0 +1,290 @@
+// Unit tests for selectable output sample formats and layouts
+// Tests cover: S16 / F16 / F32 output in planar and interleaved layouts
+// against the default planar float decode (via decode_all, decode_next_view
+// and decode_into), 16-bit passthrough, buffer sizes, parallel decoding,
+// and rejection of mismatched element types
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+AudioBuffer decode_with(const std::string &path, SampleFormat format, SampleLayout layout,
+                        std::optional<int> sample_rate = std::nullopt)
+{
+    AudioStreamOptions options;
+    options.output_sample_rate = sample_rate;
+    options.output_sample_format = format;
+    options.output_layout = layout;
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+// Reference binary16 decoding, independent of the library's converter
+float half_bits_to_float(uint16_t h)
+{
+    int exponent = (h >> 10) & 0x1f;
+    int mantissa = h & 0x3ff;
+    float magnitude = exponent == 0 ? std::ldexp(static_cast<float>(mantissa), -24)
+                                    : std::ldexp(static_cast<float>(mantissa | 0x400), exponent - 25);
+    return (h & 0x8000) ? -magnitude : magnitude;
+}
+
+// Element (channel c, sample i) of a buffer in any layout
+template <typename T>
+T sample_at(const AudioBuffer &buffer, int c, int64_t i)
+{
+    if (buffer.layout() == SampleLayout::Planar)
+        return buffer.channel<T>(c)[i];
+    return buffer.data<T>()[i * buffer.num_channels() + c];
+}
+
+// Compare against the planar float reference with the precision of `format`
+void assert_matches_reference(const AudioBuffer &actual, const AudioBuffer &reference)
+{
+    assert(actual.num_channels() == reference.num_channels());
+    assert(actual.num_samples() == reference.num_samples());
+    assert(actual.sample_rate() == reference.sample_rate());
+
+    for (int c = 0; c < reference.num_channels(); ++c)
+    {
+        const float *ref = reference.channel(c);
+        for (int64_t i = 0; i < reference.num_samples(); ++i)
+        {
+            switch (actual.format())
+            {
+            case SampleFormat::F32:
+                assert(sample_at<float>(actual, c, i) == ref[i]);
+                break;
+            case SampleFormat::S16:
+            {
+                long expected = std::clamp(std::lrint(ref[i] * 32768.0f), -32768L, 32767L);
+                assert(std::abs(sample_at<int16_t>(actual, c, i) - expected) <= 1);
+                break;
+            }
+            case SampleFormat::F16:
+            {
+                float value = half_bits_to_float(sample_at<uint16_t>(actual, c, i));
+                assert(std::fabs(value - ref[i]) <= std::fabs(ref[i]) * 0x1p-11f + 0x1p-25f);
+                break;
+            }
+            }
+        }
+    }
+}
+
+//=============================================================================
+// Test: decode_all() in every format and layout
+//=============================================================================
+void test_formats_and_layouts()
+{
+    std::cout << "Running test_formats_and_layouts..." << std::endl;
+    for (const auto &path : {MP3_PATH, WAV_PATH})
+    {
+        for (std::optional<int> rate : {std::optional<int>(), std::optional<int>(16000)})
+        {
+            auto reference = decode_with(path, SampleFormat::F32, SampleLayout::Planar, rate);
+            for (auto format : {SampleFormat::F32, SampleFormat::S16, SampleFormat::F16})
+            {
+                for (auto layout : {SampleLayout::Planar, SampleLayout::Interleaved})
+                {
+                    auto buffer = decode_with(path, format, layout, rate);
+                    assert(buffer.format() == format && buffer.layout() == layout);
+                    assert_matches_reference(buffer, reference);
+                }
+            }
+        }
+        std::cout << "  " << path << ": OK" << std::endl;
+    }
+}
+
+//=============================================================================
+// Test: 16-bit buffers take half the memory of float buffers
+//=============================================================================
+void test_buffer_size()
+{
+    std::cout << "Running test_buffer_size..." << std::endl;
+    auto f32 = decode_with(MP3_PATH, SampleFormat::F32, SampleLayout::Planar);
+    auto f16 = decode_with(MP3_PATH, SampleFormat::F16, SampleLayout::Interleaved);
+    std::cout << "  f32 planar: " << f32.size_bytes() << " bytes, f16 interleaved: "
+              << f16.size_bytes() << " bytes" << std::endl;
+    assert(f16.size_bytes() * 2 <= f32.size_bytes() + 2 * AudioBuffer::kAlignment);
+}
+
+//=============================================================================
+// Test: Frame views and decode_into carry the output type
+//=============================================================================
+void test_views_and_decode_into()
+{
+    std::cout << "Running test_views_and_decode_into..." << std::endl;
+    auto reference = decode_with(MP3_PATH, SampleFormat::S16, SampleLayout::Interleaved);
+    const int channels = reference.num_channels();
+
+    AudioStreamOptions options;
+    options.output_sample_format = SampleFormat::S16;
+    options.output_layout = SampleLayout::Interleaved;
+
+    // Views
+    AudioDecoder viewer(options);
+    viewer.open(MP3_PATH);
+    std::vector<int16_t> from_views;
+    while (!viewer.is_finished())
+    {
+        auto view = viewer.decode_next_view();
+        if (view.empty())
+            continue;
+        assert(view.format == SampleFormat::S16 && view.layout == SampleLayout::Interleaved);
+        auto samples = view.interleaved<int16_t>();
+        from_views.insert(from_views.end(), samples.begin(), samples.end());
+    }
+    auto expected = reference.interleaved_span<int16_t>();
+    assert(std::equal(from_views.begin(), from_views.end(), expected.begin(), expected.end()));
+
+    // decode_into with small chunks (a single interleaved plane)
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    std::vector<int16_t> from_chunks(expected.size());
+    size_t total = 0;
+    while (!decoder.is_finished())
+    {
+        int16_t *plane = from_chunks.data() + total * channels;
+        total += decoder.decode_into(&plane, std::min<size_t>(1000, expected.size() / channels - total));
+        if (total * channels == expected.size())
+            break;
+    }
+    assert(std::equal(from_chunks.begin(), from_chunks.end(), expected.begin()));
+
+    // Element type must match the configured format
+    AudioDecoder mismatched(options);
+    mismatched.open(WAV_PATH);
+    std::vector<float> wrong(1024);
+    float *wrong_plane = wrong.data();
+    bool threw = false;
+    try
+    {
+        mismatched.decode_into(&wrong_plane, 1024);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    // AudioSamples stays planar float
+    threw = false;
+    try
+    {
+        mismatched.decode_next();
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+//=============================================================================
+// Test: F16 decode_into at a changed rate (float staging in chunks)
+//=============================================================================
+void test_half_decode_into()
+{
+    std::cout << "Running test_half_decode_into..." << std::endl;
+    auto reference = decode_with(MP3_PATH, SampleFormat::F16, SampleLayout::Planar, 16000);
+
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.output_sample_format = SampleFormat::F16;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+
+    AudioBuffer buffer(reference.num_channels(), reference.num_samples(), 16000, SampleFormat::F16);
+    std::vector<uint16_t *> planes(buffer.num_channels());
+    for (int c = 0; c < buffer.num_channels(); ++c)
+        planes[c] = buffer.channel<uint16_t>(c);
+    size_t written = decoder.decode_all_into(planes.data(), buffer.capacity());
+    assert(static_cast<int64_t>(written) == reference.num_samples());
+    for (int c = 0; c < buffer.num_channels(); ++c)
+        assert(std::memcmp(planes[c], reference.channel<uint16_t>(c), written * sizeof(uint16_t)) == 0);
+}
+
+//=============================================================================
+// Test: 16-bit PCM to S16 is an exact copy of the source samples
+//=============================================================================
+void test_s16_passthrough()
+{
+    std::cout << "Running test_s16_passthrough..." << std::endl;
+    auto buffer = decode_with(WAV_PATH, SampleFormat::S16, SampleLayout::Interleaved);
+
+    // zh.wav: 44-byte header, 16-bit mono PCM
+    std::ifstream file(WAV_PATH, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), {});
+    assert(bytes.size() >= 44 + buffer.num_samples() * sizeof(int16_t));
+    assert(std::memcmp(bytes.data() + 44, buffer.data<int16_t>(),
+                       buffer.num_samples() * sizeof(int16_t)) == 0);
+}
+
+//=============================================================================
+// Test: Parallel decoding honors the output format
+//=============================================================================
+void test_parallel_formats()
+{
+    std::cout << "Running test_parallel_formats..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.output_sample_format = SampleFormat::S16;
+    options.output_layout = SampleLayout::Interleaved;
+    auto serial = decode_with(MP3_PATH, SampleFormat::S16, SampleLayout::Interleaved, 16000);
+    auto parallel = decode_file_parallel(MP3_PATH, options, 4);
+    assert(parallel.format() == SampleFormat::S16 && parallel.layout() == SampleLayout::Interleaved);
+    assert(parallel.num_samples() == serial.num_samples());
+    auto a = parallel.interleaved_span<int16_t>();
+    auto b = serial.interleaved_span<int16_t>();
+    assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Output Format Tests ===" << std::endl;
+    avioflow_set_log_level("error");
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_formats_and_layouts();
+    test_buffer_size();
+    test_views_and_decode_into();
+    test_half_decode_into();
+    test_s16_passthrough();
+    test_parallel_formats();
+
+    std::cout << "All output format tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Unit tests for packet-index based seeking
+// Tests cover: seeking through an in-process packet index, sidecar
+// save/load round trips (automatic and explicit), corrupt and stale
+// sidecar detection
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string INDEX_PATH = "./TownTheme.mp3.avfidx";
+const std::string COPY_PATH = "./TownTheme-copy.mp3";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+AudioBuffer decode_reference(const AudioStreamOptions &options)
+{
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    return decoder.decode_all();
+}
+
+std::string read_file(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+void check_seek(AudioDecoder &decoder, const AudioBuffer &reference, int64_t target)
+{
+    decoder.seek_to_sample(target);
+    auto tail = decoder.decode_all();
+    std::cout << "  seek_to_sample(" << target << "): remaining " << tail.num_samples() << std::endl;
+    assert(tail.num_samples() == reference.num_samples() - target);
+    for (int c = 0; c < reference.num_channels(); ++c)
+    {
+        auto actual = tail.channel_span(c);
+        assert(std::equal(actual.begin(), actual.end(), reference.channel(c) + target));
+    }
+}
+
+//=============================================================================
+// Test: Seeking with an in-process packet index
+//=============================================================================
+void test_seek_with_index()
+{
+    std::cout << "Running test_seek_with_index..." << std::endl;
+    auto reference = decode_reference({});
+
+    AudioStreamOptions options;
+    options.use_packet_index = true;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+
+    for (int64_t target : {0, 777, 44100 * 45 + 517, 4200000})
+        check_seek(decoder, reference, target);
+
+    // Resampled output stays on the same grid as a decode from the start
+    options.output_sample_rate = 16000;
+    auto resampled_reference = decode_reference(options);
+    AudioDecoder resampled_decoder(options);
+    resampled_decoder.open(MP3_PATH);
+    check_seek(resampled_decoder, resampled_reference, 16000 * 42 + 11);
+}
+
+//=============================================================================
+// Test: Sidecar file round trip
+//=============================================================================
+void test_sidecar_round_trip()
+{
+    std::cout << "Running test_sidecar_round_trip..." << std::endl;
+    auto reference = decode_reference({});
+    std::filesystem::remove(INDEX_PATH);
+
+    // First open builds and writes the sidecar
+    AudioStreamOptions options;
+    options.packet_index_path = INDEX_PATH;
+    {
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        assert(std::filesystem::exists(INDEX_PATH));
+        check_seek(decoder, reference, 44100 * 20);
+    }
+
+    // Second open loads it
+    auto modified_before = std::filesystem::last_write_time(INDEX_PATH);
+    {
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        assert(std::filesystem::last_write_time(INDEX_PATH) == modified_before);
+        check_seek(decoder, reference, 44100 * 70 + 3);
+    }
+
+    // A corrupt sidecar is rebuilt instead of trusted
+    {
+        std::ofstream corrupt(INDEX_PATH, std::ios::binary | std::ios::trunc);
+        corrupt << "not an index";
+    }
+    {
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        check_seek(decoder, reference, 44100 * 5);
+    }
+
+    // So is one whose entry count exceeds the file (count follows the magic
+    // and three 64-bit header fields)
+    {
+        std::fstream patch(INDEX_PATH, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t huge = uint64_t(1) << 58;
+        patch.seekp(8 + 3 * sizeof(int64_t));
+        patch.write(reinterpret_cast<const char *>(&huge), sizeof(huge));
+    }
+    {
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        check_seek(decoder, reference, 44100 * 8);
+    }
+
+    // Explicit build + save writes a sidecar that packet_index_path loads
+    std::filesystem::remove(INDEX_PATH);
+    {
+        AudioDecoder decoder;
+        decoder.open(MP3_PATH);
+        decoder.build_packet_index();
+        decoder.save_packet_index(INDEX_PATH);
+        assert(std::filesystem::file_size(INDEX_PATH) > 0);
+        check_seek(decoder, reference, 123456);
+    }
+    std::string saved = read_file(INDEX_PATH);
+    {
+        AudioDecoder decoder(options);
+        decoder.open(MP3_PATH);
+        assert(read_file(INDEX_PATH) == saved); // Loaded, not rebuilt
+        check_seek(decoder, reference, 44100 * 30);
+    }
+
+    std::filesystem::remove(INDEX_PATH);
+}
+
+//=============================================================================
+// Test: A sidecar of a source that changed since is rebuilt
+//=============================================================================
+void test_stale_sidecar()
+{
+    std::cout << "Running test_stale_sidecar..." << std::endl;
+    std::filesystem::copy_file(MP3_PATH, COPY_PATH, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::remove(INDEX_PATH);
+
+    AudioStreamOptions options;
+    options.packet_index_path = INDEX_PATH;
+    {
+        AudioDecoder decoder(options);
+        decoder.open(COPY_PATH);
+    }
+    std::string written = read_file(INDEX_PATH);
+
+    // The source was rewritten since: same size, newer modification time
+    std::filesystem::last_write_time(COPY_PATH,
+                                     std::filesystem::last_write_time(COPY_PATH) + std::chrono::seconds(10));
+    {
+        AudioDecoder decoder(options);
+        decoder.open(COPY_PATH);
+        decoder.seek_to_sample(44100 * 10);
+        assert(!decoder.decode_all().empty());
+    }
+    assert(read_file(INDEX_PATH) != written); // Restamped for the new version
+
+    std::filesystem::remove(INDEX_PATH);
+    std::filesystem::remove(COPY_PATH);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Packet Index Tests ===" << std::endl;
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_seek_with_index();
+    test_sidecar_round_trip();
+    test_stale_sidecar();
+
+    std::cout << "All packet index tests passed!" << std::endl;
+
+    return 0;
+}
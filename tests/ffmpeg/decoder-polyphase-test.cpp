@@ -0,0 +1,281 @@
+// Unit tests for the built-in polyphase resampler (Resampler::Polyphase)
+// Tests cover: agreement with swresample, identical output whether decoded
+// frame by frame, into chunks or all at once, exact seeking, passband gain
+// and stopband attenuation of tones, interleaved/F16/mono output, and the
+// swresample fallback for S16 output
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+
+constexpr int TARGET_RATE = 16000;
+constexpr double PI = 3.14159265358979323846;
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+AudioStreamOptions polyphase_options(int rate = TARGET_RATE)
+{
+    AudioStreamOptions options;
+    options.output_sample_rate = rate;
+    options.resampler = Resampler::Polyphase;
+    return options;
+}
+
+AudioBuffer decode_file(const AudioStreamOptions &options, const std::string &path = MP3_PATH)
+{
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+// 16-bit mono WAV file holding `seconds` of a sine at `frequency`
+std::vector<uint8_t> make_tone_wav(int rate, double frequency, double seconds)
+{
+    int frames = static_cast<int>(rate * seconds);
+    uint32_t data_bytes = frames * 2;
+    std::vector<uint8_t> wav(44 + data_bytes);
+    auto put32 = [&](size_t at, uint32_t v) { std::memcpy(wav.data() + at, &v, 4); };
+    auto put16 = [&](size_t at, uint16_t v) { std::memcpy(wav.data() + at, &v, 2); };
+    std::memcpy(wav.data(), "RIFF", 4);
+    put32(4, 36 + data_bytes);
+    std::memcpy(wav.data() + 8, "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, 1);        // PCM
+    put16(22, 1);        // Mono
+    put32(24, rate);
+    put32(28, rate * 2); // Byte rate
+    put16(32, 2);        // Block align
+    put16(34, 16);
+    std::memcpy(wav.data() + 36, "data", 4);
+    put32(40, data_bytes);
+    for (int i = 0; i < frames; ++i)
+    {
+        auto v = static_cast<int16_t>(std::lround(16384.0 * std::sin(2.0 * PI * frequency * i / rate)));
+        put16(44 + i * 2, static_cast<uint16_t>(v));
+    }
+    return wav;
+}
+
+// RMS of the middle 80% of a channel (skips the filter's edges)
+double rms(const float *samples, int64_t count)
+{
+    int64_t begin = count / 10, end = count - count / 10;
+    double sum = 0;
+    for (int64_t i = begin; i < end; ++i)
+        sum += static_cast<double>(samples[i]) * samples[i];
+    return std::sqrt(sum / (end - begin));
+}
+
+// Level of a resampled tone relative to its input, in dB
+double tone_gain_db(int in_rate, int out_rate, double frequency)
+{
+    auto wav = make_tone_wav(in_rate, frequency, 1.0);
+    AudioDecoder decoder(polyphase_options(out_rate));
+    decoder.open_memory(wav.data(), wav.size());
+    auto buffer = decoder.decode_all();
+    assert(buffer.sample_rate() == out_rate);
+    assert(std::abs(buffer.num_samples() - out_rate) <= out_rate / 100); // No flush at the end
+    double input_rms = 0.5 / std::sqrt(2.0);
+    return 20.0 * std::log10(std::max(rms(buffer.channel(0), buffer.num_samples()), 1e-12) / input_rms);
+}
+
+//=============================================================================
+// Test: Same length as swresample and close to its output
+//=============================================================================
+void test_matches_swresample()
+{
+    std::cout << "Running test_matches_swresample..." << std::endl;
+    AudioStreamOptions swr_options;
+    swr_options.output_sample_rate = TARGET_RATE;
+    auto swr = decode_file(swr_options);
+    auto poly = decode_file(polyphase_options());
+
+    std::cout << "  swr: " << swr.num_samples() << ", polyphase: " << poly.num_samples() << std::endl;
+    assert(poly.num_channels() == swr.num_channels());
+    assert(poly.sample_rate() == TARGET_RATE);
+    assert(std::abs(poly.num_samples() - swr.num_samples()) <= 64);
+
+    // Same sample grid: the difference is filter ripple, far below the signal
+    int64_t count = std::min(poly.num_samples(), swr.num_samples());
+    for (int c = 0; c < poly.num_channels(); ++c)
+    {
+        double signal = 0, noise = 0;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            double d = poly.channel(c)[i] - swr.channel(c)[i];
+            signal += static_cast<double>(swr.channel(c)[i]) * swr.channel(c)[i];
+            noise += d * d;
+        }
+        double snr = 10.0 * std::log10(signal / std::max(noise, 1e-30));
+        std::cout << "  channel " << c << " SNR vs swr: " << snr << " dB" << std::endl;
+        assert(snr > 40.0);
+    }
+}
+
+//=============================================================================
+// Test: Streaming state carries across frames and calls
+//=============================================================================
+void test_streaming_consistency()
+{
+    std::cout << "Running test_streaming_consistency..." << std::endl;
+    auto all = decode_file(polyphase_options());
+
+    // Frame by frame
+    AudioDecoder frames(polyphase_options());
+    frames.open(MP3_PATH);
+    int64_t offset = 0;
+    while (!frames.is_finished())
+    {
+        auto frame = frames.decode_next();
+        if (frame.data.empty())
+            continue;
+        for (int c = 0; c < all.num_channels(); ++c)
+            assert(std::memcmp(frame.data[c].data(), all.channel(c) + offset,
+                               frame.data[c].size() * sizeof(float)) == 0);
+        offset += frame.data[0].size();
+    }
+    assert(offset == all.num_samples());
+
+    // Small fixed-size chunks
+    AudioDecoder chunks(polyphase_options());
+    chunks.open(MP3_PATH);
+    constexpr size_t CHUNK = 777;
+    std::vector<std::vector<float>> storage(all.num_channels(), std::vector<float>(CHUNK));
+    std::vector<float *> planes;
+    for (auto &plane : storage)
+        planes.push_back(plane.data());
+    offset = 0;
+    while (size_t n = chunks.decode_into(planes.data(), CHUNK))
+    {
+        for (int c = 0; c < all.num_channels(); ++c)
+            assert(std::memcmp(storage[c].data(), all.channel(c) + offset, n * sizeof(float)) == 0);
+        offset += n;
+    }
+    assert(offset == all.num_samples());
+}
+
+//=============================================================================
+// Test: Seeking lands on the same samples as a full decode
+//=============================================================================
+void test_seek()
+{
+    std::cout << "Running test_seek..." << std::endl;
+    auto all = decode_file(polyphase_options());
+
+    AudioDecoder decoder(polyphase_options());
+    decoder.open(MP3_PATH);
+    for (int64_t target : {int64_t(TARGET_RATE * 30), int64_t(12345), int64_t(TARGET_RATE * 60 + 7)})
+    {
+        decoder.seek_to_sample(target);
+        auto tail = decoder.decode_all();
+        int64_t expected_count = all.num_samples() - target;
+        double max_diff = 0;
+        for (int c = 0; c < all.num_channels(); ++c)
+            for (int64_t i = 0; i < std::min(tail.num_samples(), expected_count); ++i)
+                max_diff = std::max(max_diff, static_cast<double>(std::fabs(tail.channel(c)[i] - all.channel(c)[target + i])));
+        std::cout << "  sample " << target << ": remaining " << tail.num_samples() << " (expected "
+                  << expected_count << "), max diff " << max_diff << std::endl;
+        assert(std::llabs(tail.num_samples() - expected_count) <= 32);
+        assert(max_diff < 1e-3);
+    }
+}
+
+//=============================================================================
+// Test: Passband tones keep their level, tones above Nyquist are removed
+//=============================================================================
+void test_tone_response()
+{
+    std::cout << "Running test_tone_response..." << std::endl;
+    struct Case
+    {
+        int in_rate, out_rate;
+        double frequency;
+        bool passband;
+    };
+    const Case cases[] = {
+        {48000, 16000, 1000.0, true},  {48000, 16000, 6000.0, true},  {48000, 16000, 10000.0, false},
+        {44100, 16000, 1000.0, true},  {44100, 16000, 12000.0, false}, {8000, 16000, 1000.0, true},
+        {8000, 16000, 3000.0, true},   {44100, 48000, 15000.0, true},
+    };
+    for (const auto &c : cases)
+    {
+        double gain = tone_gain_db(c.in_rate, c.out_rate, c.frequency);
+        std::cout << "  " << c.in_rate << " -> " << c.out_rate << ", " << c.frequency << " Hz: " << gain
+                  << " dB" << std::endl;
+        if (c.passband)
+            assert(std::fabs(gain) < 0.5);
+        else
+            assert(gain < -40.0);
+    }
+}
+
+//=============================================================================
+// Test: Interleaved, F16 and mono output; S16 output stays on swresample
+//=============================================================================
+void test_output_formats()
+{
+    std::cout << "Running test_output_formats..." << std::endl;
+    auto planar = decode_file(polyphase_options());
+
+    auto options = polyphase_options();
+    options.output_layout = SampleLayout::Interleaved;
+    auto interleaved = decode_file(options);
+    assert(interleaved.num_samples() == planar.num_samples());
+    auto frames = interleaved.interleaved_span<float>();
+    int channels = planar.num_channels();
+    for (int64_t i = 0; i < planar.num_samples(); ++i)
+        for (int c = 0; c < channels; ++c)
+            assert(frames[i * channels + c] == planar.channel(c)[i]);
+
+    options = polyphase_options();
+    options.output_sample_format = SampleFormat::F16;
+    auto half = decode_file(options);
+    assert(half.format() == SampleFormat::F16);
+    assert(half.num_samples() == planar.num_samples());
+
+    options = polyphase_options();
+    options.output_num_channels = 1;
+    auto mono = decode_file(options);
+    assert(mono.num_channels() == 1);
+    assert(std::abs(mono.num_samples() - planar.num_samples()) <= 1);
+
+    // S16 output is not handled by the polyphase engine: same as swresample
+    options = polyphase_options();
+    options.output_sample_format = SampleFormat::S16;
+    auto s16_poly = decode_file(options);
+    options.resampler = Resampler::SwResample;
+    auto s16_swr = decode_file(options);
+    assert(s16_poly.num_samples() == s16_swr.num_samples());
+    assert(std::memcmp(s16_poly.data<int16_t>(), s16_swr.data<int16_t>(), s16_swr.size_bytes()) == 0);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Polyphase Resampler Tests ===" << std::endl;
+
+    test_matches_swresample();
+    test_streaming_consistency();
+    test_seek();
+    test_tone_response();
+    test_output_formats();
+
+    std::cout << "\nAll polyphase resampler tests passed!" << std::endl;
+    return 0;
+}
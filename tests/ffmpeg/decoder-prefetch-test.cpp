@@ -0,0 +1,235 @@
+// Unit tests for background decoding (AudioStreamOptions::prefetch_frames)
+// Tests cover: prefetched frames equal to synchronous decoding (plain,
+// resampled, chunked with overlap), pop timeouts on a stream waiting for
+// data, seeking and reopening while the thread runs ahead, sync-only
+// methods rejected, and output buffers staying pooled
+//
+// Usage: ./ffmpeg-decoder-prefetch-test [audio_path]
+
+#include "avioflow-cxx-api.h"
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// Every output frame of channel 0, frame by frame
+std::vector<std::vector<float>> collect(AudioDecoder &decoder, int max_frames = -1)
+{
+    std::vector<std::vector<float>> frames;
+    while (!decoder.is_finished() && max_frames != 0)
+    {
+        auto view = decoder.decode_next_view();
+        if (view.empty())
+            continue;
+        auto channel = view.channel(0);
+        frames.emplace_back(channel.begin(), channel.end());
+        --max_frames;
+    }
+    return frames;
+}
+
+std::vector<std::vector<float>> decode_frames(const std::string &path, AudioStreamOptions options,
+                                              int prefetch_frames)
+{
+    options.prefetch_frames = prefetch_frames;
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return collect(decoder);
+}
+
+template <typename Fn> bool throws(Fn &&fn)
+{
+    try
+    {
+        fn();
+    }
+    catch (const std::exception &)
+    {
+        return true;
+    }
+    return false;
+}
+
+//=============================================================================
+// Test: Prefetched frames equal synchronous ones
+//=============================================================================
+void test_matches_sync()
+{
+    std::cout << "Running test_matches_sync..." << std::endl;
+
+    AudioStreamOptions plain;
+    AudioStreamOptions resampled;
+    resampled.output_sample_rate = 16000;
+    AudioStreamOptions chunked;
+    chunked.chunk_samples = 400;
+    chunked.hop_samples = 160; // Overlap: chunks share samples
+
+    for (const auto &path : {MP3_PATH, WAV_PATH})
+    {
+        for (const auto &options : {plain, resampled, chunked})
+        {
+            auto sync = decode_frames(path, options, 0);
+            for (int depth : {1, 8})
+            {
+                auto prefetched = decode_frames(path, options, depth);
+                assert(prefetched == sync);
+            }
+            std::cout << "  " << path << ": " << sync.size() << " frames" << std::endl;
+        }
+    }
+}
+
+//=============================================================================
+// Test: A timed pop returns empty while the stream has no data
+//=============================================================================
+void test_timeout()
+{
+    std::cout << "Running test_timeout..." << std::endl;
+    std::vector<uint8_t> pcm(16000 * 10 * 2);
+    for (size_t i = 0; i < pcm.size(); ++i)
+        pcm[i] = static_cast<uint8_t>(i * 7);
+
+    // The first 6 s (more than opening reads) are available at first, the
+    // rest on demand
+    std::atomic<size_t> available{pcm.size() * 6 / 10};
+    size_t pos = 0;
+    AudioStreamOptions options;
+    options.input_format = "s16le";
+    options.input_sample_rate = 16000;
+    options.input_channels = 1;
+    options.analyze_duration = 100000;
+    options.prefetch_frames = 4;
+    AudioDecoder decoder;
+    decoder.open_stream(
+        [&](uint8_t *buf, int size) {
+            size_t end = available.load();
+            if (pos == pcm.size())
+                return 0;
+            if (pos == end)
+                return -1; // No data yet
+            int count = static_cast<int>(std::min<size_t>(size, end - pos));
+            std::memcpy(buf, pcm.data() + pos, count);
+            pos += count;
+            return count;
+        },
+        nullptr, options);
+
+    int64_t samples = 0;
+    while (true)
+    {
+        auto view = decoder.decode_next_view(std::chrono::milliseconds(50));
+        if (view.empty())
+            break;
+        samples += view.num_samples;
+    }
+    assert(samples > 0 && samples <= 16000 * 6);
+    assert(!decoder.is_finished()); // Timed out, not at the end
+
+    available = pcm.size();
+    while (!decoder.is_finished())
+        samples += decoder.decode_next_view(std::chrono::milliseconds(1000)).num_samples;
+    assert(samples == 16000 * 10);
+}
+
+//=============================================================================
+// Test: Seeking and reopening restart the thread at the new position
+//=============================================================================
+void test_seek_and_reopen()
+{
+    std::cout << "Running test_seek_and_reopen..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    AudioDecoder sync(options);
+    sync.open(MP3_PATH);
+    options.prefetch_frames = 6;
+    AudioDecoder prefetched(options);
+    prefetched.open(MP3_PATH);
+
+    // Queue full and decoder ahead of the consumer when the seek lands
+    assert(collect(prefetched, 3).size() == 3);
+    for (int64_t sample : {int64_t(480000), int64_t(16000), int64_t(0)})
+    {
+        sync.seek_to_sample(sample);
+        prefetched.seek_to_sample(sample);
+        assert(collect(prefetched, 10) == collect(sync, 10));
+    }
+
+    prefetched.reopen(WAV_PATH);
+    sync.reopen(WAV_PATH);
+    assert(prefetched.get_metadata().sample_rate == sync.get_metadata().sample_rate);
+    assert(collect(prefetched) == collect(sync));
+    assert(prefetched.is_finished());
+    assert(prefetched.decode_next_view().empty());
+}
+
+//=============================================================================
+// Test: Methods that bypass the frame queue are rejected
+//=============================================================================
+void test_sync_only()
+{
+    std::cout << "Running test_sync_only..." << std::endl;
+    AudioStreamOptions options;
+    options.prefetch_frames = 2;
+    AudioDecoder decoder(options);
+    decoder.open(WAV_PATH);
+    std::vector<float> buffer(1024);
+    float *planes[] = {buffer.data()};
+    assert(throws([&] { decoder.decode_all(); }));
+    assert(throws([&] { decoder.get_all_samples(); }));
+    assert(throws([&] { decoder.decode_into(planes, 1024); }));
+    assert(!decoder.decode_next_view().empty()); // Still usable
+
+    options.prefetch_frames = -1;
+    assert(throws([&] { AudioDecoder invalid(options); }));
+}
+
+//=============================================================================
+// Test: Queued frames keep their pooled buffers; none are allocated per frame
+//=============================================================================
+void test_pooled_buffers()
+{
+    std::cout << "Running test_pooled_buffers..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    options.prefetch_frames = 8;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    size_t frames = collect(decoder).size();
+    auto stats = decoder.get_allocation_stats();
+    std::cout << "  " << frames << " frames, " << stats.buffers_allocated << " buffers allocated"
+              << std::endl;
+    assert(stats.buffers_served >= frames);
+    // The queue, the consumer's frame and the one being decoded
+    assert(stats.buffers_allocated <= 8 + 2 + 2);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        MP3_PATH = argv[1];
+
+    std::cout << "\n=== Decoder Prefetch Tests ===" << std::endl;
+
+    test_matches_sync();
+    test_timeout();
+    test_seek_and_reopen();
+    test_sync_only();
+    test_pooled_buffers();
+
+    std::cout << "\nAll decoder prefetch tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Unit tests for metadata-only probing
+// Tests cover: AudioDecoder::probe() metadata against a full open, bytes read
+// by probe_only vs a full open, probing limits, and that probe_only decoders
+// refuse to decode
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+std::vector<uint8_t> read_file_bytes(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    assert(file.is_open());
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char *>(buffer.data()), size);
+    return buffer;
+}
+
+// Bytes pulled through the read callback while opening `bytes`
+size_t bytes_read_on_open(const std::vector<uint8_t> &bytes, const AudioStreamOptions &options)
+{
+    size_t pos = 0, total = 0;
+    auto read_callback = [&](uint8_t *buf, int buf_size) -> int {
+        size_t count = std::min(static_cast<size_t>(buf_size), bytes.size() - pos);
+        std::memcpy(buf, bytes.data() + pos, count);
+        pos += count;
+        total += count;
+        return static_cast<int>(count);
+    };
+    auto seek_callback = [&](int64_t offset, int whence) -> int64_t {
+        int64_t base = whence == SEEK_CUR ? static_cast<int64_t>(pos)
+                     : whence == SEEK_END ? static_cast<int64_t>(bytes.size()) : 0;
+        if (base + offset < 0 || base + offset > static_cast<int64_t>(bytes.size()))
+            return -1;
+        pos = static_cast<size_t>(base + offset);
+        return static_cast<int64_t>(pos);
+    };
+
+    AudioDecoder decoder;
+    decoder.open_stream(read_callback, seek_callback, options);
+    return total;
+}
+
+void assert_same_stream_info(const Metadata &probed, const Metadata &full)
+{
+    std::cout << "  " << probed.container << "/" << probed.codec << " " << probed.sample_rate << " Hz, "
+              << probed.num_channels << " ch, " << probed.sample_format << ", " << probed.duration
+              << " s, " << probed.bit_rate << " b/s (full open: " << full.duration << " s)" << std::endl;
+    assert(probed.sample_rate == full.sample_rate);
+    assert(probed.num_channels == full.num_channels);
+    assert(probed.codec == full.codec);
+    assert(probed.container == full.container);
+    assert(probed.sample_format == full.sample_format);
+    assert(std::fabs(probed.duration - full.duration) < 0.05);
+    assert(probed.bit_rate > 0);
+}
+
+//=============================================================================
+// Test: probe() reports the same stream info as a full open
+//=============================================================================
+void test_probe_metadata()
+{
+    std::cout << "Running test_probe_metadata..." << std::endl;
+    for (const auto &path : {MP3_PATH, WAV_PATH})
+    {
+        AudioDecoder decoder;
+        decoder.open(path);
+        assert_same_stream_info(AudioDecoder::probe(path), decoder.get_metadata());
+    }
+
+    // Bounded probing still detects a WAV header
+    AudioStreamOptions options;
+    options.probe_size = 4096;
+    options.analyze_duration = 0;
+    auto meta = AudioDecoder::probe(WAV_PATH, options);
+    assert(meta.sample_rate == 16000 && meta.num_channels == 1);
+}
+
+//=============================================================================
+// Test: probe_only reads no more than a full open
+//=============================================================================
+void test_probe_io()
+{
+    std::cout << "Running test_probe_io..." << std::endl;
+    AudioStreamOptions probe_options;
+    probe_options.probe_only = true;
+
+    for (const auto &path : {MP3_PATH, WAV_PATH})
+    {
+        auto bytes = read_file_bytes(path);
+        size_t full = bytes_read_on_open(bytes, {});
+        size_t probed = bytes_read_on_open(bytes, probe_options);
+        std::cout << "  " << path << ": full open " << full << " bytes, probe_only " << probed << " bytes" << std::endl;
+        assert(probed <= full);
+    }
+}
+
+//=============================================================================
+// Test: probe_only decoders do not decode
+//=============================================================================
+void test_probe_only_no_decode()
+{
+    std::cout << "Running test_probe_only_no_decode..." << std::endl;
+    AudioStreamOptions options;
+    options.probe_only = true;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    assert(decoder.get_metadata().sample_rate == 44100);
+
+    bool threw = false;
+    try
+    {
+        decoder.decode_next();
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Probe Tests ===" << std::endl;
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_probe_metadata();
+    test_probe_io();
+    test_probe_only_no_decode();
+
+    std::cout << "All probe tests passed!" << std::endl;
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 // Unit tests for SingleStreamDecoder - Resampling
-// Tests cover: output sample rate conversion to common rates using get_all_samples()
+// Tests cover: output sample rate conversion to common rates using get_all_samples(),
+// decode_all() into an AudioBuffer and its growth past a wrong estimate
 
 #include "avioflow-cxx-api.h"
 #include <cassert>
@@ -7,6 +8,7 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
 using namespace avioflow;
 
@@ -183,6 +185,118 @@ void test_resample_audio_quality()
     }
 }
 
+//=============================================================================
+// Test: Contiguous AudioBuffer matches get_all_samples()
+//=============================================================================
+void test_decode_all_buffer()
+{
+    std::cout << "Running test_decode_all_buffer..." << std::endl;
+    constexpr int TARGET_RATE = 16000;
+
+    AudioDecoder reference_decoder({TARGET_RATE});
+    reference_decoder.open(TEST_FILE_PATH);
+    auto reference = reference_decoder.get_all_samples();
+
+    AudioDecoder decoder({TARGET_RATE});
+    decoder.open(TEST_FILE_PATH);
+    auto buffer = decoder.decode_all();
+
+    std::cout << "num_samples: " << buffer.num_samples() << ", capacity: " << buffer.capacity()
+              << ", stride: " << buffer.stride() << std::endl;
+
+    assert(buffer.sample_rate() == TARGET_RATE);
+    assert(buffer.num_channels() == EXPECTED_NUM_CHANNELS);
+    assert(buffer.num_samples() == (int64_t)reference.data[0].size());
+    assert(buffer.capacity() >= buffer.num_samples());
+    assert(buffer.stride() >= buffer.capacity());
+
+    for (int c = 0; c < buffer.num_channels(); ++c)
+    {
+        assert(reinterpret_cast<uintptr_t>(buffer.channel(c)) % AudioBuffer::kAlignment == 0);
+        auto channel = buffer.channel_span(c);
+        assert(std::equal(channel.begin(), channel.end(), reference.data[c].begin()));
+    }
+}
+
+//=============================================================================
+// Test: AudioBuffer growth past a wrong estimate
+// The first overflow grows once to the needed size plus headroom; only a
+// second one (estimate badly off) falls back to 1.5x
+//=============================================================================
+void test_buffer_growth()
+{
+    std::cout << "Running test_buffer_growth..." << std::endl;
+
+    std::vector<float> samples(AudioBuffer::kHeadroomSamples * 4, 0.5f);
+    const float *planes[EXPECTED_NUM_CHANNELS] = {samples.data(), samples.data()};
+
+    AudioBuffer buffer(EXPECTED_NUM_CHANNELS, 1024);
+    buffer.append(planes, 1024);
+    assert(buffer.capacity() == 1024);
+
+    buffer.append(planes, 16);
+    int64_t grown = buffer.capacity();
+    assert(grown >= 1040 + AudioBuffer::kHeadroomSamples);
+    assert(grown < 1040 + AudioBuffer::kHeadroomSamples + 64);
+
+    buffer.append(planes, grown - buffer.num_samples()); // Fills the headroom without growing
+    assert(buffer.capacity() == grown);
+
+    buffer.append(planes, 1);
+    assert(buffer.capacity() >= grown + grown / 2);
+    assert(buffer.num_samples() == grown + 1);
+    assert(buffer.channel(1)[grown] == 0.5f);
+}
+
+//=============================================================================
+// Test: Frame-by-frame loops over a resampled MP3 reach the end
+// The resampler may hold back a whole frame's output; the 0-sample frame
+// it returns then must not read as the end of the stream
+//=============================================================================
+void test_decode_next_resampled()
+{
+    std::cout << "Running test_decode_next_resampled..." << std::endl;
+    constexpr int TARGET_RATE = 16000;
+
+    for (Resampler resampler : {Resampler::SwResample, Resampler::Polyphase})
+    {
+        AudioStreamOptions options;
+        options.output_sample_rate = TARGET_RATE;
+        options.resampler = resampler;
+
+        AudioDecoder reference(options);
+        reference.open(TEST_FILE_PATH);
+        int64_t expected = reference.decode_all().num_samples();
+
+        // The loop of the CLI tools
+        AudioDecoder decoder(options);
+        decoder.open(TEST_FILE_PATH);
+        int64_t total = 0;
+        while (!decoder.is_finished())
+        {
+            auto samples = decoder.decode_next();
+            if (samples.data.empty())
+                break;
+            assert((int)samples.data.size() == EXPECTED_NUM_CHANNELS);
+            total += samples.data[0].size();
+        }
+        std::cout << "decode_next: " << total << ", decode_all: " << expected << std::endl;
+        assert(total == expected);
+
+        decoder.open(TEST_FILE_PATH);
+        total = 0;
+        while (true)
+        {
+            auto frame = decoder.decode_next_frame();
+            if (frame.empty())
+                break;
+            total += frame.view().num_samples;
+        }
+        assert(decoder.is_finished());
+        assert(total == expected);
+    }
+}
+
 //=============================================================================
 // Main Test Runner
 //=============================================================================
@@ -210,6 +324,9 @@ int main(int argc, char **argv)
     test_resample_44100();
     test_resample_48000();
     test_resample_audio_quality();
+    test_decode_all_buffer();
+    test_buffer_growth();
+    test_decode_next_resampled();
 
     std::cout << "All resample tests passed!" << std::endl;
 
@@ -0,0 +1,196 @@
+// Unit tests for resampler quality presets (AudioStreamOptions::resampler_quality)
+// Tests cover: Default leaves swresample untouched, every preset on both
+// engines (length and closeness to the default), expert overrides, invalid
+// values, and the soxr request without libsoxr
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+
+constexpr int TARGET_RATE = 16000;
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+AudioBuffer decode_with(const ResamplerQuality &quality, Resampler resampler = Resampler::SwResample)
+{
+    AudioStreamOptions options;
+    options.output_sample_rate = TARGET_RATE;
+    options.resampler = resampler;
+    options.resampler_quality = quality;
+    AudioDecoder decoder(options);
+    decoder.open(MP3_PATH);
+    return decoder.decode_all();
+}
+
+bool identical(const AudioBuffer &a, const AudioBuffer &b)
+{
+    return a.num_samples() == b.num_samples() && a.num_channels() == b.num_channels() &&
+           std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+}
+
+// Signal-to-difference ratio of `test` against `reference`, in dB
+double snr_db(const AudioBuffer &reference, const AudioBuffer &test)
+{
+    int64_t count = std::min(reference.num_samples(), test.num_samples());
+    double signal = 0, noise = 0;
+    for (int c = 0; c < reference.num_channels(); ++c)
+    {
+        for (int64_t i = 0; i < count; ++i)
+        {
+            double d = static_cast<double>(test.channel(c)[i]) - reference.channel(c)[i];
+            signal += static_cast<double>(reference.channel(c)[i]) * reference.channel(c)[i];
+            noise += d * d;
+        }
+    }
+    return 10.0 * std::log10(signal / std::max(noise, 1e-30));
+}
+
+//=============================================================================
+// Test: The Default preset is swresample's own configuration
+//=============================================================================
+void test_default_unchanged()
+{
+    std::cout << "Running test_default_unchanged..." << std::endl;
+    AudioDecoder plain({TARGET_RATE});
+    plain.open(MP3_PATH);
+    auto reference = plain.decode_all();
+
+    assert(identical(decode_with({}), reference));
+
+    // Overrides equal to swresample's defaults change nothing either
+    ResamplerQuality explicit_defaults;
+    explicit_defaults.filter_size = 32;
+    explicit_defaults.phase_shift = 10;
+    explicit_defaults.linear_interp = true;
+    explicit_defaults.cutoff = 0.97;
+    assert(identical(decode_with(explicit_defaults), reference));
+}
+
+//=============================================================================
+// Test: Every preset on both engines resamples the whole stream
+//=============================================================================
+void test_presets()
+{
+    std::cout << "Running test_presets..." << std::endl;
+    const std::pair<const char *, ResamplerPreset> presets[] = {{"fastest", ResamplerPreset::Fastest},
+                                                                {"balanced", ResamplerPreset::Balanced},
+                                                                {"high", ResamplerPreset::High}};
+    for (Resampler engine : {Resampler::SwResample, Resampler::Polyphase})
+    {
+        auto reference = decode_with({}, engine);
+        for (const auto &[name, preset] : presets)
+        {
+            ResamplerQuality quality;
+            quality.preset = preset;
+            auto buffer = decode_with(quality, engine);
+            double snr = snr_db(reference, buffer);
+            std::cout << "  " << (engine == Resampler::Polyphase ? "polyphase " : "swr ") << name << ": "
+                      << buffer.num_samples() << " samples, " << snr << " dB vs default" << std::endl;
+            assert(std::llabs(buffer.num_samples() - reference.num_samples()) <= 64);
+            assert(!identical(buffer, reference));
+            // Music is mostly well below the cutoff: all presets stay close
+            assert(snr > 40.0);
+        }
+    }
+}
+
+//=============================================================================
+// Test: Overrides apply on top of the preset
+//=============================================================================
+void test_overrides()
+{
+    std::cout << "Running test_overrides..." << std::endl;
+    ResamplerQuality fastest;
+    fastest.preset = ResamplerPreset::Fastest;
+    auto fast = decode_with(fastest);
+
+    ResamplerQuality longer = fastest;
+    longer.filter_size = 32;
+    assert(!identical(decode_with(longer), fast));
+
+    ResamplerQuality narrower = fastest;
+    narrower.cutoff = 0.8;
+    assert(!identical(decode_with(narrower), fast));
+
+    // Overriding with the preset's own value changes nothing
+    ResamplerQuality same = fastest;
+    same.filter_size = 8;
+    assert(identical(decode_with(same), fast));
+}
+
+//=============================================================================
+// Test: Out-of-range values are rejected when the decoder is created
+//=============================================================================
+void test_invalid_values()
+{
+    std::cout << "Running test_invalid_values..." << std::endl;
+    ResamplerQuality bad[3];
+    bad[0].filter_size = 0;
+    bad[1].phase_shift = 40;
+    bad[2].cutoff = 1.5;
+    for (const auto &quality : bad)
+    {
+        AudioStreamOptions options;
+        options.resampler_quality = quality;
+        bool threw = false;
+        try
+        {
+            AudioDecoder decoder(options);
+        }
+        catch (const std::exception &)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+//=============================================================================
+// Test: soxr falls back to swresample's engine when FFmpeg lacks libsoxr
+//=============================================================================
+void test_soxr_request()
+{
+    std::cout << "Running test_soxr_request..." << std::endl;
+    ResamplerQuality soxr;
+    soxr.preset = ResamplerPreset::High;
+    soxr.soxr = true;
+    auto buffer = decode_with(soxr);
+
+    ResamplerQuality high;
+    high.preset = ResamplerPreset::High;
+    auto reference = decode_with(high);
+    std::cout << "  soxr: " << buffer.num_samples() << " samples, "
+              << (identical(buffer, reference) ? "swresample fallback" : "libsoxr") << std::endl;
+    assert(std::llabs(buffer.num_samples() - reference.num_samples()) <= 256);
+    assert(snr_db(reference, buffer) > 40.0);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Resampler Quality Tests ===" << std::endl;
+
+    test_default_unchanged();
+    test_presets();
+    test_overrides();
+    test_invalid_values();
+    test_soxr_request();
+
+    std::cout << "\nAll resampler quality tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Unit tests for AudioDecoder::seek / seek_to_sample
+// Tests cover: sample-accurate seeking on files, memory buffers and seekable
+// streams, with and without resampling. Decoding after a seek must match the
+// same range of a decode from the start.
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+std::vector<uint8_t> read_file_bytes(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    assert(file.is_open());
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char *>(buffer.data()), size);
+    return buffer;
+}
+
+AudioBuffer decode_reference(const std::string &path, const AudioStreamOptions &options)
+{
+    AudioDecoder decoder(options);
+    decoder.open(path);
+    return decoder.decode_all();
+}
+
+// Max absolute difference between `actual` and reference[offset:]
+// over the first `count` samples of every channel
+float max_abs_diff(const AudioBuffer &actual, const AudioBuffer &reference, int64_t offset, int64_t count)
+{
+    assert(actual.num_channels() == reference.num_channels());
+    assert(actual.num_samples() >= count);
+    assert(reference.num_samples() >= offset + count);
+
+    float max_diff = 0.0f;
+    for (int c = 0; c < actual.num_channels(); ++c)
+    {
+        const float *a = actual.channel(c);
+        const float *r = reference.channel(c) + offset;
+        for (int64_t i = 0; i < count; ++i)
+            max_diff = std::max(max_diff, std::fabs(a[i] - r[i]));
+    }
+    return max_diff;
+}
+
+void check_seek(AudioDecoder &decoder, const AudioBuffer &reference, int64_t target, float tolerance)
+{
+    decoder.seek_to_sample(target);
+    auto tail = decoder.decode_all();
+    int64_t expected_count = reference.num_samples() - target;
+    int64_t count = std::min(tail.num_samples(), expected_count);
+    float diff = max_abs_diff(tail, reference, target, count);
+    std::cout << "  seek_to_sample(" << target << "): remaining " << tail.num_samples()
+              << " (expected " << expected_count << "), max diff " << diff << std::endl;
+
+    assert(std::llabs(tail.num_samples() - expected_count) <= 32);
+    assert(diff <= tolerance);
+}
+
+//=============================================================================
+// Test: Exact seeking in PCM (no codec pre-roll, no rate change)
+//=============================================================================
+void test_seek_wav_exact()
+{
+    std::cout << "Running test_seek_wav_exact..." << std::endl;
+    auto reference = decode_reference(WAV_PATH, {});
+
+    AudioDecoder decoder;
+    decoder.open(WAV_PATH);
+    for (int64_t target : {0, 1, 12345, 40000, 80001})
+    {
+        decoder.seek_to_sample(target);
+        auto tail = decoder.decode_all();
+        assert(tail.num_samples() == reference.num_samples() - target);
+        assert(max_abs_diff(tail, reference, target, tail.num_samples()) == 0.0f);
+    }
+
+    // Seconds-based seek lands on the same sample
+    decoder.seek(2.5);
+    auto tail = decoder.decode_all();
+    assert(tail.num_samples() == reference.num_samples() - 40000);
+}
+
+//=============================================================================
+// Test: Seeking with resampling stays on the same output sample grid
+//=============================================================================
+void test_seek_wav_resampled()
+{
+    std::cout << "Running test_seek_wav_resampled..." << std::endl;
+    AudioStreamOptions options;
+    options.output_sample_rate = 44100;
+    auto reference = decode_reference(WAV_PATH, options);
+
+    AudioDecoder decoder(options);
+    decoder.open(WAV_PATH);
+    for (int64_t target : {0, 7, 44100, 100003})
+        check_seek(decoder, reference, target, 1e-4f);
+}
+
+//=============================================================================
+// Test: Seeking in MP3 (codec pre-roll)
+//=============================================================================
+void test_seek_mp3()
+{
+    std::cout << "Running test_seek_mp3..." << std::endl;
+    auto reference = decode_reference(MP3_PATH, {});
+
+    AudioDecoder decoder;
+    decoder.open(MP3_PATH);
+    for (int64_t target : {1000, 44100 * 30, 44100 * 45 + 517, 4000000})
+        check_seek(decoder, reference, target, 1e-3f);
+
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    auto resampled_reference = decode_reference(MP3_PATH, options);
+
+    AudioDecoder resampled_decoder(options);
+    resampled_decoder.open(MP3_PATH);
+    for (int64_t target : {16000 * 10 + 3, 16000 * 60})
+        check_seek(resampled_decoder, resampled_reference, target, 1e-3f);
+}
+
+//=============================================================================
+// Test: Seeking in memory buffers and seekable streams
+//=============================================================================
+void test_seek_memory_and_stream()
+{
+    std::cout << "Running test_seek_memory_and_stream..." << std::endl;
+    auto reference = decode_reference(WAV_PATH, {});
+    auto bytes = read_file_bytes(WAV_PATH);
+
+    AudioDecoder memory_decoder;
+    memory_decoder.open_memory(bytes.data(), bytes.size());
+    check_seek(memory_decoder, reference, 30000, 0.0f);
+
+    size_t pos = 0;
+    auto read_callback = [&](uint8_t *buf, int buf_size) -> int {
+        size_t count = std::min(static_cast<size_t>(buf_size), bytes.size() - pos);
+        std::memcpy(buf, bytes.data() + pos, count);
+        pos += count;
+        return static_cast<int>(count);
+    };
+    auto seek_callback = [&](int64_t offset, int whence) -> int64_t {
+        int64_t base = whence == SEEK_CUR ? static_cast<int64_t>(pos)
+                     : whence == SEEK_END ? static_cast<int64_t>(bytes.size()) : 0;
+        if (base + offset < 0 || base + offset > static_cast<int64_t>(bytes.size()))
+            return -1;
+        pos = static_cast<size_t>(base + offset);
+        return static_cast<int64_t>(pos);
+    };
+
+    AudioDecoder stream_decoder;
+    stream_decoder.open_stream(read_callback, seek_callback, {});
+    check_seek(stream_decoder, reference, 30000, 0.0f);
+
+    // Streams without a seek callback cannot seek
+    pos = 0;
+    AudioStreamOptions stream_options;
+    stream_options.input_format = "wav";
+    AudioDecoder forward_only_decoder;
+    forward_only_decoder.open_stream(read_callback, stream_options);
+    bool threw = false;
+    try
+    {
+        forward_only_decoder.seek(1.0);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Decoder Seek Tests ===" << std::endl;
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_seek_wav_exact();
+    test_seek_wav_resampled();
+    test_seek_mp3();
+    test_seek_memory_and_stream();
+
+    std::cout << "All seek tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+// Unit tests for opening with a known StreamDescription
+// Tests cover: capturing a description from an opened decoder, reopening
+// files, memory buffers and forward-only streams with it (same samples as
+// a probed open, fewer bytes read before the first sample), and invalid
+// descriptions
+
+#include "avioflow-cxx-api.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+std::vector<uint8_t> read_file_bytes(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    assert(file.is_open());
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char *>(buffer.data()), size);
+    return buffer;
+}
+
+void assert_identical(const AudioBuffer &actual, const AudioBuffer &expected)
+{
+    assert(actual.num_channels() == expected.num_channels());
+    assert(actual.num_samples() == expected.num_samples());
+    for (int c = 0; c < expected.num_channels(); ++c)
+    {
+        auto a = actual.channel_span(c);
+        auto e = expected.channel_span(c);
+        assert(std::equal(a.begin(), a.end(), e.begin()));
+    }
+}
+
+StreamDescription capture(const std::string &path)
+{
+    AudioDecoder decoder;
+    decoder.open(path);
+    return decoder.get_stream_description();
+}
+
+// Forward-only stream; counts bytes handed to the decoder until the first frame
+struct CountingStream
+{
+    const std::vector<uint8_t> &bytes;
+    size_t pos = 0;
+
+    int read(uint8_t *buf, int buf_size)
+    {
+        size_t count = std::min(static_cast<size_t>(buf_size), bytes.size() - pos);
+        std::memcpy(buf, bytes.data() + pos, count);
+        pos += count;
+        return static_cast<int>(count);
+    }
+};
+
+//=============================================================================
+// Test: Capture a description and reopen files / memory with it
+//=============================================================================
+void test_capture_and_reuse()
+{
+    std::cout << "Running test_capture_and_reuse..." << std::endl;
+    for (const auto &path : {MP3_PATH, WAV_PATH})
+    {
+        AudioDecoder probed;
+        probed.open(path);
+        auto description = probed.get_stream_description();
+        auto reference = probed.decode_all();
+        std::cout << "  " << description.container << "/" << description.codec << " "
+                  << description.sample_rate << " Hz, " << description.num_channels << " ch" << std::endl;
+
+        AudioStreamOptions options;
+        options.stream_description = description;
+        AudioDecoder decoder(options);
+        decoder.open(path);
+        assert(decoder.get_metadata().sample_rate == description.sample_rate);
+        assert(decoder.get_metadata().num_channels == description.num_channels);
+        assert_identical(decoder.decode_all(), reference);
+
+        auto bytes = read_file_bytes(path);
+        decoder.reopen_memory(bytes.data(), bytes.size());
+        assert_identical(decoder.decode_all(), reference);
+    }
+}
+
+//=============================================================================
+// Test: Forward-only stream starts with fewer bytes buffered
+//=============================================================================
+void test_stream_time_to_first_sample()
+{
+    std::cout << "Running test_stream_time_to_first_sample..." << std::endl;
+    auto bytes = read_file_bytes(WAV_PATH);
+
+    // Probed: format hint only, streams still analyzed
+    AudioStreamOptions probed_options;
+    probed_options.input_format = "wav";
+    CountingStream probed_stream{bytes};
+    auto start = std::chrono::steady_clock::now();
+    AudioDecoder probed;
+    probed.open_stream([&](uint8_t *buf, int size) { return probed_stream.read(buf, size); }, probed_options);
+    auto probed_first = probed.decode_next_view();
+    auto probed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    size_t probed_bytes = probed_stream.pos;
+    assert(!probed_first.empty());
+
+    // Described: no probing, no analysis
+    AudioStreamOptions described_options;
+    described_options.stream_description = capture(WAV_PATH);
+    CountingStream described_stream{bytes};
+    start = std::chrono::steady_clock::now();
+    AudioDecoder described;
+    described.open_stream([&](uint8_t *buf, int size) { return described_stream.read(buf, size); }, described_options);
+    auto described_first = described.decode_next_view();
+    auto described_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    size_t described_bytes = described_stream.pos;
+    assert(!described_first.empty());
+
+    std::cout << "  probed: " << probed_bytes << " bytes, " << probed_us << " us to first sample" << std::endl;
+    std::cout << "  described: " << described_bytes << " bytes, " << described_us << " us to first sample" << std::endl;
+    assert(described_bytes <= probed_bytes);
+    assert(described_first.num_samples == probed_first.num_samples);
+    assert(std::equal(described_first.channel(0).begin(), described_first.channel(0).end(),
+                      probed_first.channel(0).begin()));
+}
+
+//=============================================================================
+// Test: Invalid descriptions are rejected
+//=============================================================================
+void test_invalid_description()
+{
+    std::cout << "Running test_invalid_description..." << std::endl;
+    auto expect_throw = [](const StreamDescription &description) {
+        AudioStreamOptions options;
+        options.stream_description = description;
+        AudioDecoder decoder(options);
+        bool threw = false;
+        try
+        {
+            decoder.open(WAV_PATH);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "  rejected: " << e.what() << std::endl;
+            threw = true;
+        }
+        assert(threw);
+    };
+
+    auto description = capture(WAV_PATH);
+    auto bad_codec = description;
+    bad_codec.codec = "not-a-codec";
+    expect_throw(bad_codec);
+
+    auto bad_container = description;
+    bad_container.container = "not-a-container";
+    expect_throw(bad_container);
+
+    auto no_rate = description;
+    no_rate.sample_rate = 0;
+    expect_throw(no_rate);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Stream Description Tests ===" << std::endl;
+    avioflow_set_log_level("error");
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_capture_and_reuse();
+    test_stream_time_to_first_sample();
+    test_invalid_description();
+
+    std::cout << "All stream description tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+// Unit tests for the SIMD sample conversion fast paths
+// Tests cover: every built instruction set level of the conversion and
+// downmix kernels against swr_convert() (bit-exact) for integer and float
+// input in both layouts, mono/stereo/5.1/unspecified layouts, custom
+// channel matrices against swr_set_matrix(), offset (split) conversions,
+// and decoder output through the fast path
+
+#include "avioflow-cxx-api.h"
+#include "fast-converter.h"
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+constexpr int FRAMES = 1003; // Odd, so vector loops leave a tail
+constexpr int SAMPLE_RATE = 48000;
+
+const simd::Level LEVELS[] = {simd::Level::Scalar, simd::Level::SSE2, simd::Level::AVX2,
+                              simd::Level::AVX512};
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+// Random input in `format` for `channels`, with the integer extremes included
+std::vector<std::vector<uint8_t>> make_input(AVSampleFormat format, int channels, std::mt19937 &rng)
+{
+    int planes = av_sample_fmt_is_planar(format) ? channels : 1;
+    int elements = FRAMES * (planes == 1 ? channels : 1);
+    int bytes = av_get_bytes_per_sample(format);
+    AVSampleFormat packed = av_get_packed_sample_fmt(format);
+
+    std::vector<std::vector<uint8_t>> data(planes, std::vector<uint8_t>(elements * bytes));
+    for (auto &plane : data)
+    {
+        for (int i = 0; i < elements; ++i)
+        {
+            uint8_t *out = plane.data() + i * bytes;
+            if (packed == AV_SAMPLE_FMT_S16)
+            {
+                int16_t v = i < 2 ? (i == 0 ? INT16_MIN : INT16_MAX) : static_cast<int16_t>(rng());
+                std::memcpy(out, &v, sizeof(v));
+            }
+            else if (packed == AV_SAMPLE_FMT_S32)
+            {
+                int32_t v = i < 2 ? (i == 0 ? INT32_MIN : INT32_MAX) : static_cast<int32_t>(rng());
+                std::memcpy(out, &v, sizeof(v));
+            }
+            else
+            {
+                float v = std::uniform_real_distribution<float>(-1.5f, 1.5f)(rng);
+                std::memcpy(out, &v, sizeof(v));
+            }
+        }
+    }
+    return data;
+}
+
+// Output planes for `frames` float samples
+std::vector<std::vector<uint8_t>> make_output(AVSampleFormat format, int channels)
+{
+    int planes = av_sample_fmt_is_planar(format) ? channels : 1;
+    int elements = FRAMES * (planes == 1 ? channels : 1);
+    return std::vector<std::vector<uint8_t>>(planes, std::vector<uint8_t>(elements * sizeof(float), 0xcd));
+}
+
+std::vector<uint8_t *> pointers(std::vector<std::vector<uint8_t>> &planes)
+{
+    std::vector<uint8_t *> result;
+    for (auto &plane : planes)
+        result.push_back(plane.data());
+    return result;
+}
+
+std::vector<std::vector<uint8_t>> swr_reference(AVSampleFormat in_format, const AVChannelLayout &in_layout,
+                                                AVSampleFormat out_format, int out_channels,
+                                                std::vector<std::vector<uint8_t>> &input,
+                                                const std::vector<double> &matrix = {})
+{
+    AVChannelLayout out_layout;
+    av_channel_layout_default(&out_layout, out_channels);
+    SwrContext *swr = nullptr;
+    check_av_error(swr_alloc_set_opts2(&swr, &out_layout, out_format, SAMPLE_RATE, &in_layout,
+                                       in_format, SAMPLE_RATE, 0, nullptr),
+                   "Could not allocate resampler");
+    SwrContextPtr ctx(swr);
+    if (!matrix.empty())
+        check_av_error(swr_set_matrix(swr, matrix.data(), in_layout.nb_channels), "Could not set matrix");
+    check_av_error(swr_init(swr), "Could not initialize resampler");
+
+    auto output = make_output(out_format, out_channels);
+    auto in = pointers(input);
+    auto out = pointers(output);
+    int converted = swr_convert(swr, out.data(), FRAMES, const_cast<const uint8_t **>(in.data()), FRAMES);
+    assert(converted == FRAMES);
+    return output;
+}
+
+//=============================================================================
+// Test: Every kernel level matches swresample bit for bit
+//=============================================================================
+void test_kernels_match_swresample()
+{
+    std::cout << "Running test_kernels_match_swresample..." << std::endl;
+    std::mt19937 rng(1234);
+
+    AVChannelLayout unspec{};
+    unspec.order = AV_CHANNEL_ORDER_UNSPEC;
+    unspec.nb_channels = 2;
+    const AVChannelLayout layouts[] = {AV_CHANNEL_LAYOUT_MONO, AV_CHANNEL_LAYOUT_STEREO,
+                                       AV_CHANNEL_LAYOUT_5POINT1, AV_CHANNEL_LAYOUT_5POINT1_BACK,
+                                       unspec};
+    const AVSampleFormat in_formats[] = {AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32,
+                                         AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_FLTP};
+
+    int levels = 0;
+    for (simd::Level level : LEVELS)
+    {
+        const simd::Kernels *kernels = simd::kernels_for(level);
+        if (!kernels)
+            continue;
+        ++levels;
+
+        int covered = 0;
+        for (const AVChannelLayout &layout : layouts)
+        {
+            for (AVSampleFormat in_format : in_formats)
+            {
+                for (AVSampleFormat out_format : {AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_FLTP})
+                {
+                    for (int out_channels : {layout.nb_channels, 1})
+                    {
+                        FastConverter converter;
+                        if (!converter.init(in_format, layout, out_format, out_channels, *kernels))
+                            continue;
+                        ++covered;
+
+                        auto input = make_input(in_format, layout.nb_channels, rng);
+                        auto expected = swr_reference(in_format, layout, out_format, out_channels, input);
+
+                        // Converted in two parts to exercise the offsets
+                        auto output = make_output(out_format, out_channels);
+                        auto in = pointers(input);
+                        auto out = pointers(output);
+                        converter.convert(in.data(), 0, out.data(), 0, 517);
+                        converter.convert(in.data(), 517, out.data(), 517, FRAMES - 517);
+                        assert(output == expected);
+                    }
+                }
+            }
+        }
+        std::cout << "  " << simd::level_name(level) << ": " << covered << " conversions exact" << std::endl;
+        // Same-layout conversions of 3 integer and 1 float format per layout,
+        // and downmixes of every format
+        assert(covered >= 40);
+    }
+    assert(levels >= 1);
+    std::cout << "  dispatched: " << simd::level_name(simd::kernels().level) << std::endl;
+}
+
+//=============================================================================
+// Test: Custom channel matrices match swr_set_matrix() bit for bit
+//=============================================================================
+void test_matrix_match_swresample()
+{
+    std::cout << "Running test_matrix_match_swresample..." << std::endl;
+    std::mt19937 rng(5678);
+    AVChannelLayout layout = AV_CHANNEL_LAYOUT_7POINT1;
+    const int in_channels = layout.nb_channels;
+
+    // Channel selection (5, 2), a stereo mix of three channels each, and a
+    // single inverted channel
+    std::vector<double> select(2 * in_channels, 0.0);
+    select[0 * in_channels + 5] = 1.0;
+    select[1 * in_channels + 2] = 1.0;
+    std::vector<double> mix(2 * in_channels, 0.0);
+    mix[0] = 0.5, mix[2] = 0.25, mix[4] = 0.125;
+    mix[in_channels + 1] = 0.7, mix[in_channels + 3] = -0.3, mix[in_channels + 7] = 1.0;
+    std::vector<double> invert(in_channels, 0.0);
+    invert[6] = -1.0;
+    const std::pair<std::vector<double>, int> matrices[] = {{select, 2}, {mix, 2}, {invert, 1}};
+    const AVSampleFormat in_formats[] = {AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32,
+                                         AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_FLTP};
+
+    for (simd::Level level : LEVELS)
+    {
+        const simd::Kernels *kernels = simd::kernels_for(level);
+        if (!kernels)
+            continue;
+        int covered = 0;
+        for (const auto &[matrix, out_channels] : matrices)
+        {
+            for (AVSampleFormat in_format : in_formats)
+            {
+                FastConverter converter;
+                assert(converter.init(in_format, layout, AV_SAMPLE_FMT_FLTP, matrix, out_channels, *kernels));
+                ++covered;
+
+                auto input = make_input(in_format, in_channels, rng);
+                auto expected = swr_reference(in_format, layout, AV_SAMPLE_FMT_FLTP, out_channels, input, matrix);
+                auto output = make_output(AV_SAMPLE_FMT_FLTP, out_channels);
+                auto in = pointers(input);
+                auto out = pointers(output);
+                converter.convert(in.data(), 0, out.data(), 0, 517);
+                converter.convert(in.data(), 517, out.data(), 517, FRAMES - 517);
+                assert(output == expected);
+            }
+        }
+        std::cout << "  " << simd::level_name(level) << ": " << covered << " matrices exact" << std::endl;
+    }
+
+    // Interleaved output is only produced for one output channel
+    FastConverter converter;
+    assert(!converter.init(AV_SAMPLE_FMT_S16, layout, AV_SAMPLE_FMT_FLT, select, 2));
+    assert(converter.init(AV_SAMPLE_FMT_S16, layout, AV_SAMPLE_FMT_FLT, invert, 1));
+    assert(!converter.init(AV_SAMPLE_FMT_S16, layout, AV_SAMPLE_FMT_FLTP, invert, 2));
+}
+
+//=============================================================================
+// Test: Conversions swresample would rematrix or resample are declined
+//=============================================================================
+void test_unsupported_conversions()
+{
+    std::cout << "Running test_unsupported_conversions..." << std::endl;
+    FastConverter converter;
+    AVChannelLayout stereo = AV_CHANNEL_LAYOUT_STEREO;
+    AVChannelLayout side = AV_CHANNEL_LAYOUT_5POINT1; // The default 6-channel layout is 5.1(back)
+
+    assert(!converter.init(AV_SAMPLE_FMT_DBL, stereo, AV_SAMPLE_FMT_FLTP, 2));
+    assert(!converter.init(AV_SAMPLE_FMT_S16, stereo, AV_SAMPLE_FMT_S16P, 2));
+    assert(!converter.init(AV_SAMPLE_FMT_S16P, stereo, AV_SAMPLE_FMT_FLT, 2));
+    assert(!converter.init(AV_SAMPLE_FMT_FLTP, stereo, AV_SAMPLE_FMT_FLTP, 2));
+    assert(!converter.init(AV_SAMPLE_FMT_S16, stereo, AV_SAMPLE_FMT_FLTP, 6));
+    assert(!converter.init(AV_SAMPLE_FMT_S16, side, AV_SAMPLE_FMT_FLTP, 2));
+    assert(!converter.init(AV_SAMPLE_FMT_S16, side, AV_SAMPLE_FMT_FLTP, 6));
+}
+
+//=============================================================================
+// Test: Decoder output through the fast path
+//=============================================================================
+void test_decoder_output()
+{
+    std::cout << "Running test_decoder_output..." << std::endl;
+
+    // 16-bit PCM to float: x / 32768
+    AudioDecoder wav;
+    wav.open(WAV_PATH);
+    auto samples = wav.decode_all();
+    std::ifstream file(WAV_PATH, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), {});
+    assert(bytes.size() >= 44 + samples.num_samples() * sizeof(int16_t));
+    for (int64_t i = 0; i < samples.num_samples(); ++i)
+    {
+        int16_t pcm;
+        std::memcpy(&pcm, bytes.data() + 44 + i * sizeof(pcm), sizeof(pcm));
+        assert(samples.channel(0)[i] == pcm * (1.0f / 32768));
+    }
+
+    // Stereo MP3 to mono at the source rate, against swresample's downmix
+    AudioDecoder stereo;
+    stereo.open(MP3_PATH);
+    auto reference = stereo.decode_all();
+    std::vector<std::vector<uint8_t>> input(2);
+    for (int c = 0; c < 2; ++c)
+    {
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(reference.channel(c));
+        input[c].assign(data, data + FRAMES * sizeof(float));
+    }
+    AVChannelLayout layout = AV_CHANNEL_LAYOUT_STEREO;
+    auto expected = swr_reference(AV_SAMPLE_FMT_FLTP, layout, AV_SAMPLE_FMT_FLTP, 1, input);
+
+    AudioStreamOptions options;
+    options.output_num_channels = 1;
+    AudioDecoder mono(options);
+    mono.open(MP3_PATH);
+    auto mixed = mono.decode_all();
+    assert(mixed.num_channels() == 1);
+    assert(mixed.num_samples() == reference.num_samples());
+    assert(std::memcmp(mixed.channel(0), expected[0].data(), FRAMES * sizeof(float)) == 0);
+    for (int64_t i = 0; i < mixed.num_samples(); ++i)
+    {
+        float l = reference.channel(0)[i], r = reference.channel(1)[i];
+        assert(mixed.channel(0)[i] == l * static_cast<float>(M_SQRT1_2) + r * static_cast<float>(M_SQRT1_2));
+    }
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== avioflow Sample Conversion Tests ===" << std::endl;
+    avioflow_set_log_level("error");
+
+    std::ifstream check_file(MP3_PATH);
+    bool file_exists = check_file.good();
+    check_file.close();
+
+    if (!file_exists)
+    {
+        std::cerr << "\n[ERROR] Test file not found: " << MP3_PATH << std::endl;
+        return 1;
+    }
+
+    test_kernels_match_swresample();
+    test_matrix_match_swresample();
+    test_unsupported_conversions();
+    test_decoder_output();
+
+    std::cout << "All sample conversion tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,336 @@
+// Unit tests for push-mode streaming (StreamingDecoder) and its byte ring
+// Tests cover: the ring's wrap-around and rewind, bytes fed in small pieces
+// decoding to the same samples as the whole input (MP3 probed, WAV
+// resampled, raw PCM in 1-byte pieces and without stream analysis), a full
+// ring pushing back on feed, a producer thread feeding while the caller
+// polls, chunked output, and polling before any input
+
+#include "avioflow-cxx-api.h"
+#include "byte-ring.h"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace avioflow;
+
+// Test file paths
+const std::string MP3_PATH = "./public/TownTheme.mp3";
+const std::string WAV_PATH = "./public/zh.wav";
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+std::vector<uint8_t> read_file(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    assert(file.is_open());
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// The whole input through a pull callback, also without seeking (a
+// non-seekable MP3 keeps the encoder padding the LAME tag would trim)
+AudioBuffer decode_whole(const std::vector<uint8_t> &data, const AudioStreamOptions &options)
+{
+    size_t pos = 0;
+    AudioDecoder decoder;
+    decoder.open_stream(
+        [&](uint8_t *buf, int size) {
+            int count = static_cast<int>(std::min<size_t>(size, data.size() - pos));
+            std::memcpy(buf, data.data() + pos, count);
+            pos += count;
+            return count;
+        },
+        nullptr, options);
+    return decoder.decode_all();
+}
+
+// Collects polled frames into one buffer
+struct Collector
+{
+    AudioBuffer audio;
+    int64_t frames = 0;
+
+    void add(std::vector<AudioBuffer> &&polled)
+    {
+        for (auto &frame : polled)
+        {
+            if (audio.num_channels() == 0)
+                audio = AudioBuffer(frame.num_channels(), frame.num_samples(), frame.sample_rate(),
+                                    frame.format(), frame.layout());
+            std::vector<const uint8_t *> planes;
+            for (int p = 0; p < frame.num_planes(); ++p)
+                planes.push_back(frame.plane_data(p));
+            audio.append(planes.data(), frame.num_samples());
+            ++frames;
+        }
+    }
+};
+
+// Feed `data` in pieces of `piece` bytes, polling after every piece
+AudioBuffer stream_in_pieces(const std::vector<uint8_t> &data, size_t piece,
+                             const AudioStreamOptions &options)
+{
+    StreamingDecoder decoder(options);
+    Collector out;
+    for (size_t pos = 0; pos < data.size(); pos += piece)
+    {
+        size_t size = std::min(piece, data.size() - pos);
+        assert(decoder.feed(data.data() + pos, size) == size);
+        out.add(decoder.poll_frames());
+    }
+    decoder.end_of_input();
+    out.add(decoder.poll_frames());
+    assert(decoder.is_finished());
+    assert(decoder.poll_frames().empty());
+    return std::move(out.audio);
+}
+
+bool same_samples(const AudioBuffer &a, const AudioBuffer &b)
+{
+    if (a.num_samples() != b.num_samples() || a.num_channels() != b.num_channels())
+        return false;
+    for (int c = 0; c < a.num_channels(); ++c)
+    {
+        if (std::memcmp(a.channel(c), b.channel(c), a.num_samples() * sizeof(float)) != 0)
+            return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// Test: Byte ring wraps around and rewinds uncommitted reads
+//=============================================================================
+void test_byte_ring()
+{
+    std::cout << "Running test_byte_ring..." << std::endl;
+    ByteRing ring(10);
+    assert(ring.capacity() == 16);
+
+    uint8_t in[16], out[16];
+    for (int i = 0; i < 16; ++i)
+        in[i] = static_cast<uint8_t>(i + 1);
+    assert(ring.write(in, 12) == 12);
+    assert(ring.read(out, 8) == 8);
+    assert(ring.free_space() == 4); // Reads are not released before commit()
+    ring.rewind();
+    assert(ring.readable() == 12);
+
+    assert(ring.read(out, 8) == 8);
+    ring.commit();
+    assert(ring.write(in, 16) == 12); // Wraps; only what fits is taken
+    assert(ring.read(out, 16) == 16);
+    assert(std::memcmp(out, in + 8, 4) == 0 && std::memcmp(out + 4, in, 12) == 0);
+    assert(ring.read(out, 1) == 0);
+}
+
+//=============================================================================
+// Test: MP3 fed in websocket-sized pieces, format probed from the stream
+//=============================================================================
+void test_mp3_pieces()
+{
+    std::cout << "Running test_mp3_pieces..." << std::endl;
+    auto data = read_file(MP3_PATH);
+    auto whole = decode_whole(data, {});
+    for (size_t piece : {size_t(700), size_t(4096)})
+    {
+        auto streamed = stream_in_pieces(data, piece, {});
+        std::cout << "  " << piece << "-byte pieces: " << streamed.num_samples() << " samples (whole: "
+                  << whole.num_samples() << ")" << std::endl;
+        assert(same_samples(streamed, whole));
+    }
+}
+
+//=============================================================================
+// Test: WAV resampled while streaming
+//=============================================================================
+void test_wav_resampled()
+{
+    std::cout << "Running test_wav_resampled..." << std::endl;
+    auto data = read_file(WAV_PATH);
+    AudioStreamOptions options;
+    options.output_sample_rate = 16000;
+    assert(same_samples(stream_in_pieces(data, 1000, options), decode_whole(data, options)));
+}
+
+//=============================================================================
+// Test: Raw PCM with a known format, one byte at a time
+//=============================================================================
+void test_raw_pcm_bytes()
+{
+    std::cout << "Running test_raw_pcm_bytes..." << std::endl;
+    std::vector<uint8_t> pcm(48000 * 2);
+    for (size_t i = 0; i < pcm.size() / 2; ++i)
+    {
+        int16_t v = static_cast<int16_t>((i * 37) % 20000 - 10000);
+        std::memcpy(pcm.data() + i * 2, &v, 2);
+    }
+    AudioStreamOptions options;
+    options.input_format = "s16le";
+    options.input_sample_rate = 48000;
+    auto streamed = stream_in_pieces(pcm, 1, options);
+    assert(streamed.num_channels() == 1 && streamed.num_samples() == 48000);
+    for (int64_t i = 0; i < streamed.num_samples(); ++i)
+    {
+        int16_t v;
+        std::memcpy(&v, pcm.data() + i * 2, 2);
+        assert(streamed.channel(0)[i] == v / 32768.0f);
+    }
+
+    // A complete header needs no stream analysis: frames come long before
+    // the input ends
+    StreamingDecoder decoder(options);
+    decoder.feed(pcm.data(), 16000);
+    assert(!decoder.poll_frames().empty());
+    assert(decoder.is_open() && !decoder.is_finished());
+}
+
+//=============================================================================
+// Test: A full ring accepts only what fits until frames are polled
+//=============================================================================
+void test_backpressure()
+{
+    std::cout << "Running test_backpressure..." << std::endl;
+    auto data = read_file(MP3_PATH);
+    StreamingDecoder decoder({}, 64 << 10);
+    Collector out;
+    size_t pos = 0;
+    int partial = 0;
+    while (pos < data.size())
+    {
+        size_t piece = std::min<size_t>(100000, data.size() - pos);
+        size_t accepted = decoder.feed(data.data() + pos, piece);
+        partial += accepted < piece;
+        pos += accepted;
+        out.add(decoder.poll_frames());
+    }
+    decoder.end_of_input();
+    out.add(decoder.poll_frames());
+    std::cout << "  " << partial << " partial feeds" << std::endl;
+    assert(partial > 0);
+    assert(same_samples(out.audio, decode_whole(data, {})));
+}
+
+//=============================================================================
+// Test: A producer thread feeds while the caller polls
+//=============================================================================
+void test_producer_thread()
+{
+    std::cout << "Running test_producer_thread..." << std::endl;
+    auto data = read_file(MP3_PATH);
+    StreamingDecoder decoder({}, 32 << 10);
+    std::thread producer([&] {
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            pos += decoder.feed(data.data() + pos, std::min<size_t>(1500, data.size() - pos));
+            std::this_thread::yield();
+        }
+        decoder.end_of_input();
+    });
+
+    Collector out;
+    while (!decoder.is_finished())
+    {
+        out.add(decoder.poll_frames());
+        std::this_thread::yield();
+    }
+    producer.join();
+    assert(same_samples(out.audio, decode_whole(data, {})));
+}
+
+//=============================================================================
+// Test: Chunked output while streaming
+//=============================================================================
+void test_chunked()
+{
+    std::cout << "Running test_chunked..." << std::endl;
+    auto data = read_file(WAV_PATH);
+    AudioStreamOptions options;
+    options.chunk_samples = 512;
+    options.chunk_tail = ChunkTail::Short;
+    StreamingDecoder decoder(options);
+    Collector out;
+    int64_t short_chunks = 0;
+    for (size_t pos = 0; pos < data.size(); pos += 3000)
+    {
+        decoder.feed(data.data() + pos, std::min<size_t>(3000, data.size() - pos));
+        auto frames = decoder.poll_frames();
+        for (auto &frame : frames)
+            short_chunks += frame.num_samples() != 512;
+        out.add(std::move(frames));
+    }
+    decoder.end_of_input();
+    auto frames = decoder.poll_frames();
+    for (size_t i = 0; i < frames.size(); ++i)
+        assert(frames[i].num_samples() == 512 || i + 1 == frames.size());
+    out.add(std::move(frames));
+    assert(short_chunks == 0);
+    assert(same_samples(out.audio, decode_whole(data, {})));
+}
+
+//=============================================================================
+// Test: Polling returns at once when input is missing
+//=============================================================================
+void test_no_input()
+{
+    std::cout << "Running test_no_input..." << std::endl;
+    StreamingDecoder decoder;
+    assert(decoder.poll_frames().empty());
+    assert(!decoder.is_open() && !decoder.is_finished());
+
+    bool threw = false;
+    try
+    {
+        decoder.get_metadata();
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    auto data = read_file(MP3_PATH);
+    decoder.feed(data.data(), 100);
+    assert(decoder.poll_frames().empty());
+    assert(!decoder.is_open());
+
+    decoder.end_of_input();
+    threw = false;
+    try
+    {
+        decoder.feed(data.data(), 1);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+//=============================================================================
+// Main Test Runner
+//=============================================================================
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "\n=== Streaming Decoder Tests ===" << std::endl;
+
+    test_byte_ring();
+    test_mp3_pieces();
+    test_wav_resampled();
+    test_raw_pcm_bytes();
+    test_backpressure();
+    test_producer_thread();
+    test_chunked();
+    test_no_input();
+
+    std::cout << "\nAll streaming decoder tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#! /usr/bin/env python3
+# Benchmark: decode throughput vs Python threads
+# Decodes the same file to 16 kHz mono on 1, 2, 4, ... threads of a
+# ThreadPoolExecutor (like DataLoader workers in threading mode). The
+# decoder releases the GIL for all native work, so throughput should grow
+# almost linearly up to the number of cores.
+#
+# Usage: python3 benchmark_thread_scaling.py [audio_path] [max_threads]
+import os
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import avioflow
+
+CLIPS_PER_THREAD = 4
+
+
+def decode(path, options):
+    decoder = avioflow.AudioDecoder(options)
+    decoder.open(path)
+    return decoder.decode_all().shape[-1]
+
+
+def run(path, options, threads):
+    clips = CLIPS_PER_THREAD * threads
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=threads) as pool:
+        samples = sum(pool.map(lambda _: decode(path, options), range(clips)))
+    elapsed = time.perf_counter() - start
+    return clips / elapsed, samples
+
+
+def main():
+    if len(sys.argv) > 1:
+        audio_path = sys.argv[1]
+    else:
+        audio_path = os.path.join(os.path.dirname(__file__), "../../public/TownTheme.mp3")
+    max_threads = int(sys.argv[2]) if len(sys.argv) > 2 else os.cpu_count() or 1
+
+    if not os.path.exists(audio_path):
+        print(f"Error: Audio file not found at {audio_path}")
+        sys.exit(1)
+
+    avioflow.set_log_level("quiet")
+    options = avioflow.AudioStreamOptions()
+    options.output_sample_rate = 16000
+    options.output_num_channels = 1
+
+    print("\n=== avioflow Python Thread Scaling Benchmark ===")
+    print(f"File: {audio_path}, {CLIPS_PER_THREAD} decodes per thread, {os.cpu_count()} cores")
+    decode(audio_path, options)  # Warm up
+
+    baseline = None
+    threads = 1
+    while threads <= max_threads:
+        rate, _ = run(audio_path, options, threads)
+        baseline = baseline or rate
+        print(f"[{threads:2d} threads] {rate:7.2f} files/s  scaling {rate / baseline:5.2f}x "
+              f"(efficiency {rate / baseline / threads:4.0%})")
+        threads *= 2
+
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,9 @@
 #! /usr/bin/env python3
+import io
 import sys
 import os
+import numpy as np
+
 import avioflow
 
 print(f"Imported avioflow from: {avioflow.__file__}")
@@ -43,9 +46,95 @@ def main():
         samples = decoder.get_all_samples()
 
         print(f"Decoding Success!")
-        print(f"  Channels: {len(samples.data)}")
-        if len(samples.data) > 0:
-            print(f"  Samples per channel: {len(samples.data[0])}")
+        print(f"  Shape: {samples.shape} ({samples.dtype})")
+        assert samples.shape[0] == meta.num_channels
+
+        # 5. Frame by frame: arrays share the decoder's buffers
+        decoder.open(audio_path)
+        frame = decoder.decode_next()
+        while frame is not None and frame.shape[1] == 0:
+            frame = decoder.decode_next()
+        assert frame is not None and frame.shape[0] == meta.num_channels
+        print(f"  First frame: {frame.shape}")
+
+        # Resampled: frames the resampler held back have 0 samples; only
+        # None ends the stream
+        resampled = avioflow.AudioStreamOptions()
+        resampled.output_sample_rate = 16000
+        resampling = avioflow.AudioDecoder(resampled)
+        resampling.open(audio_path)
+        total = 0
+        frame = resampling.decode_next()
+        while frame is not None:
+            assert frame.shape[0] == meta.num_channels
+            total += frame.shape[1]
+            frame = resampling.decode_next()
+        resampling.open(audio_path)
+        assert total == resampling.decode_all().shape[1]
+        print(f"  Frame by frame at 16 kHz: {total} samples")
+
+        # 6. Batch: paths and buffers on native threads, per-item errors
+        with open(audio_path, "rb") as f:
+            data = f.read()
+        options = avioflow.AudioStreamOptions()
+        options.output_sample_rate = 16000
+        arrays, errors = avioflow.load_many([audio_path, data, "missing.mp3"], options, num_threads=2)
+        assert errors[0] is None and errors[1] is None and errors[2] is not None
+        assert arrays[2] is None and (arrays[0] == arrays[1]).all()
+        padded, lengths, _ = avioflow.load_many([audio_path, "missing.mp3"], options, pad=True)
+        assert padded.shape == (2, arrays[0].shape[0], arrays[0].shape[1])
+        assert list(lengths) == [arrays[0].shape[1], 0]
+        print(f"  Batch: {padded.shape}, lengths {list(lengths)}")
+
+        # 7. DLPack: export without a copy, decode into caller-owned memory
+        decoder.open(audio_path)
+        buffer = decoder.decode_all_buffer()
+        assert buffer.__dlpack_device__() == (1, 0)
+        assert (np.asarray(buffer) == samples).all()
+        out = np.zeros((meta.num_channels, 4096), dtype=np.float32)
+        decoder.open(audio_path)
+        assert decoder.decode_all_into(out) == 4096
+        assert (out == samples[:, :4096]).all()
+        try:
+            import torch
+            assert torch.from_dlpack(buffer).shape == buffer.shape
+            tensor = torch.zeros(meta.num_channels, 4096)
+            decoder.open(audio_path)
+            decoder.decode_all_into(tensor)
+            assert (tensor.numpy() == out).all()
+            print("  DLPack: torch round trip OK")
+        except ImportError:
+            print("  DLPack: torch not installed, skipped")
+
+        # 8. Read callback errors reach Python instead of unwinding through FFmpeg
+        stream_options = avioflow.AudioStreamOptions()
+        stream_options.input_format = "mp3"
+        source = io.BytesIO(data)
+
+        def failing_read(size):
+            if source.tell() > len(data) // 2:
+                raise ValueError("connection lost")
+            return memoryview(source.read(size))
+
+        decoder.open_stream(failing_read, stream_options)
+        try:
+            decoder.decode_all()
+            raise AssertionError("read error was not raised")
+        except ValueError as e:
+            print(f"  Read callback error raised: {e}")
+
+        # A callback returning more than `size` bytes is an error, not truncated
+        source = io.BytesIO(data)
+
+        def greedy_read(size):
+            return source.read(size + 100)
+
+        try:
+            decoder.open_stream(greedy_read, stream_options)  # The first read is in the probe
+            decoder.decode_all()
+            raise AssertionError("oversized read was not rejected")
+        except ValueError as e:
+            print(f"  Oversized read rejected: {e}")
 
         print("\nSUCCESS: Python audio loading is working correctly.")
 